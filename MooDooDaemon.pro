@@ -0,0 +1,54 @@
+# moodood: keeps the data in memory and serves moodoo commands over a Unix socket (see src/Daemon.h)
+#   qmake MooDooDaemon.pro && make && ./moodood &
+
+TEMPLATE = app
+TARGET = moodood
+
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+SOURCES += \
+    src/main_daemon.cpp \
+    src/Daemon.cpp \
+    src/DaemonClient.cpp \
+    src/Commands.cpp \
+    src/Storage.cpp \
+    src/WarmSnapshot.cpp \
+    src/Metrics.cpp \
+    src/Trace.cpp \
+    src/BlockCodec.cpp \
+    src/ThreadPool.cpp \
+    src/Keyword.cpp \
+    src/LocalTime.cpp \
+    src/RecordColumns.cpp \
+    src/MoodKernels.cpp \
+    src/MoodAnalyzer.cpp \
+    src/MessageTemplate.cpp \
+    src/MessageCatalog.cpp \
+    src/Tokenizer.cpp \
+    src/MoodTrendDetector.cpp \
+    src/CorrelationEngine.cpp \
+    src/TaskRanker.cpp \
+    src/CompletionModel.cpp \
+    src/SearchIndex.cpp \
+    src/Query.cpp \
+    src/QueryEngine.cpp
+
+HEADERS += \
+    src/Daemon.h \
+    src/DaemonClient.h \
+    src/Commands.h
+
+INCLUDEPATH += src/
+
+# Optional zstd for sealed journal segments (built-in LZ4 otherwise)
+CONFIG += link_pkgconfig
+packagesExist(libzstd) {
+    PKGCONFIG += libzstd
+    DEFINES += MOODOO_HAVE_ZSTD
+}
+
+# qmake CONFIG+=tracing records spans for $MOODOO_TRACE_FILE (see src/Trace.h)
+tracing {
+    DEFINES += MOODOO_ENABLE_TRACING
+}
@@ -8,22 +8,56 @@ SOURCES += \
     src/main_gui.cpp \
     src/MainWindow.cpp \
     src/Storage.cpp \
+    src/WarmSnapshot.cpp \
+    src/Metrics.cpp \
+    src/Trace.cpp \
+    src/BlockCodec.cpp \
+    src/ThreadPool.cpp \
+    src/Keyword.cpp \
+    src/LocalTime.cpp \
+    src/RecordColumns.cpp \
+    src/MoodKernels.cpp \
+    src/MoodTrendDetector.cpp \
+    src/CorrelationEngine.cpp \
+    src/TaskRanker.cpp \
+    src/CompletionModel.cpp \
+    src/Tokenizer.cpp \
+    src/SearchIndex.cpp \
+    src/Query.cpp \
+    src/QueryEngine.cpp \
+    src/DaemonClient.cpp \
     src/AddTaskDialog.cpp \
     src/MoodEntryDialog.cpp \
+    src/MetricsDialog.cpp \
     src/MoodHistoryPage.cpp \
-    src/TaskListPage.cpp
+    src/TaskListPage.cpp \
+    src/RecommendationPanel.cpp
 
 # Header files
 HEADERS += \
     src/MainWindow.h \
     src/AddTaskDialog.h \
     src/MoodEntryDialog.h \
+    src/MetricsDialog.h \
     src/MoodHistoryPage.h \
-    src/TaskListPage.h
+    src/TaskListPage.h \
+    src/RecommendationPanel.h
 
 # Include directories
 INCLUDEPATH += src/
 
+# Optional zstd for sealed journal segments (built-in LZ4 otherwise)
+CONFIG += link_pkgconfig
+packagesExist(libzstd) {
+    PKGCONFIG += libzstd
+    DEFINES += MOODOO_HAVE_ZSTD
+}
+
+# qmake CONFIG+=tracing records spans for $MOODOO_TRACE_FILE (see src/Trace.h)
+tracing {
+    DEFINES += MOODOO_ENABLE_TRACING
+}
+
 # C++ standard
 CONFIG += c++17
 
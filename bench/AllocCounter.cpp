@@ -0,0 +1,97 @@
+#include "AllocCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<int> scopes{0};
+std::atomic<size_t> allocationCount{0};
+
+void* allocate(size_t size) {
+    if (scopes.load(std::memory_order_relaxed) > 0) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    return std::malloc(size ? size : 1);
+}
+
+void* allocateAligned(size_t size, std::align_val_t alignment) {
+    if (scopes.load(std::memory_order_relaxed) > 0) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    size_t align = static_cast<size_t>(alignment);
+    // aligned_alloc wants a multiple of the alignment
+    return std::aligned_alloc(align, (size + align - 1) / align * align);
+}
+
+} // namespace
+
+AllocCounter::Scope::Scope() : start(allocationCount.load()) {
+    scopes.fetch_add(1);
+}
+
+AllocCounter::Scope::~Scope() {
+    scopes.fetch_sub(1);
+}
+
+size_t AllocCounter::Scope::allocations() const {
+    return allocationCount.load() - start;
+}
+
+size_t AllocCounter::total() {
+    return allocationCount.load();
+}
+
+// Every replaceable form, so no allocation reaches the library's own operators
+void* operator new(size_t size) {
+    void* memory = allocate(size);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new[](size_t size) {
+    void* memory = allocate(size);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    void* memory = allocateAligned(size, alignment);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    void* memory = allocateAligned(size, alignment);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { std::free(memory); }
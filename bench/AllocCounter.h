@@ -0,0 +1,26 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <cstddef>
+
+// Counts heap allocations made through operator new. AllocCounter.cpp
+// replaces the global operators for the whole benchmark binary; counting only
+// happens while a Scope is alive, so other benchmarks pay one relaxed load.
+class AllocCounter {
+public:
+    class Scope {
+    public:
+        Scope();
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        size_t allocations() const;     // Since the scope began
+    private:
+        size_t start;
+    };
+
+    static size_t total();
+};
+
+#endif // ALLOC_COUNTER_H
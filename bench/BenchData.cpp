@@ -0,0 +1,136 @@
+#include "BenchData.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include "MoodAnalyzer.h"
+
+namespace {
+
+const time_t kYear = 365 * 24 * 60 * 60;
+
+const char* const kTitles[] = {
+    "Write the quarterly report draft", "Call the dentist", "Review pull requests",
+    "Plan the team offsite", "Fix the flaky login test", "Renew car insurance",
+    "Prepare slides for Monday", "Clean up the garage"
+};
+
+const char* const kFragments[] = {
+    "Feeling tired", "Great day", "Anxious about the deadline", "Energized after a walk",
+    "Overwhelmed by meetings", "Calm and focused", "Frustrated with the build",
+    "Grateful for friends", "Stressed but hopeful", "Happy and productive"
+};
+
+const char* const kEndings[] = {
+    "but ready to go", "and a bit sad", "so I took a break", "and motivated to finish",
+    "after a long night", "with too much on my plate", "and excited for tomorrow",
+    "nothing else to report"
+};
+
+} // namespace
+
+std::vector<Task> BenchData::makeTasks(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<Task> tasks(count);
+    for (size_t i = 0; i < count; ++i) {
+        Task& task = tasks[i];
+        task.id = static_cast<int>(i + 1);
+        task.title = kTitles[rng() % 8];
+        task.description = "Synthetic task for benchmarking";
+        task.priority = static_cast<Priority>(1 + rng() % 3);
+        task.difficulty = static_cast<TaskDifficulty>(1 + rng() % 3);
+        task.created = kNow - kYear + static_cast<time_t>(kYear * (i + 1.0) / count);
+        task.completed = rng() % 3 == 0;
+        task.completed_time = task.completed ? task.created + static_cast<time_t>(rng() % 86400) : 0;
+    }
+    return tasks;
+}
+
+const std::vector<std::string>& BenchData::sentences() {
+    static const std::vector<std::string> all = [] {
+        std::vector<std::string> list;
+        for (const char* fragment : kFragments) {
+            for (const char* ending : kEndings) {
+                list.push_back(std::string(fragment) + " " + ending);
+            }
+        }
+        return list;
+    }();
+    return all;
+}
+
+std::vector<MoodEntry> BenchData::makeMoods(size_t count, unsigned seed) {
+    // Analyze each distinct sentence once and copy the results
+    const std::vector<std::string>& texts = sentences();
+    std::vector<MoodEntry> analyzed(texts.size());
+    MoodAnalyzer analyzer;
+    for (size_t s = 0; s < texts.size(); ++s) {
+        analyzed[s].content = texts[s];
+        analyzer.analyzeMoodEntry(analyzed[s]);
+    }
+
+    std::mt19937 rng(seed);
+    std::vector<MoodEntry> moods(count);
+    for (size_t i = 0; i < count; ++i) {
+        const MoodEntry& source = analyzed[rng() % analyzed.size()];
+        MoodEntry& entry = moods[i];
+        entry.id = static_cast<int>(i + 1);
+        entry.content = source.content;
+        entry.keywords = source.extractedKeywords;
+        entry.sentimentScore = source.sentimentScore;
+        entry.mood = static_cast<MoodLevel>(1 + rng() % 5);
+        entry.timestamp = kNow - kYear + static_cast<time_t>(kYear * (i + 1.0) / count);
+    }
+    return moods;
+}
+
+bool BenchData::writeTasks(const std::string& path, const std::vector<Task>& tasks) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not write " << path << std::endl;
+        return false;
+    }
+    for (const auto& task : tasks) {
+        file << task.id << '|' << task.title << '|' << task.description << '|'
+             << static_cast<int>(task.priority) << '|' << static_cast<int>(task.difficulty) << '|'
+             << (task.completed ? '1' : '0') << '|' << task.created << '|' << task.completed_time << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+bool BenchData::writeJournal(const std::string& path, const std::vector<MoodEntry>& moods) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not write " << path << std::endl;
+        return false;
+    }
+    for (const auto& entry : moods) {
+        file << entry.id << '|' << entry.content << '|' << static_cast<int>(entry.mood) << '|'
+             << entry.timestamp << '|';
+        for (size_t k = 0; k < entry.keywords.size(); ++k) {
+            if (k > 0) file << ',';
+            file << entry.keywords[k].str();
+        }
+        file << '|' << entry.sentimentScore << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+ScratchDir::ScratchDir() {
+    namespace fs = std::filesystem;
+    previous = fs::current_path().string();
+    std::random_device random;
+    fs::path dir;
+    do {
+        dir = fs::temp_directory_path() / ("moodoo_bench_" + std::to_string(random()));
+    } while (fs::exists(dir));
+    fs::create_directories(dir / "data");
+    path = dir.string();
+    fs::current_path(dir);
+}
+
+ScratchDir::~ScratchDir() {
+    std::error_code error;
+    std::filesystem::current_path(previous, error);
+    std::filesystem::remove_all(path, error);
+}
@@ -0,0 +1,46 @@
+#ifndef BENCH_DATA_H
+#define BENCH_DATA_H
+
+#include <ctime>
+#include <string>
+#include <vector>
+#include "Storage.h"
+
+// Synthetic tasks and journal entries shared by the benchmarks. Output
+// depends only on count and seed, so runs on different builds see the same
+// records.
+class BenchData {
+public:
+    // Fixed clock so generated timestamps don't drift between runs
+    static const time_t kNow = 1790000000;
+
+    // Created in id order over the last year; about a third completed
+    static std::vector<Task> makeTasks(size_t count, unsigned seed = 7);
+    // Realistic journal sentences with their keywords and sentiment filled in
+    static std::vector<MoodEntry> makeMoods(size_t count, unsigned seed = 42);
+    // The distinct sentences makeMoods draws from
+    static const std::vector<std::string>& sentences();
+
+    // Write records in Storage's line format without going through one
+    // Storage call per record
+    static bool writeTasks(const std::string& path, const std::vector<Task>& tasks);
+    static bool writeJournal(const std::string& path, const std::vector<MoodEntry>& moods);
+};
+
+// Temporary working directory for benchmarks that touch files. Storage keeps
+// its side files under ./data, so this switches into a fresh directory and
+// removes it again afterwards.
+class ScratchDir {
+private:
+    std::string previous;
+    std::string path;
+
+public:
+    ScratchDir();
+    ~ScratchDir();
+
+    ScratchDir(const ScratchDir&) = delete;
+    ScratchDir& operator=(const ScratchDir&) = delete;
+};
+
+#endif // BENCH_DATA_H
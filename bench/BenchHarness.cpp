@@ -0,0 +1,27 @@
+#include "BenchHarness.h"
+
+BenchState::BenchState(size_t problemSize, double minSeconds)
+    : problemSize(problemSize), iterations(0), itemsPerIteration(problemSize),
+      minSeconds(minSeconds), elapsed(0.0), started(false) {}
+
+bool BenchState::keepRunning() {
+    auto now = std::chrono::steady_clock::now();
+    if (!started) {
+        started = true;
+        start = now;
+        return true;
+    }
+
+    ++iterations;
+    elapsed = std::chrono::duration<double>(now - start).count();
+    return elapsed < minSeconds;
+}
+
+std::vector<BenchCase>& BenchRegistry::cases() {
+    static std::vector<BenchCase> registered;
+    return registered;
+}
+
+BenchRegistrar::BenchRegistrar(const char* name, BenchFunction function, std::vector<size_t> sizes) {
+    BenchRegistry::cases().push_back(BenchCase{name, function, sizes});
+}
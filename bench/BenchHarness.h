@@ -0,0 +1,63 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Minimal self-contained benchmark harness. A benchmark does its setup, then
+// loops on keepRunning(); only the loop is timed.
+class BenchState {
+private:
+    size_t problemSize;
+    size_t iterations;
+    size_t itemsPerIteration;
+    double minSeconds;
+    std::string note;
+    std::chrono::steady_clock::time_point start;
+    double elapsed;
+    bool started;
+
+public:
+    BenchState(size_t problemSize, double minSeconds);
+
+    size_t size() const { return problemSize; }
+    bool keepRunning();
+    void setItemsPerIteration(size_t items) { itemsPerIteration = items; }
+    // Extra result printed after the timings, e.g. a recall figure
+    void setNote(const std::string& text) { note = text; }
+
+    size_t getIterations() const { return iterations; }
+    size_t getItemsPerIteration() const { return itemsPerIteration; }
+    double getElapsedSeconds() const { return elapsed; }
+    const std::string& getNote() const { return note; }
+
+    // Keeps the optimizer from discarding a computed value
+    template <typename T>
+    static void doNotOptimize(const T& value) {
+        asm volatile("" : : "r"(&value) : "memory");
+    }
+};
+
+typedef void (*BenchFunction)(BenchState&);
+
+struct BenchCase {
+    std::string name;
+    BenchFunction function;
+    std::vector<size_t> sizes;
+};
+
+class BenchRegistry {
+public:
+    static std::vector<BenchCase>& cases();
+};
+
+struct BenchRegistrar {
+    BenchRegistrar(const char* name, BenchFunction function, std::vector<size_t> sizes);
+};
+
+#define MOODOO_BENCH(function, ...) \
+    static BenchRegistrar function##Registrar(#function, function, {__VA_ARGS__})
+
+#endif // BENCH_HARNESS_H
@@ -0,0 +1,57 @@
+# Benchmarks for the Storage and MoodAnalyzer hot paths (no Qt needed)
+#   qmake bench/MooDooBench.pro && make && ./moodoo_bench
+
+TEMPLATE = app
+TARGET = moodoo_bench
+
+CONFIG += console c++17 release
+CONFIG -= qt app_bundle
+
+INCLUDEPATH += ../src
+
+SOURCES += \
+    bench_main.cpp \
+    BenchHarness.cpp \
+    BenchData.cpp \
+    bench_storage.cpp \
+    bench_analyzer.cpp \
+    bench_analytics.cpp \
+    bench_kernels.cpp \
+    bench_concurrency.cpp \
+    bench_text.cpp \
+    bench_search.cpp \
+    bench_query.cpp \
+    bench_recycling.cpp \
+    AllocCounter.cpp \
+    ../src/Storage.cpp \
+    ../src/DaemonClient.cpp \
+    ../src/WarmSnapshot.cpp \
+    ../src/Metrics.cpp \
+    ../src/Trace.cpp \
+    ../src/BlockCodec.cpp \
+    ../src/ThreadPool.cpp \
+    ../src/Keyword.cpp \
+    ../src/LocalTime.cpp \
+    ../src/RecordColumns.cpp \
+    ../src/MoodKernels.cpp \
+    ../src/MoodTrendDetector.cpp \
+    ../src/TaskRanker.cpp \
+    ../src/CompletionModel.cpp \
+    ../src/MessageTemplate.cpp \
+    ../src/MessageCatalog.cpp \
+    ../src/Tokenizer.cpp \
+    ../src/SearchIndex.cpp \
+    ../src/Query.cpp \
+    ../src/QueryEngine.cpp \
+    ../src/MoodAnalyzer.cpp
+
+HEADERS += \
+    BenchHarness.h \
+    BenchData.h \
+    AllocCounter.h
+
+# qmake CONFIG+=tsan: ThreadSanitizer build for the concurrency benchmarks
+tsan {
+    QMAKE_CXXFLAGS += -fsanitize=thread -g -O1
+    QMAKE_LFLAGS += -fsanitize=thread
+}
@@ -0,0 +1,47 @@
+# Synthetic data sets and multi-threaded load replay against Storage (no Qt needed)
+#   qmake bench/MooDooLoad.pro && make
+#   ./moodoo_load generate --dir load --years 5 && ./moodoo_load replay --dir load --threads 8
+
+TEMPLATE = app
+TARGET = moodoo_load
+
+CONFIG += console c++17 release
+CONFIG -= qt app_bundle
+
+INCLUDEPATH += ../src
+
+SOURCES += \
+    load_main.cpp \
+    WorkloadGenerator.cpp \
+    ReplayDriver.cpp \
+    BenchData.cpp \
+    ../src/Storage.cpp \
+    ../src/DaemonClient.cpp \
+    ../src/WarmSnapshot.cpp \
+    ../src/Metrics.cpp \
+    ../src/Trace.cpp \
+    ../src/BlockCodec.cpp \
+    ../src/ThreadPool.cpp \
+    ../src/Keyword.cpp \
+    ../src/LocalTime.cpp \
+    ../src/RecordColumns.cpp \
+    ../src/MoodKernels.cpp \
+    ../src/MoodAnalyzer.cpp \
+    ../src/MoodTrendDetector.cpp \
+    ../src/TaskRanker.cpp \
+    ../src/CompletionModel.cpp \
+    ../src/MessageTemplate.cpp \
+    ../src/MessageCatalog.cpp \
+    ../src/Tokenizer.cpp \
+    ../src/SearchIndex.cpp
+
+HEADERS += \
+    WorkloadGenerator.h \
+    ReplayDriver.h \
+    BenchData.h
+
+# qmake CONFIG+=tsan: ThreadSanitizer build to check the replay's locking
+tsan {
+    QMAKE_CXXFLAGS += -fsanitize=thread -g -O1
+    QMAKE_LFLAGS += -fsanitize=thread
+}
@@ -0,0 +1,159 @@
+#include "ReplayDriver.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+double percentile(const std::vector<uint64_t>& sorted, double fraction) {
+    if (sorted.empty()) return 0.0;
+    // Nearest rank
+    size_t rank = static_cast<size_t>(fraction * sorted.size() + 0.999999);
+    rank = std::min(std::max<size_t>(rank, 1), sorted.size());
+    return sorted[rank - 1] / 1000.0;
+}
+
+} // namespace
+
+ReplayDriver::ReplayDriver(Storage& storage, const WorkloadGenerator& generator)
+    : storage(storage), generator(generator), nextMoodId(1) {
+    storage.addListener(&searchIndex);
+}
+
+ReplayDriver::~ReplayDriver() {
+    storage.removeListener(&searchIndex);
+}
+
+const char* ReplayDriver::operationName(Operation operation) {
+    switch (operation) {
+        case ADD_TASK: return "add-task";
+        case LOG_MOOD: return "log-mood";
+        case UPDATE: return "update";
+        case COMPLETE: return "complete";
+        case SEARCH: return "search";
+        case STATS: return "stats";
+        default: return "?";
+    }
+}
+
+bool ReplayDriver::prepare() {
+    std::vector<MoodEntry> moods;
+    if (!storage.loadTasks(tasks) || !storage.loadMoodEntries(moods)) {
+        return false;
+    }
+    // The replay addresses tasks by id, so they must be dense
+    std::sort(tasks.begin(), tasks.end(), [](const Task& a, const Task& b) { return a.id < b.id; });
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        if (tasks[i].id != static_cast<int>(i + 1)) {
+            std::cerr << "Error: Task ids must run 1..n for replay; regenerate the data" << std::endl;
+            return false;
+        }
+    }
+    nextMoodId = storage.getNextMoodId();
+    return true;
+}
+
+bool ReplayDriver::perform(Operation operation, std::mt19937& rng) {
+    switch (operation) {
+        case ADD_TASK: {
+            std::unique_lock<std::shared_mutex> guard(lock);
+            Task task = generator.makeTask(static_cast<int>(tasks.size() + 1), time(nullptr), rng);
+            if (!storage.saveTask(task)) return false;
+            tasks.push_back(task);
+            return true;
+        }
+        case LOG_MOOD: {
+            MoodEntry entry = generator.makeMood(0, static_cast<MoodLevel>(1 + rng() % 5), time(nullptr), rng);
+            analyzer.analyzeMoodEntry(entry);
+            entry.keywords = entry.extractedKeywords;
+            std::unique_lock<std::shared_mutex> guard(lock);
+            entry.id = nextMoodId++;
+            return storage.saveMoodEntry(entry);
+        }
+        case UPDATE:
+        case COMPLETE: {
+            std::unique_lock<std::shared_mutex> guard(lock);
+            if (tasks.empty()) return true;
+            Task task = tasks[rng() % tasks.size()];
+            if (operation == COMPLETE) {
+                task.completed = !task.completed;
+                task.completed_time = task.completed ? time(nullptr) : 0;
+            } else {
+                task.priority = static_cast<Priority>(1 + rng() % 3);
+                task.title = generator.makeSearch(rng);
+            }
+            if (!storage.updateTask(task)) return false;
+            tasks[task.id - 1] = task;
+            return true;
+        }
+        case SEARCH: {
+            std::string query = generator.makeSearch(rng);
+            std::shared_lock<std::shared_mutex> guard(lock);
+            std::vector<SearchIndex::Hit> hits = searchIndex.search(query, 20);
+            return true;
+        }
+        case STATS: {
+            std::shared_lock<std::shared_mutex> guard(lock);
+            std::string report = analyzer.analyzeWeeklyPatterns(storage.moodColumns(), storage.taskColumns());
+            return !report.empty();
+        }
+        default:
+            return false;
+    }
+}
+
+ReplayReport ReplayDriver::run(const ReplayOptions& options) {
+    const ReplayMix& mix = options.mix;
+    std::vector<int> weights = {mix.addTask, mix.logMood, mix.update, mix.complete, mix.search, mix.stats};
+    for (int& weight : weights) weight = std::max(weight, 0);
+
+    size_t threadCount = std::max<size_t>(options.threads, 1);
+    // Per thread and per operation, so workers never share a vector
+    std::vector<std::vector<std::vector<uint64_t>>> latencies(
+        threadCount, std::vector<std::vector<uint64_t>>(OPERATION_COUNT));
+    std::vector<size_t> failures(threadCount, 0);
+
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&, t]() {
+            std::mt19937 rng(options.seed * 7919u + static_cast<unsigned>(t));
+            std::discrete_distribution<int> pick(weights.begin(), weights.end());
+            size_t share = options.operations / threadCount + (t < options.operations % threadCount ? 1 : 0);
+            for (auto& samples : latencies[t]) samples.reserve(share);
+            for (size_t i = 0; i < share; ++i) {
+                Operation operation = static_cast<Operation>(pick(rng));
+                auto start = std::chrono::steady_clock::now();
+                bool ok = perform(operation, rng);
+                auto stop = std::chrono::steady_clock::now();
+                latencies[t][operation].push_back(
+                    static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()));
+                if (!ok) ++failures[t];
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    ReplayReport report;
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    for (size_t t = 0; t < threadCount; ++t) report.failures += failures[t];
+    for (int op = 0; op < OPERATION_COUNT; ++op) {
+        std::vector<uint64_t> merged;
+        for (size_t t = 0; t < threadCount; ++t) {
+            merged.insert(merged.end(), latencies[t][op].begin(), latencies[t][op].end());
+        }
+        if (merged.empty()) continue;
+        std::sort(merged.begin(), merged.end());
+        OperationStats stats;
+        stats.name = operationName(static_cast<Operation>(op));
+        stats.count = merged.size();
+        stats.p50 = percentile(merged, 0.50);
+        stats.p99 = percentile(merged, 0.99);
+        stats.p999 = percentile(merged, 0.999);
+        stats.max = merged.back() / 1000.0;
+        report.total += merged.size();
+        report.operations.push_back(stats);
+    }
+    return report;
+}
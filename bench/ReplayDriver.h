@@ -0,0 +1,77 @@
+#ifndef REPLAY_DRIVER_H
+#define REPLAY_DRIVER_H
+
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+#include "MoodAnalyzer.h"
+#include "SearchIndex.h"
+#include "Storage.h"
+#include "WorkloadGenerator.h"
+
+// Relative weights of the replayed operations
+struct ReplayMix {
+    int addTask = 10;
+    int logMood = 10;
+    int update = 10;
+    int complete = 10;
+    int search = 40;
+    int stats = 20;
+};
+
+struct ReplayOptions {
+    size_t threads = 4;
+    size_t operations = 20000;      // Across all threads
+    ReplayMix mix;
+    unsigned seed = 1;
+};
+
+// Latency of one operation kind, in microseconds
+struct OperationStats {
+    std::string name;
+    size_t count = 0;
+    double p50 = 0.0;
+    double p99 = 0.0;
+    double p999 = 0.0;
+    double max = 0.0;
+};
+
+struct ReplayReport {
+    std::vector<OperationStats> operations;
+    size_t total = 0;
+    double seconds = 0.0;
+    size_t failures = 0;
+};
+
+// Drives Storage the way the front ends do, from several threads at once.
+// Storage isn't thread-safe, so writes take an exclusive lock and reads
+// (search, stats) a shared one; the reported latency includes waiting for
+// it. A SearchIndex listener is kept current like in the GUI.
+class ReplayDriver {
+public:
+    enum Operation { ADD_TASK, LOG_MOOD, UPDATE, COMPLETE, SEARCH, STATS, OPERATION_COUNT };
+
+    ReplayDriver(Storage& storage, const WorkloadGenerator& generator);
+    ~ReplayDriver();
+
+    // Loads the existing data and builds the index; false on a read error
+    bool prepare();
+    ReplayReport run(const ReplayOptions& options);
+
+    static const char* operationName(Operation operation);
+
+private:
+    Storage& storage;
+    const WorkloadGenerator& generator;
+    const MoodAnalyzer analyzer;
+    SearchIndex searchIndex;
+    std::shared_mutex lock;
+    std::vector<Task> tasks;        // By id - 1; the replay never deletes
+    int nextMoodId;
+
+    // Returns false when the storage call failed
+    bool perform(Operation operation, std::mt19937& rng);
+};
+
+#endif // REPLAY_DRIVER_H
@@ -0,0 +1,154 @@
+#include "WorkloadGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include "MoodAnalyzer.h"
+
+namespace {
+
+const time_t kDay = 24 * 60 * 60;
+
+// Filler words shaped like English so tokenizing and fuzzy matching see
+// realistic lengths
+std::string syllableWord(std::mt19937& rng) {
+    static const char* const onsets[] = {"b", "c", "d", "f", "g", "h", "k", "l", "m", "n", "p", "r", "s", "t",
+                                         "v", "w", "br", "cl", "gr", "st", "tr", "sh"};
+    static const char* const vowels[] = {"a", "e", "i", "o", "u", "ee", "ou"};
+    std::string word;
+    size_t syllables = 1 + rng() % 3;
+    for (size_t s = 0; s < syllables; ++s) {
+        word += onsets[rng() % 22];
+        word += vowels[rng() % 7];
+    }
+    if (rng() % 3 == 0) word += "s";
+    return word;
+}
+
+} // namespace
+
+WorkloadGenerator::WorkloadGenerator(const WorkloadProfile& profile) : profile(profile) {
+    const MoodLexicon& lexicon = MoodLexicon::shared();
+    positiveWords = lexicon.positive;
+    positiveWords.insert(positiveWords.end(), lexicon.energy.begin(), lexicon.energy.end());
+    negativeWords = lexicon.negative;
+    negativeWords.insert(negativeWords.end(), lexicon.tired.begin(), lexicon.tired.end());
+    negativeWords.insert(negativeWords.end(), lexicon.overwhelmed.begin(), lexicon.overwhelmed.end());
+
+    // Common function words rank first, then filler
+    static const char* const common[] = {"the", "a", "to", "and", "of", "i", "it", "for", "with", "on",
+                                         "was", "today", "work", "but", "so", "my", "at", "about"};
+    std::mt19937 rng(profile.seed);
+    for (const char* word : common) {
+        if (words.size() < profile.vocabulary) words.push_back(word);
+    }
+    while (words.size() < std::max<size_t>(profile.vocabulary, 1)) {
+        words.push_back(syllableWord(rng));
+    }
+}
+
+const std::string& WorkloadGenerator::pickWord(std::mt19937& rng) const {
+    // Log-uniform rank: roughly Zipf with exponent 1
+    double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+    size_t rank = static_cast<size_t>(std::pow(static_cast<double>(words.size()), u)) - 1;
+    return words[std::min(rank, words.size() - 1)];
+}
+
+std::string WorkloadGenerator::makeText(MoodLevel mood, std::mt19937& rng) const {
+    int low = std::max(1, profile.minWords);
+    int high = std::max(low, profile.maxWords);
+    int count = std::uniform_int_distribution<int>(low, high)(rng);
+    int level = static_cast<int>(mood);
+    std::string text;
+    for (int i = 0; i < count; ++i) {
+        if (!text.empty()) text += ' ';
+        // About one word in eight carries the day's tone
+        if (rng() % 8 == 0 && level != 3) {
+            const auto& tone = level > 3 ? positiveWords : negativeWords;
+            if (!tone.empty()) {
+                text += tone[rng() % tone.size()];
+                continue;
+            }
+        }
+        text += pickWord(rng);
+    }
+    return text;
+}
+
+std::string WorkloadGenerator::makeSearch(std::mt19937& rng) const {
+    std::string query = pickWord(rng);
+    if (rng() % 2 == 0) query += " " + pickWord(rng);
+    return query;
+}
+
+Task WorkloadGenerator::makeTask(int id, time_t created, std::mt19937& rng) const {
+    Task task;
+    task.id = id;
+    // Titles are short whatever the entry length
+    task.title = pickWord(rng);
+    for (int i = 1 + static_cast<int>(rng() % 5); i > 0; --i) task.title += " " + pickWord(rng);
+    task.description = rng() % 3 == 0 ? makeText(MoodLevel::NEUTRAL, rng) : "";
+    unsigned roll = rng() % 10;
+    task.priority = roll < 3 ? Priority::LOW : (roll < 8 ? Priority::MEDIUM : Priority::HIGH);
+    task.difficulty = static_cast<TaskDifficulty>(1 + rng() % 3);
+    task.created = created;
+    task.completed = false;
+    task.completed_time = 0;
+    return task;
+}
+
+MoodEntry WorkloadGenerator::makeMood(int id, MoodLevel mood, time_t timestamp, std::mt19937& rng) const {
+    MoodEntry entry;
+    entry.id = id;
+    entry.mood = mood;
+    entry.timestamp = timestamp;
+    entry.content = makeText(mood, rng);
+    return entry;
+}
+
+void WorkloadGenerator::generate(time_t end, std::vector<Task>& tasks, std::vector<MoodEntry>& moods) const {
+    std::mt19937 rng(profile.seed);
+    std::poisson_distribution<int> entriesToday(std::max(profile.entriesPerDay, 0.0));
+    std::poisson_distribution<int> tasksToday(std::max(profile.tasksPerDay, 0.0));
+    std::exponential_distribution<double> daysToFinish(1.0 / 3.0);
+    std::normal_distribution<double> drift(0.0, 0.35);
+    std::bernoulli_distribution finishes(std::min(std::max(profile.completionRate, 0.0), 1.0));
+    MoodAnalyzer analyzer;
+
+    tasks.clear();
+    moods.clear();
+    time_t start = end - static_cast<time_t>(profile.years) * 365 * kDay;
+    double baseline = 3.2;
+    for (time_t day = start; day < end; day += kDay) {
+        // Mood wanders around a slightly positive baseline and dips at the start of the week
+        baseline = std::min(4.5, std::max(1.5, baseline + drift(rng) - 0.1 * (baseline - 3.2)));
+        bool monday = ((day / kDay) + 4) % 7 == 1;
+
+        for (int n = tasksToday(rng); n > 0; --n) {
+            time_t created = day + 8 * 3600 + static_cast<time_t>(rng() % (12 * 3600));
+            Task task = makeTask(static_cast<int>(tasks.size() + 1), created, rng);
+            if (finishes(rng)) {
+                time_t done = created + static_cast<time_t>(daysToFinish(rng) * kDay);
+                if (done < end) {
+                    task.completed = true;
+                    task.completed_time = done;
+                }
+            }
+            tasks.push_back(task);
+        }
+
+        for (int n = entriesToday(rng); n > 0; --n) {
+            double level = baseline + std::normal_distribution<double>(monday ? -0.4 : 0.0, 0.6)(rng);
+            MoodLevel mood = static_cast<MoodLevel>(std::min(5, std::max(1, static_cast<int>(std::lround(level)))));
+            time_t timestamp = day + 7 * 3600 + static_cast<time_t>(rng() % (16 * 3600));
+            MoodEntry entry = makeMood(static_cast<int>(moods.size() + 1), mood, timestamp, rng);
+            analyzer.analyzeMoodEntry(entry);
+            entry.keywords = entry.extractedKeywords;
+            moods.push_back(std::move(entry));
+        }
+    }
+    // Records within a day were drawn in random order; ids follow time like in the app
+    std::stable_sort(tasks.begin(), tasks.end(), [](const Task& a, const Task& b) { return a.created < b.created; });
+    for (size_t i = 0; i < tasks.size(); ++i) tasks[i].id = static_cast<int>(i + 1);
+    std::stable_sort(moods.begin(), moods.end(),
+                     [](const MoodEntry& a, const MoodEntry& b) { return a.timestamp < b.timestamp; });
+    for (size_t i = 0; i < moods.size(); ++i) moods[i].id = static_cast<int>(i + 1);
+}
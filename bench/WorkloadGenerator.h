@@ -0,0 +1,52 @@
+#ifndef WORKLOAD_GENERATOR_H
+#define WORKLOAD_GENERATOR_H
+
+#include <ctime>
+#include <random>
+#include <string>
+#include <vector>
+#include "Storage.h"
+
+// Knobs for a synthetic history; the defaults look like one fairly active user
+struct WorkloadProfile {
+    int years = 3;
+    double entriesPerDay = 1.5;     // Journal entries, Poisson distributed
+    double tasksPerDay = 4.0;       // New tasks, Poisson distributed
+    int minWords = 4;               // Text length of titles and entries, in words
+    int maxWords = 40;
+    size_t vocabulary = 5000;       // Distinct words, drawn with a Zipf-like skew
+    double completionRate = 0.7;    // Share of tasks eventually completed
+    unsigned seed = 1;
+};
+
+// Years of plausible tasks and journal entries. Mood drifts day to day and
+// sets the tone of that day's entries; tasks get completed hours to weeks
+// after creation. Ids are dense and unique, starting at 1.
+class WorkloadGenerator {
+private:
+    WorkloadProfile profile;
+    std::vector<std::string> words;         // Most frequent first
+    std::vector<std::string> positiveWords;
+    std::vector<std::string> negativeWords;
+
+    const std::string& pickWord(std::mt19937& rng) const;
+
+public:
+    explicit WorkloadGenerator(const WorkloadProfile& profile);
+
+    // History ending at end, in time order
+    void generate(time_t end, std::vector<Task>& tasks, std::vector<MoodEntry>& moods) const;
+
+    // Single records for replaying new activity; keywords and sentiment are
+    // left for the caller to fill, as the app does
+    Task makeTask(int id, time_t created, std::mt19937& rng) const;
+    MoodEntry makeMood(int id, MoodLevel mood, time_t timestamp, std::mt19937& rng) const;
+    // Random words for a text of the profile's length, tinted by mood
+    std::string makeText(MoodLevel mood, std::mt19937& rng) const;
+    // A one- or two-word search the way someone would type it
+    std::string makeSearch(std::mt19937& rng) const;
+
+    const WorkloadProfile& getProfile() const { return profile; }
+};
+
+#endif // WORKLOAD_GENERATOR_H
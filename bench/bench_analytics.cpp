@@ -0,0 +1,116 @@
+#include <ctime>
+#include "BenchData.h"
+#include "BenchHarness.h"
+#include "MoodAnalyzer.h"
+#include "Storage.h"
+
+// Array-of-structs vs. structure-of-arrays scans over the same synthetic data
+
+namespace {
+
+// BenchData's year of records, moved up to end now: the weekly report covers
+// the week before time(nullptr)
+void makeMoods(size_t count, std::vector<MoodEntry>& moods, MoodColumns& columns) {
+    moods = BenchData::makeMoods(count);
+    time_t shift = time(nullptr) - BenchData::kNow;
+    columns.clear();
+    for (auto& mood : moods) {
+        mood.timestamp += shift;
+        columns.append(mood);
+    }
+}
+
+void makeTasks(size_t count, std::vector<Task>& tasks, TaskColumns& columns) {
+    tasks = BenchData::makeTasks(count);
+    time_t shift = time(nullptr) - BenchData::kNow;
+    columns.clear();
+    for (auto& task : tasks) {
+        task.created += shift;
+        if (task.completed) task.completed_time += shift;
+        columns.append(task);
+    }
+}
+
+void moodSummaryAoS(BenchState& state) {
+    std::vector<MoodEntry> moods;
+    MoodColumns columns;
+    makeMoods(state.size(), moods, columns);
+
+    while (state.keepRunning()) {
+        int low = 0, high = 0;
+        for (const auto& entry : moods) {
+            if (entry.mood == MoodLevel::VERY_LOW || entry.mood == MoodLevel::LOW) {
+                low++;
+            } else if (entry.mood == MoodLevel::GOOD || entry.mood == MoodLevel::EXCELLENT) {
+                high++;
+            }
+        }
+        BenchState::doNotOptimize(low);
+        BenchState::doNotOptimize(high);
+    }
+}
+MOODOO_BENCH(moodSummaryAoS, 1000, 100000, 1000000);
+
+void moodSummarySoA(BenchState& state) {
+    std::vector<MoodEntry> moods;
+    MoodColumns columns;
+    makeMoods(state.size(), moods, columns);
+
+    while (state.keepRunning()) {
+        int low = 0, high = 0;
+        for (uint8_t level : columns.mood) {
+            low += level <= static_cast<uint8_t>(MoodLevel::LOW);
+            high += level >= static_cast<uint8_t>(MoodLevel::GOOD);
+        }
+        BenchState::doNotOptimize(low);
+        BenchState::doNotOptimize(high);
+    }
+}
+MOODOO_BENCH(moodSummarySoA, 1000, 100000, 1000000);
+
+void weeklyPatternsAoS(BenchState& state) {
+    std::vector<MoodEntry> moods;
+    std::vector<Task> tasks;
+    MoodColumns moodColumns;
+    TaskColumns taskColumns;
+    makeMoods(state.size(), moods, moodColumns);
+    makeTasks(state.size(), tasks, taskColumns);
+
+    // The pre-columnar implementation: copy recent records, then average them
+    while (state.keepRunning()) {
+        time_t weekAgo = time(nullptr) - (7 * 24 * 60 * 60);
+        std::vector<MoodEntry> recentMoods;
+        std::vector<Task> recentTasks;
+        for (const auto& mood : moods) {
+            if (mood.timestamp >= weekAgo) recentMoods.push_back(mood);
+        }
+        for (const auto& task : tasks) {
+            if (task.created >= weekAgo) recentTasks.push_back(task);
+        }
+        double totalMood = 0;
+        for (const auto& mood : recentMoods) totalMood += static_cast<int>(mood.mood);
+        int completed = 0;
+        for (const auto& task : recentTasks) completed += task.completed;
+        BenchState::doNotOptimize(totalMood);
+        BenchState::doNotOptimize(completed);
+    }
+}
+MOODOO_BENCH(weeklyPatternsAoS, 1000, 100000, 1000000);
+
+void weeklyPatternsSoA(BenchState& state) {
+    std::vector<MoodEntry> moods;
+    std::vector<Task> tasks;
+    MoodColumns moodColumns;
+    TaskColumns taskColumns;
+    makeMoods(state.size(), moods, moodColumns);
+    makeTasks(state.size(), tasks, taskColumns);
+    MoodAnalyzer analyzer;
+
+    while (state.keepRunning()) {
+        std::string report = analyzer.analyzeWeeklyPatterns(moodColumns, taskColumns);
+        BenchState::doNotOptimize(report);
+    }
+}
+MOODOO_BENCH(weeklyPatternsSoA, 1000, 100000, 1000000);
+
+} // namespace
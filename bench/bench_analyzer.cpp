@@ -0,0 +1,81 @@
+#include <string>
+#include <vector>
+#include "BenchData.h"
+#include "BenchHarness.h"
+#include "MoodAnalyzer.h"
+#include "TaskRanker.h"
+
+// MoodAnalyzer entry points over size records. The per-text calls cycle through
+// BenchData's sentences, so ns/item is the cost of one journal entry.
+
+namespace {
+
+void extractKeywords(BenchState& state) {
+    const MoodAnalyzer analyzer;
+    const std::vector<std::string>& texts = BenchData::sentences();
+
+    while (state.keepRunning()) {
+        size_t found = 0;
+        for (size_t i = 0; i < state.size(); ++i) {
+            found += analyzer.extractKeywords(texts[i % texts.size()]).size();
+        }
+        BenchState::doNotOptimize(found);
+    }
+}
+MOODOO_BENCH(extractKeywords, 1000, 100000, 1000000, 10000000);
+
+void calculateSentimentScore(BenchState& state) {
+    const MoodAnalyzer analyzer;
+    const std::vector<std::string>& texts = BenchData::sentences();
+
+    while (state.keepRunning()) {
+        double total = 0.0;
+        for (size_t i = 0; i < state.size(); ++i) {
+            total += analyzer.calculateSentimentScore(texts[i % texts.size()]);
+        }
+        BenchState::doNotOptimize(total);
+    }
+}
+MOODOO_BENCH(calculateSentimentScore, 1000, 100000, 1000000, 10000000);
+
+void analyzeWeeklyPatterns(BenchState& state) {
+    const MoodAnalyzer analyzer;
+    std::vector<MoodEntry> moods = BenchData::makeMoods(state.size());
+    std::vector<Task> tasks = BenchData::makeTasks(state.size());
+    // The report covers the week before now; move the synthetic year up to today
+    time_t shift = time(nullptr) - BenchData::kNow;
+    for (auto& entry : moods) entry.timestamp += shift;
+    for (auto& task : tasks) task.created += shift;
+
+    while (state.keepRunning()) {
+        std::string report = analyzer.analyzeWeeklyPatterns(moods, tasks);
+        BenchState::doNotOptimize(report);
+    }
+}
+MOODOO_BENCH(analyzeWeeklyPatterns, 1000, 100000, 1000000, 10000000);
+
+// A front end's steady state over size tasks: one task edit and one mood
+// change, each followed by the ranker's update, then a fresh render
+void generateMoodBasedTaskRecommendations(BenchState& state) {
+    const MoodAnalyzer analyzer;
+    std::vector<Task> tasks = BenchData::makeTasks(state.size());
+    TaskRanker ranker;
+    ranker.reset(tasks);
+    const size_t kRounds = 1000;
+    state.setItemsPerIteration(kRounds);
+
+    size_t next = 0;
+    while (state.keepRunning()) {
+        for (size_t round = 0; round < kRounds; ++round) {
+            Task& task = tasks[next++ % tasks.size()];
+            task.priority = static_cast<Priority>(static_cast<int>(task.priority) % 3 + 1);
+            ranker.upsert(task);
+            ranker.setMood(static_cast<MoodLevel>(round % 5 + 1));
+            std::string advice = analyzer.generateMoodBasedTaskRecommendations(ranker);
+            BenchState::doNotOptimize(advice);
+        }
+    }
+}
+MOODOO_BENCH(generateMoodBasedTaskRecommendations, 1000, 100000, 1000000, 10000000);
+
+} // namespace
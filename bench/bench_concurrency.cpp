@@ -0,0 +1,48 @@
+#include <string>
+#include <thread>
+#include <vector>
+#include "BenchData.h"
+#include "BenchHarness.h"
+#include "MoodAnalyzer.h"
+
+// One shared MoodAnalyzer driven from several threads. The size column is the
+// thread count; ns/item is per analyzed entry, so flat numbers mean linear
+// scaling. Build with `qmake CONFIG+=tsan` to run the same code under
+// ThreadSanitizer.
+
+namespace {
+
+const size_t kEntriesPerIteration = 4096;
+
+void analyzerShared(BenchState& state) {
+    const size_t threads = state.size();
+    const MoodAnalyzer analyzer;
+    const std::vector<MoodEntry> entries = BenchData::makeMoods(kEntriesPerIteration, 11);
+    state.setItemsPerIteration(kEntriesPerIteration);
+
+    while (state.keepRunning()) {
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                std::string buffer;
+                buffer.reserve(2048);
+                for (size_t i = t; i < entries.size(); i += threads) {
+                    MoodEntry entry = entries[i];
+                    analyzer.analyzeMoodEntry(entry);
+                    buffer.clear();
+                    analyzer.renderSupportiveMessage(entry, buffer);
+                    analyzer.renderDetailedInsights(entry, buffer);
+                    BenchState::doNotOptimize(buffer);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+}
+
+} // namespace
+
+MOODOO_BENCH(analyzerShared, 1, 2, 4, 8, 16);
@@ -0,0 +1,64 @@
+#include <random>
+#include <vector>
+#include "BenchHarness.h"
+#include "MoodKernels.h"
+
+// The same kernels pinned to each instruction set
+
+namespace {
+
+struct KernelData {
+    std::vector<int64_t> timestamps;
+    std::vector<uint8_t> levels;
+};
+
+KernelData makeData(size_t count) {
+    std::mt19937 rng(42);
+    int64_t now = time(nullptr);
+    KernelData data;
+    data.timestamps.resize(count);
+    data.levels.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        data.timestamps[i] = now - static_cast<int64_t>(rng() % (30 * 24 * 60 * 60));
+        data.levels[i] = static_cast<uint8_t>(1 + rng() % 5);
+    }
+    return data;
+}
+
+void histogramWith(BenchState& state, MoodKernels::Isa isa) {
+    KernelData data = makeData(state.size());
+    MoodKernels::forceIsa(isa);
+    while (state.keepRunning()) {
+        MoodKernels::Histogram result = MoodKernels::histogram(data.levels.data(), data.levels.size());
+        BenchState::doNotOptimize(result);
+    }
+    MoodKernels::forceIsa(MoodKernels::Isa::AVX2); // Back to the best available
+}
+
+void windowSumWith(BenchState& state, MoodKernels::Isa isa) {
+    KernelData data = makeData(state.size());
+    int64_t weekAgo = time(nullptr) - 7 * 24 * 60 * 60;
+    MoodKernels::forceIsa(isa);
+    while (state.keepRunning()) {
+        MoodKernels::WindowSum result = MoodKernels::windowSum(
+            data.timestamps.data(), data.levels.data(), data.levels.size(), weekAgo, INT64_MAX);
+        BenchState::doNotOptimize(result);
+    }
+    MoodKernels::forceIsa(MoodKernels::Isa::AVX2);
+}
+
+void histogramScalar(BenchState& state) { histogramWith(state, MoodKernels::Isa::SCALAR); }
+void histogramSse42(BenchState& state) { histogramWith(state, MoodKernels::Isa::SSE42); }
+void histogramAvx2(BenchState& state) { histogramWith(state, MoodKernels::Isa::AVX2); }
+void windowSumScalar(BenchState& state) { windowSumWith(state, MoodKernels::Isa::SCALAR); }
+void windowSumSse42(BenchState& state) { windowSumWith(state, MoodKernels::Isa::SSE42); }
+void windowSumAvx2(BenchState& state) { windowSumWith(state, MoodKernels::Isa::AVX2); }
+
+MOODOO_BENCH(histogramScalar, 1000, 100000, 1000000);
+MOODOO_BENCH(histogramSse42, 1000, 100000, 1000000);
+MOODOO_BENCH(histogramAvx2, 1000, 100000, 1000000);
+MOODOO_BENCH(windowSumScalar, 1000, 100000, 1000000);
+MOODOO_BENCH(windowSumSse42, 1000, 100000, 1000000);
+MOODOO_BENCH(windowSumAvx2, 1000, 100000, 1000000);
+
+} // namespace
@@ -0,0 +1,114 @@
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include "BenchHarness.h"
+
+namespace {
+
+std::string jsonString(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+            quoted += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            quoted += ' ';
+        } else {
+            quoted += c;
+        }
+    }
+    return quoted + "\"";
+}
+
+std::string compilerName() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_VER);
+#else
+    return "unknown";
+#endif
+}
+
+} // namespace
+
+// Usage: moodoo_bench [--filter <substring>] [--max-size <records>] [--min-time <seconds>] [--json]
+//
+// --json prints one document for regression tracking instead of the table:
+//   {"context": {...}, "benchmarks": [{"name", "size", "iterations", "ns_per_iter", "ns_per_item", "note"}]}
+int main(int argc, char* argv[]) {
+    std::string filter;
+    size_t maxSize = 1000000;
+    double minSeconds = 0.2;
+    bool json = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--max-size") == 0 && i + 1 < argc) {
+            maxSize = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            minSeconds = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else {
+            std::cerr << "Unknown argument: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    if (json) {
+        std::cout << "{\"context\":{\"date\":" << static_cast<long long>(time(nullptr))
+                  << ",\"compiler\":" << jsonString(compilerName())
+#ifdef NDEBUG
+                  << ",\"build\":\"release\""
+#else
+                  << ",\"build\":\"debug\""
+#endif
+                  << ",\"threads\":" << std::thread::hardware_concurrency()
+                  << ",\"min_time\":" << minSeconds << ",\"max_size\":" << maxSize << "},\n\"benchmarks\":[";
+    } else {
+        std::cout << std::left << std::setw(44) << "benchmark" << std::right
+                  << std::setw(12) << "size" << std::setw(14) << "ns/iter" << std::setw(14) << "ns/item" << std::endl;
+    }
+
+    bool first = true;
+    for (const auto& benchCase : BenchRegistry::cases()) {
+        if (!filter.empty() && benchCase.name.find(filter) == std::string::npos) continue;
+
+        for (size_t size : benchCase.sizes) {
+            if (size > maxSize) continue;
+
+            BenchState state(size, minSeconds);
+            benchCase.function(state);
+            if (state.getIterations() == 0) continue;
+
+            double nsPerIteration = state.getElapsedSeconds() * 1e9 / state.getIterations();
+            double nsPerItem = state.getItemsPerIteration() ? nsPerIteration / state.getItemsPerIteration() : 0.0;
+            if (json) {
+                std::ostringstream row;
+                row << std::fixed << std::setprecision(1) << (first ? "\n" : ",\n")
+                    << "{\"name\":" << jsonString(benchCase.name) << ",\"size\":" << size
+                    << ",\"iterations\":" << state.getIterations()
+                    << ",\"ns_per_iter\":" << nsPerIteration << ",\"ns_per_item\":" << nsPerItem
+                    << ",\"note\":" << jsonString(state.getNote()) << "}";
+                std::cout << row.str() << std::flush;
+                first = false;
+                continue;
+            }
+            std::cout << std::left << std::setw(44) << benchCase.name << std::right
+                      << std::setw(12) << size << std::fixed << std::setprecision(1)
+                      << std::setw(14) << nsPerIteration << std::setw(14) << nsPerItem;
+            if (!state.getNote().empty()) std::cout << "  " << state.getNote();
+            std::cout << std::endl;
+        }
+    }
+    if (json) std::cout << "\n]}" << std::endl;
+    return 0;
+}
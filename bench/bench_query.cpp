@@ -0,0 +1,58 @@
+#include <string>
+#include <vector>
+#include "BenchData.h"
+#include "BenchHarness.h"
+#include "Query.h"
+#include "QueryEngine.h"
+
+// A composite task query (priority, difficulty, open, created in the last
+// month) through the indexes, against the hand-written loop it replaces.
+
+namespace {
+
+const char* const kQuery = "priority:high difficulty:easy is:open created:>=30d";
+
+void compositeQuery(BenchState& state) {
+    std::vector<Task> tasks = BenchData::makeTasks(state.size(), 11);
+    QueryEngine engine;
+    engine.tasksLoaded(tasks);
+    Query query;
+    std::string error;
+    Query::parse(kQuery, Query::Target::TASKS, query, error, BenchData::kNow);
+
+    std::vector<int> ids;
+    while (state.keepRunning()) {
+        engine.execute(query, ids);
+        BenchState::doNotOptimize(ids);
+    }
+    state.setNote("matches=" + std::to_string(ids.size()));
+}
+
+void compositeScan(BenchState& state) {
+    std::vector<Task> tasks = BenchData::makeTasks(state.size(), 11);
+    Query query;
+    std::string error;
+    Query::parse(kQuery, Query::Target::TASKS, query, error, BenchData::kNow);
+    time_t since = 0;
+    for (const auto& condition : query.conditions) {
+        if (condition.field == Query::CREATED) since = condition.low;
+    }
+
+    std::vector<int> ids;
+    while (state.keepRunning()) {
+        ids.clear();
+        for (const auto& task : tasks) {
+            if (task.priority == Priority::HIGH && task.difficulty == TaskDifficulty::EASY && !task.completed &&
+                task.created >= since) {
+                ids.push_back(task.id);
+            }
+        }
+        BenchState::doNotOptimize(ids);
+    }
+    state.setNote("matches=" + std::to_string(ids.size()));
+}
+
+} // namespace
+
+MOODOO_BENCH(compositeQuery, 10000, 100000, 1000000);
+MOODOO_BENCH(compositeScan, 10000, 100000, 1000000);
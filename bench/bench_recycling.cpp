@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "AllocCounter.h"
+#include "BenchData.h"
+#include "BenchHarness.h"
+#include "RecordView.h"
+#include "Storage.h"
+
+// Reloads into a vector that already holds the previous load's records, which
+// Storage refills in place, against reloading into a new vector each time.
+// The note gives heap allocations per iteration.
+
+namespace {
+
+const char* const kTasksFile = "data/tasks.txt";
+const char* const kJournalFile = "data/journal.txt";
+
+void noteAllocations(BenchState& state, const AllocCounter::Scope& scope) {
+    size_t iterations = std::max<size_t>(state.getIterations(), 1);
+    state.setNote(std::to_string(scope.allocations() / iterations) + " allocations/iter");
+}
+
+void reloadTasks(BenchState& state) {
+    ScratchDir scratch;
+    if (!BenchData::writeTasks(kTasksFile, BenchData::makeTasks(state.size()))) return;
+    Storage storage(kTasksFile, kJournalFile);
+
+    std::vector<Task> tasks;
+    storage.loadTasks(tasks);
+    AllocCounter::Scope scope;
+    while (state.keepRunning()) {
+        storage.loadTasks(tasks);
+        BenchState::doNotOptimize(tasks);
+    }
+    noteAllocations(state, scope);
+}
+MOODOO_BENCH(reloadTasks, 1000, 100000, 1000000);
+
+void loadTasksFresh(BenchState& state) {
+    ScratchDir scratch;
+    if (!BenchData::writeTasks(kTasksFile, BenchData::makeTasks(state.size()))) return;
+    Storage storage(kTasksFile, kJournalFile);
+
+    AllocCounter::Scope scope;
+    while (state.keepRunning()) {
+        std::vector<Task> tasks;
+        storage.loadTasks(tasks);
+        BenchState::doNotOptimize(tasks);
+    }
+    noteAllocations(state, scope);
+}
+MOODOO_BENCH(loadTasksFresh, 1000, 100000, 1000000);
+
+void reloadMoods(BenchState& state) {
+    ScratchDir scratch;
+    if (!BenchData::writeJournal(kJournalFile, BenchData::makeMoods(state.size()))) return;
+    Storage storage(kTasksFile, kJournalFile);
+
+    std::vector<MoodEntry> moods;
+    storage.loadMoodEntries(moods);
+    AllocCounter::Scope scope;
+    while (state.keepRunning()) {
+        storage.loadMoodEntries(moods);
+        BenchState::doNotOptimize(moods);
+    }
+    noteAllocations(state, scope);
+}
+MOODOO_BENCH(reloadMoods, 1000, 100000, 1000000);
+
+void loadMoodsFresh(BenchState& state) {
+    ScratchDir scratch;
+    if (!BenchData::writeJournal(kJournalFile, BenchData::makeMoods(state.size()))) return;
+    Storage storage(kTasksFile, kJournalFile);
+
+    AllocCounter::Scope scope;
+    while (state.keepRunning()) {
+        std::vector<MoodEntry> moods;
+        storage.loadMoodEntries(moods);
+        BenchState::doNotOptimize(moods);
+    }
+    noteAllocations(state, scope);
+}
+MOODOO_BENCH(loadMoodsFresh, 1000, 100000, 1000000);
+
+// The last week of a year of entries, as `weekly` selects it
+const time_t kWeekAgo = BenchData::kNow - 7 * 24 * 60 * 60;
+
+void filterView(BenchState& state) {
+    std::vector<MoodEntry> moods = BenchData::makeMoods(state.size());
+    state.setItemsPerIteration(moods.size());
+
+    RecordView<MoodEntry> week;
+    AllocCounter::Scope scope;
+    while (state.keepRunning()) {
+        week.select(moods, [](const MoodEntry& entry) { return entry.timestamp >= kWeekAgo; });
+        BenchState::doNotOptimize(week);
+    }
+    noteAllocations(state, scope);
+}
+MOODOO_BENCH(filterView, 1000, 100000, 1000000);
+
+void filterCopy(BenchState& state) {
+    std::vector<MoodEntry> moods = BenchData::makeMoods(state.size());
+    state.setItemsPerIteration(moods.size());
+
+    AllocCounter::Scope scope;
+    while (state.keepRunning()) {
+        std::vector<MoodEntry> week;
+        std::copy_if(moods.begin(), moods.end(), std::back_inserter(week),
+                     [](const MoodEntry& entry) { return entry.timestamp >= kWeekAgo; });
+        BenchState::doNotOptimize(week);
+    }
+    noteAllocations(state, scope);
+}
+MOODOO_BENCH(filterCopy, 1000, 100000, 1000000);
+
+} // namespace
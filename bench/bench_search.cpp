@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "BenchHarness.h"
+#include "SearchIndex.h"
+
+// Fuzzy search over size synthetic tasks. Each query is two words of a random
+// task with one typo in the second; recall@20 is how often that task comes
+// back in the first 20 hits.
+
+namespace {
+
+const size_t kVocabulary = 30000;
+const size_t kQueries = 500;
+const size_t kLimit = 20;
+
+std::vector<std::string> makeVocabulary(std::mt19937& rng) {
+    static const char* const onsets[] = {"b", "c", "d", "f", "g", "h", "k", "l", "m", "n", "p", "r", "s", "t",
+                                         "v", "w", "br", "cl", "gr", "st", "tr", "sh"};
+    static const char* const vowels[] = {"a", "e", "i", "o", "u", "ee", "ou"};
+    std::vector<std::string> words;
+    words.reserve(kVocabulary);
+    while (words.size() < kVocabulary) {
+        std::string word;
+        size_t syllables = 2 + rng() % 3;
+        for (size_t s = 0; s < syllables; ++s) {
+            word += onsets[rng() % 22];
+            word += vowels[rng() % 7];
+        }
+        if (rng() % 3 == 0) word += "s";
+        words.push_back(word);
+    }
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+    return words;
+}
+
+std::string typo(std::string word, std::mt19937& rng) {
+    size_t at = 1 + rng() % (word.size() - 2);
+    switch (rng() % 4) {
+        case 0: std::swap(word[at], word[at + 1]); break;            // Transposition
+        case 1: word[at] = static_cast<char>('a' + rng() % 26); break;
+        case 2: word.erase(at, 1); break;
+        default: word.insert(at, 1, static_cast<char>('a' + rng() % 26)); break;
+    }
+    return word;
+}
+
+void fuzzySearch(BenchState& state) {
+    std::mt19937 rng(3);
+    std::vector<std::string> vocabulary = makeVocabulary(rng);
+    // Skewed word choice, like real text: a few words are everywhere
+    std::discrete_distribution<size_t> pick = [&]() {
+        std::vector<double> weights(vocabulary.size());
+        for (size_t i = 0; i < weights.size(); ++i) weights[i] = 1.0 / (1.0 + i % 5000);
+        return std::discrete_distribution<size_t>(weights.begin(), weights.end());
+    }();
+
+    SearchIndex index;
+    std::vector<std::vector<size_t>> taskWords(state.size());
+    for (size_t i = 0; i < state.size(); ++i) {
+        Task task;
+        task.id = static_cast<int>(i + 1);
+        size_t words = 3 + rng() % 8;
+        for (size_t w = 0; w < words; ++w) {
+            size_t word = pick(rng);
+            taskWords[i].push_back(word);
+            (w < 3 ? task.title : task.description) += vocabulary[word] + " ";
+        }
+        index.upsertTask(task);
+    }
+
+    struct Query {
+        std::string text;
+        int target;
+    };
+    std::vector<Query> queries;
+    while (queries.size() < kQueries) {
+        size_t task = rng() % state.size();
+        const std::vector<size_t>& words = taskWords[task];
+        const std::string& first = vocabulary[words[rng() % words.size()]];
+        const std::string& second = vocabulary[words[rng() % words.size()]];
+        if (first == second || second.size() < 5) continue;
+        queries.push_back(Query{first + " " + typo(second, rng), static_cast<int>(task + 1)});
+    }
+
+    // One pass for recall and the latency distribution, then the timed loop.
+    // recall counts the task anywhere in the results (did the typo match at
+    // all); recall@20 also needs it ranked ahead of other tasks using the words.
+    size_t found = 0;
+    size_t foundTop = 0;
+    std::vector<double> latencies;
+    for (const Query& query : queries) {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<SearchIndex::Hit> hits = index.search(query.text, kLimit, SearchIndex::TASK);
+        latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        for (const auto& hit : hits) {
+            if (hit.id == query.target) {
+                ++foundTop;
+                break;
+            }
+        }
+        for (const auto& hit : index.search(query.text, SIZE_MAX, SearchIndex::TASK)) {
+            if (hit.id == query.target) {
+                ++found;
+                break;
+            }
+        }
+    }
+    std::sort(latencies.begin(), latencies.end());
+    char note[160];
+    std::snprintf(note, sizeof(note), "recall=%.3f recall@%zu=%.3f p50=%.0fus p99=%.0fus terms=%zu",
+                  static_cast<double>(found) / queries.size(), kLimit,
+                  static_cast<double>(foundTop) / queries.size(), latencies[latencies.size() / 2],
+                  latencies[latencies.size() * 99 / 100], index.termCount());
+    state.setNote(note);
+
+    state.setItemsPerIteration(1);
+    size_t next = 0;
+    while (state.keepRunning()) {
+        std::vector<SearchIndex::Hit> hits = index.search(queries[next].text, kLimit, SearchIndex::TASK);
+        BenchState::doNotOptimize(hits);
+        next = (next + 1) % queries.size();
+    }
+}
+
+// Incremental upkeep: edits replace a document and occasionally trigger compaction
+void searchIndexUpsert(BenchState& state) {
+    std::mt19937 rng(4);
+    std::vector<std::string> vocabulary = makeVocabulary(rng);
+    SearchIndex index;
+    Task task;
+    for (size_t i = 0; i < state.size(); ++i) {
+        task.id = static_cast<int>(i + 1);
+        task.title = vocabulary[rng() % vocabulary.size()] + " " + vocabulary[rng() % vocabulary.size()];
+        index.upsertTask(task);
+    }
+    state.setItemsPerIteration(1);
+    while (state.keepRunning()) {
+        task.id = static_cast<int>(1 + rng() % state.size());
+        task.title = vocabulary[rng() % vocabulary.size()] + " " + vocabulary[rng() % vocabulary.size()];
+        index.upsertTask(task);
+    }
+}
+
+} // namespace
+
+MOODOO_BENCH(fuzzySearch, 10000, 100000, 1000000);
+MOODOO_BENCH(searchIndexUpsert, 10000, 100000, 1000000);
@@ -0,0 +1,91 @@
+#include <string>
+#include <vector>
+#include "BenchData.h"
+#include "BenchHarness.h"
+#include "Storage.h"
+
+// Storage round trips on files of size records, in a scratch directory.
+// Updates and deletes rewrite the whole file, so their ns/iter grows with size.
+
+namespace {
+
+const char* const kTasksFile = "data/tasks.txt";
+const char* const kJournalFile = "data/journal.txt";
+
+void loadTasks(BenchState& state) {
+    ScratchDir scratch;
+    if (!BenchData::writeTasks(kTasksFile, BenchData::makeTasks(state.size()))) return;
+    Storage storage(kTasksFile, kJournalFile);
+
+    std::vector<Task> tasks;
+    while (state.keepRunning()) {
+        storage.loadTasks(tasks);
+        BenchState::doNotOptimize(tasks);
+    }
+}
+MOODOO_BENCH(loadTasks, 1000, 100000, 1000000, 10000000);
+
+void loadMoodEntries(BenchState& state) {
+    ScratchDir scratch;
+    if (!BenchData::writeJournal(kJournalFile, BenchData::makeMoods(state.size()))) return;
+    Storage storage(kTasksFile, kJournalFile);
+
+    std::vector<MoodEntry> moods;
+    while (state.keepRunning()) {
+        storage.loadMoodEntries(moods);
+        BenchState::doNotOptimize(moods);
+    }
+}
+MOODOO_BENCH(loadMoodEntries, 1000, 100000, 1000000, 10000000);
+
+void saveTask(BenchState& state) {
+    ScratchDir scratch;
+    std::vector<Task> tasks = BenchData::makeTasks(state.size());
+    if (!BenchData::writeTasks(kTasksFile, tasks)) return;
+    Storage storage(kTasksFile, kJournalFile);
+    state.setItemsPerIteration(1);
+
+    // Appends to a file that already holds size tasks
+    Task task = tasks.back();
+    while (state.keepRunning()) {
+        ++task.id;
+        storage.saveTask(task);
+    }
+}
+MOODOO_BENCH(saveTask, 1000, 100000, 1000000, 10000000);
+
+void updateTask(BenchState& state) {
+    ScratchDir scratch;
+    std::vector<Task> tasks = BenchData::makeTasks(state.size());
+    if (!BenchData::writeTasks(kTasksFile, tasks)) return;
+    Storage storage(kTasksFile, kJournalFile);
+    state.setItemsPerIteration(1);
+
+    Task task = tasks[tasks.size() / 2];
+    while (state.keepRunning()) {
+        task.completed = !task.completed;
+        storage.updateTask(task);
+    }
+}
+MOODOO_BENCH(updateTask, 1000, 100000, 1000000, 10000000);
+
+void deleteTask(BenchState& state) {
+    ScratchDir scratch;
+    std::vector<Task> tasks = BenchData::makeTasks(state.size());
+    if (!BenchData::writeTasks(kTasksFile, tasks)) return;
+    Storage storage(kTasksFile, kJournalFile);
+    state.setItemsPerIteration(1);
+    state.setNote("includes re-adding the task");
+
+    // Delete the oldest task and append it again, so the file keeps its size
+    size_t next = 0;
+    while (state.keepRunning()) {
+        const Task& task = tasks[next];
+        storage.deleteTask(task.id);
+        storage.saveTask(task);
+        next = (next + 1) % tasks.size();
+    }
+}
+MOODOO_BENCH(deleteTask, 1000, 100000, 1000000, 10000000);
+
+} // namespace
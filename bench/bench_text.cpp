@@ -0,0 +1,61 @@
+#include <random>
+#include <string>
+#include <vector>
+#include "BenchHarness.h"
+#include "MoodKernels.h"
+#include "Tokenizer.h"
+
+// Case folding and tokenizing of journal-like text; size is in bytes
+
+namespace {
+
+std::string makeText(size_t bytes, bool multibyte) {
+    static const char* const asciiWords[] = {
+        "Feeling", "TIRED", "but", "Motivated", "today", "after", "a", "long", "WALK", "with", "friends"
+    };
+    static const char* const otherWords[] = {"Müde", "ÇA", "Привет", "καλημέρα", "😀", "Łódź"};
+    std::mt19937 rng(5);
+    std::string text;
+    text.reserve(bytes + 16);
+    while (text.size() < bytes) {
+        if (multibyte && rng() % 8 == 0) text += otherWords[rng() % 6];
+        else text += asciiWords[rng() % 11];
+        text += rng() % 10 == 0 ? ". " : " ";
+    }
+    text.resize(bytes);
+    return text;
+}
+
+void foldWith(BenchState& state, MoodKernels::Isa isa, bool multibyte) {
+    std::string text = makeText(state.size(), multibyte);
+    std::string folded;
+    MoodKernels::forceIsa(isa);
+    while (state.keepRunning()) {
+        Tokenizer::foldCase(text, folded);
+        BenchState::doNotOptimize(folded);
+    }
+    MoodKernels::forceIsa(MoodKernels::Isa::AVX2);
+}
+
+void foldAsciiScalar(BenchState& state) { foldWith(state, MoodKernels::Isa::SCALAR, false); }
+void foldAsciiSse42(BenchState& state) { foldWith(state, MoodKernels::Isa::SSE42, false); }
+void foldAsciiAvx2(BenchState& state) { foldWith(state, MoodKernels::Isa::AVX2, false); }
+void foldMixedAvx2(BenchState& state) { foldWith(state, MoodKernels::Isa::AVX2, true); }
+
+void tokenizeMixed(BenchState& state) {
+    std::string text = Tokenizer::foldCase(makeText(state.size(), true));
+    std::vector<Tokenizer::Span> tokens;
+    while (state.keepRunning()) {
+        tokens.clear();
+        Tokenizer::tokenize(text, tokens);
+        BenchState::doNotOptimize(tokens);
+    }
+}
+
+} // namespace
+
+MOODOO_BENCH(foldAsciiScalar, 256, 4096, 1000000);
+MOODOO_BENCH(foldAsciiSse42, 256, 4096, 1000000);
+MOODOO_BENCH(foldAsciiAvx2, 256, 4096, 1000000);
+MOODOO_BENCH(foldMixedAvx2, 256, 4096, 1000000);
+MOODOO_BENCH(tokenizeMixed, 256, 4096, 1000000);
@@ -0,0 +1,158 @@
+#include <cstdlib>
+#include <cstdio>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include "BenchData.h"
+#include "ReplayDriver.h"
+#include "WorkloadGenerator.h"
+
+// Usage:
+//   moodoo_load generate --dir D [--years N] [--entries-per-day X] [--tasks-per-day X]
+//                        [--words MIN-MAX] [--vocabulary N] [--completion RATE] [--seed S]
+//   moodoo_load replay --dir D [--threads N] [--ops N] [--mix ADD,MOOD,UPDATE,COMPLETE,SEARCH,STATS]
+//                      [--seed S] [--json]
+//
+// generate writes D/data/tasks.txt and D/data/journal.txt. replay runs on a
+// scratch copy of them, so one data set can be replayed many times.
+
+namespace {
+
+int usage() {
+    std::cerr << "Usage: moodoo_load generate --dir D [--years N] [--entries-per-day X] [--tasks-per-day X]\n"
+                 "                            [--words MIN-MAX] [--vocabulary N] [--completion RATE] [--seed S]\n"
+                 "       moodoo_load replay --dir D [--threads N] [--ops N]\n"
+                 "                          [--mix ADD,MOOD,UPDATE,COMPLETE,SEARCH,STATS] [--seed S] [--json]"
+              << std::endl;
+    return 1;
+}
+
+bool parseMix(const std::string& text, ReplayMix& mix) {
+    std::istringstream in(text);
+    int* fields[] = {&mix.addTask, &mix.logMood, &mix.update, &mix.complete, &mix.search, &mix.stats};
+    std::string part;
+    size_t count = 0;
+    while (std::getline(in, part, ',')) {
+        if (count == 6) return false;
+        *fields[count++] = std::atoi(part.c_str());
+    }
+    return count == 6;
+}
+
+int generate(const std::string& dir, const WorkloadProfile& profile) {
+    WorkloadGenerator generator(profile);
+    std::vector<Task> tasks;
+    std::vector<MoodEntry> moods;
+    generator.generate(time(nullptr), tasks, moods);
+
+    std::filesystem::path data = std::filesystem::path(dir) / "data";
+    std::filesystem::create_directories(data);
+    if (!BenchData::writeTasks((data / "tasks.txt").string(), tasks) ||
+        !BenchData::writeJournal((data / "journal.txt").string(), moods)) {
+        return 1;
+    }
+    size_t completed = 0;
+    for (const auto& task : tasks) completed += task.completed;
+    std::cout << "Generated " << tasks.size() << " tasks (" << completed << " completed) and "
+              << moods.size() << " journal entries in " << data.string() << std::endl;
+    return 0;
+}
+
+void printReport(const ReplayReport& report, const ReplayOptions& options, bool json) {
+    double throughput = report.seconds > 0 ? report.total / report.seconds : 0.0;
+    if (json) {
+        std::cout << std::fixed << std::setprecision(1) << "{\"threads\":" << options.threads
+                  << ",\"operations\":" << report.total << ",\"failures\":" << report.failures
+                  << ",\"seconds\":" << std::setprecision(3) << report.seconds << std::setprecision(1)
+                  << ",\"ops_per_second\":" << throughput << ",\"latency_us\":[";
+        for (size_t i = 0; i < report.operations.size(); ++i) {
+            const OperationStats& stats = report.operations[i];
+            std::cout << (i ? "," : "") << "{\"name\":\"" << stats.name << "\",\"count\":" << stats.count
+                      << ",\"p50\":" << stats.p50 << ",\"p99\":" << stats.p99 << ",\"p999\":" << stats.p999
+                      << ",\"max\":" << stats.max << "}";
+        }
+        std::cout << "]}" << std::endl;
+        return;
+    }
+
+    std::cout << std::left << std::setw(12) << "operation" << std::right << std::setw(10) << "count"
+              << std::setw(12) << "p50 us" << std::setw(12) << "p99 us" << std::setw(12) << "p999 us"
+              << std::setw(12) << "max us" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& stats : report.operations) {
+        std::cout << std::left << std::setw(12) << stats.name << std::right << std::setw(10) << stats.count
+                  << std::setw(12) << stats.p50 << std::setw(12) << stats.p99 << std::setw(12) << stats.p999
+                  << std::setw(12) << stats.max << std::endl;
+    }
+    std::cout << report.total << " operations on " << options.threads << " threads in "
+              << std::setprecision(2) << report.seconds << " s (" << std::setprecision(0) << throughput
+              << " ops/s)";
+    if (report.failures) std::cout << ", " << report.failures << " failed";
+    std::cout << std::endl;
+}
+
+int replay(const std::string& dir, const WorkloadProfile& profile, const ReplayOptions& options, bool json) {
+    std::filesystem::path data = std::filesystem::absolute(std::filesystem::path(dir) / "data");
+    if (!std::filesystem::exists(data / "tasks.txt") || !std::filesystem::exists(data / "journal.txt")) {
+        std::cerr << "Error: No data set in " << data.string() << "; run generate first" << std::endl;
+        return 1;
+    }
+
+    ScratchDir scratch;
+    std::filesystem::copy_file(data / "tasks.txt", "data/tasks.txt");
+    std::filesystem::copy_file(data / "journal.txt", "data/journal.txt");
+    Storage storage;
+    WorkloadGenerator generator(profile);
+    ReplayDriver driver(storage, generator);
+    if (!driver.prepare()) {
+        return 1;
+    }
+    ReplayReport report = driver.run(options);
+    printReport(report, options, json);
+    return report.failures ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) return usage();
+    std::string mode = argv[1];
+    std::string dir;
+    WorkloadProfile profile;
+    ReplayOptions options;
+    bool json = false;
+
+    for (int i = 2; i < argc; ++i) {
+        std::string flag = argv[i];
+        bool hasValue = i + 1 < argc;
+        std::string value = hasValue ? argv[i + 1] : "";
+        if (flag == "--json") {
+            json = true;
+            continue;
+        }
+        if (!hasValue) return usage();
+        ++i;
+        if (flag == "--dir") dir = value;
+        else if (flag == "--years") profile.years = std::atoi(value.c_str());
+        else if (flag == "--entries-per-day") profile.entriesPerDay = std::atof(value.c_str());
+        else if (flag == "--tasks-per-day") profile.tasksPerDay = std::atof(value.c_str());
+        else if (flag == "--vocabulary") profile.vocabulary = std::strtoull(value.c_str(), nullptr, 10);
+        else if (flag == "--completion") profile.completionRate = std::atof(value.c_str());
+        else if (flag == "--threads") options.threads = std::strtoull(value.c_str(), nullptr, 10);
+        else if (flag == "--ops") options.operations = std::strtoull(value.c_str(), nullptr, 10);
+        else if (flag == "--seed") profile.seed = options.seed = static_cast<unsigned>(std::atoi(value.c_str()));
+        else if (flag == "--words") {
+            if (std::sscanf(value.c_str(), "%d-%d", &profile.minWords, &profile.maxWords) != 2) return usage();
+        } else if (flag == "--mix") {
+            if (!parseMix(value, options.mix)) return usage();
+        } else {
+            return usage();
+        }
+    }
+    if (dir.empty()) return usage();
+
+    if (mode == "generate") return generate(dir, profile);
+    if (mode == "replay") return replay(dir, profile, options, json);
+    return usage();
+}
@@ -1,5 +1,6 @@
 #include "AddTaskDialog.h"
 #include <QMessageBox>
+#include <utility>
 
 AddTaskDialog::AddTaskDialog(Storage* storage, QWidget *parent)
     : QDialog(parent), storage(storage)
@@ -186,7 +187,7 @@ void AddTaskDialog::onAddTaskClicked()
     task.completed_time = 0;
     
     // Save task using existing backend
-    if (storage->saveTask(task)) {
+    if (storage->saveTask(std::move(task))) {
         QMessageBox::information(this, "Success", "Task added successfully! 🎉");
         accept(); // Close dialog
     } else {
@@ -0,0 +1,237 @@
+#include "BlockCodec.h"
+#include <cstring>
+#include <vector>
+
+#ifdef MOODOO_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+// LZ4 block format constants
+const size_t kMinMatch = 4;
+const size_t kLastLiterals = 5;     // The last 5 bytes are always literals
+const size_t kMatchSafeDistance = 12; // A match may not start within 12 bytes of the end
+const size_t kMaxOffset = 65535;
+const int kHashBits = 16;
+
+uint32_t read32(const unsigned char* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t hashSequence(uint32_t sequence) {
+    return (sequence * 2654435761U) >> (32 - kHashBits);
+}
+
+void writeLength(std::string& output, size_t length) {
+    while (length >= 255) {
+        output.push_back(static_cast<char>(255));
+        length -= 255;
+    }
+    output.push_back(static_cast<char>(length));
+}
+
+void writeSequence(std::string& output, const unsigned char* literals, size_t literalCount,
+                   size_t offset, size_t matchLength) {
+    size_t matchCode = matchLength - kMinMatch;
+    unsigned char token = static_cast<unsigned char>(
+        ((literalCount < 15 ? literalCount : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+    output.push_back(static_cast<char>(token));
+    if (literalCount >= 15) writeLength(output, literalCount - 15);
+    output.append(reinterpret_cast<const char*>(literals), literalCount);
+    output.push_back(static_cast<char>(offset & 0xFF));
+    output.push_back(static_cast<char>((offset >> 8) & 0xFF));
+    if (matchCode >= 15) writeLength(output, matchCode - 15);
+}
+
+void writeLastLiterals(std::string& output, const unsigned char* literals, size_t literalCount) {
+    unsigned char token = static_cast<unsigned char>((literalCount < 15 ? literalCount : 15) << 4);
+    output.push_back(static_cast<char>(token));
+    if (literalCount >= 15) writeLength(output, literalCount - 15);
+    output.append(reinterpret_cast<const char*>(literals), literalCount);
+}
+
+bool readLength(const unsigned char*& ip, const unsigned char* end, size_t& length) {
+    unsigned char byte;
+    do {
+        if (ip >= end) return false;
+        byte = *ip++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+} // namespace
+
+BlockCodec::Codec BlockCodec::preferred() {
+#ifdef MOODOO_HAVE_ZSTD
+    return Codec::ZSTD;
+#else
+    return Codec::LZ4;
+#endif
+}
+
+bool BlockCodec::isAvailable(Codec codec) {
+    switch (codec) {
+        case Codec::NONE: return true;
+        case Codec::LZ4: return true;
+#ifdef MOODOO_HAVE_ZSTD
+        case Codec::ZSTD: return true;
+#endif
+        default: return false;
+    }
+}
+
+std::string BlockCodec::codecToString(Codec codec) {
+    switch (codec) {
+        case Codec::LZ4: return "lz4";
+        case Codec::ZSTD: return "zstd";
+        default: return "none";
+    }
+}
+
+BlockCodec::Codec BlockCodec::stringToCodec(const std::string& str) {
+    if (str == "lz4") return Codec::LZ4;
+    if (str == "zstd") return Codec::ZSTD;
+    return Codec::NONE;
+}
+
+bool BlockCodec::compress(Codec codec, const std::string& input, std::string& output) {
+    switch (codec) {
+        case Codec::NONE:
+            output = input;
+            return true;
+        case Codec::LZ4:
+            compressLz4(input, output);
+            return true;
+        case Codec::ZSTD: {
+#ifdef MOODOO_HAVE_ZSTD
+            output.resize(ZSTD_compressBound(input.size()));
+            size_t written = ZSTD_compress(&output[0], output.size(), input.data(), input.size(), 3);
+            if (ZSTD_isError(written)) {
+                output.clear();
+                return false;
+            }
+            output.resize(written);
+            return true;
+#else
+            return false;
+#endif
+        }
+    }
+    return false;
+}
+
+bool BlockCodec::decompress(Codec codec, const std::string& input, size_t rawSize, std::string& output) {
+    switch (codec) {
+        case Codec::NONE:
+            if (input.size() != rawSize) return false;
+            output = input;
+            return true;
+        case Codec::LZ4:
+            return decompressLz4(input, rawSize, output);
+        case Codec::ZSTD: {
+#ifdef MOODOO_HAVE_ZSTD
+            output.resize(rawSize);
+            size_t read = ZSTD_decompress(&output[0], rawSize, input.data(), input.size());
+            if (ZSTD_isError(read) || read != rawSize) {
+                output.clear();
+                return false;
+            }
+            return true;
+#else
+            return false;
+#endif
+        }
+    }
+    return false;
+}
+
+void BlockCodec::compressLz4(const std::string& input, std::string& output) {
+    const unsigned char* src = reinterpret_cast<const unsigned char*>(input.data());
+    const size_t size = input.size();
+
+    output.clear();
+    output.reserve(size + size / 255 + 16);
+
+    if (size < kMatchSafeDistance + 1) {
+        writeLastLiterals(output, src, size);
+        return;
+    }
+
+    // Greedy single-probe matcher: last position seen for each 4-byte hash
+    std::vector<int64_t> table(size_t(1) << kHashBits, -1);
+    const size_t matchLimit = size - kMatchSafeDistance;
+    size_t anchor = 0;
+    size_t pos = 0;
+
+    while (pos < matchLimit) {
+        uint32_t sequence = read32(src + pos);
+        uint32_t hash = hashSequence(sequence);
+        int64_t candidate = table[hash];
+        table[hash] = static_cast<int64_t>(pos);
+
+        if (candidate < 0 || pos - static_cast<size_t>(candidate) > kMaxOffset ||
+            read32(src + candidate) != sequence) {
+            ++pos;
+            continue;
+        }
+
+        size_t reference = static_cast<size_t>(candidate);
+        size_t matchLength = kMinMatch;
+        size_t maxLength = size - kLastLiterals - pos;
+        while (matchLength < maxLength && src[reference + matchLength] == src[pos + matchLength]) {
+            ++matchLength;
+        }
+
+        writeSequence(output, src + anchor, pos - anchor, pos - reference, matchLength);
+        pos += matchLength;
+        anchor = pos;
+    }
+
+    writeLastLiterals(output, src + anchor, size - anchor);
+}
+
+bool BlockCodec::decompressLz4(const std::string& input, size_t rawSize, std::string& output) {
+    const unsigned char* ip = reinterpret_cast<const unsigned char*>(input.data());
+    const unsigned char* end = ip + input.size();
+
+    output.clear();
+    output.reserve(rawSize);
+
+    while (ip < end) {
+        unsigned char token = *ip++;
+
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !readLength(ip, end, literalCount)) return false;
+        if (static_cast<size_t>(end - ip) < literalCount || output.size() + literalCount > rawSize) return false;
+        output.append(reinterpret_cast<const char*>(ip), literalCount);
+        ip += literalCount;
+
+        if (ip == end) break; // Final sequence carries literals only
+
+        if (end - ip < 2) return false;
+        size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > output.size()) return false;
+
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !readLength(ip, end, matchLength)) return false;
+        matchLength += kMinMatch;
+        if (output.size() + matchLength > rawSize) return false;
+
+        size_t from = output.size() - offset;
+        if (offset >= matchLength) {
+            output.append(output, from, matchLength);
+        } else {
+            // Overlapping match repeats its own output byte by byte
+            for (size_t i = 0; i < matchLength; ++i) {
+                output.push_back(output[from + i]);
+            }
+        }
+    }
+
+    return output.size() == rawSize;
+}
@@ -0,0 +1,33 @@
+#ifndef BLOCK_CODEC_H
+#define BLOCK_CODEC_H
+
+#include <string>
+#include <cstdint>
+
+// Whole-block compression for sealed journal segments.
+// LZ4 (block format) is built in; zstd is used when the build defines MOODOO_HAVE_ZSTD.
+class BlockCodec {
+public:
+    enum class Codec : uint8_t {
+        NONE = 0,
+        LZ4 = 1,
+        ZSTD = 2
+    };
+
+    // Best codec available in this build
+    static Codec preferred();
+    static bool isAvailable(Codec codec);
+
+    static std::string codecToString(Codec codec);
+    static Codec stringToCodec(const std::string& str);
+
+    // output is replaced, not appended to
+    static bool compress(Codec codec, const std::string& input, std::string& output);
+    static bool decompress(Codec codec, const std::string& input, size_t rawSize, std::string& output);
+
+private:
+    static void compressLz4(const std::string& input, std::string& output);
+    static bool decompressLz4(const std::string& input, size_t rawSize, std::string& output);
+};
+
+#endif // BLOCK_CODEC_H
@@ -0,0 +1,736 @@
+#include "Commands.h"
+#include "Metrics.h"
+#include "MoodAnalyzer.h"
+#include "MoodKernels.h"
+#include "RecordView.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <unordered_map>
+
+namespace {
+
+const time_t kWeek = 7 * 24 * 60 * 60;
+
+// Builds one JSON object; keys are trusted literals, values are escaped
+class JsonObject {
+public:
+    JsonObject() : text("{") {}
+
+    JsonObject& string(const char* key, std::string_view value) {
+        return add(key).escape(value);
+    }
+    JsonObject& number(const char* key, int64_t value) {
+        add(key).text += std::to_string(value);
+        return *this;
+    }
+    JsonObject& decimal(const char* key, double value) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.3f", value);
+        add(key).text += buffer;
+        return *this;
+    }
+    JsonObject& boolean(const char* key, bool value) {
+        add(key).text += value ? "true" : "false";
+        return *this;
+    }
+    JsonObject& strings(const char* key, const std::vector<Keyword>& values) {
+        add(key).text += '[';
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (i) text += ',';
+            escape(values[i].str());
+        }
+        text += ']';
+        return *this;
+    }
+
+    void write(std::ostream& out) const { out << text << "}\n"; }
+
+private:
+    std::string text;
+
+    JsonObject& add(const char* key) {
+        if (text.size() > 1) text += ',';
+        text += '"';
+        text += key;
+        text += "\":";
+        return *this;
+    }
+
+    JsonObject& escape(std::string_view value) {
+        text += '"';
+        for (char c : value) {
+            switch (c) {
+                case '"': text += "\\\""; break;
+                case '\\': text += "\\\\"; break;
+                case '\n': text += "\\n"; break;
+                case '\r': text += "\\r"; break;
+                case '\t': text += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char buffer[8];
+                        std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                        text += buffer;
+                    } else {
+                        text += c;
+                    }
+            }
+        }
+        text += '"';
+        return *this;
+    }
+};
+
+// --name value options, --flag switches and positional words
+struct Arguments {
+    std::vector<std::string> positional;
+    std::unordered_map<std::string, std::string> options;
+
+    bool has(const std::string& name) const { return options.count(name) != 0; }
+    const std::string& get(const std::string& name, const std::string& fallback) const {
+        auto found = options.find(name);
+        return found == options.end() ? fallback : found->second;
+    }
+};
+
+bool parseArguments(const std::vector<std::string>& args, const std::vector<std::string>& flags,
+                    Arguments& parsed, std::string& error) {
+    for (size_t i = 1; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        if (arg.size() > 2 && arg.compare(0, 2, "--") == 0) {
+            std::string name = arg.substr(2);
+            if (std::find(flags.begin(), flags.end(), name) != flags.end()) {
+                parsed.options[name] = "1";
+            } else if (i + 1 < args.size()) {
+                parsed.options[name] = args[++i];
+            } else {
+                error = "Missing value for " + arg;
+                return false;
+            }
+        } else {
+            parsed.positional.push_back(arg);
+        }
+    }
+    return true;
+}
+
+std::string joined(const std::vector<std::string>& words, size_t from) {
+    std::string result;
+    for (size_t i = from; i < words.size(); ++i) {
+        if (i > from) result += ' ';
+        result += words[i];
+    }
+    return result;
+}
+
+// Storage lines are '|' separated, one record per line
+bool storable(const std::string& text, std::string& error) {
+    if (text.find_first_of("|\r\n") != std::string::npos) {
+        error = "Text can't contain '|' or line breaks";
+        return false;
+    }
+    return true;
+}
+
+bool parseNumber(const std::string& text, long long low, long long high, long long& value) {
+    if (text.empty()) return false;
+    char* end = nullptr;
+    value = std::strtoll(text.c_str(), &end, 10);
+    return *end == '\0' && value >= low && value <= high;
+}
+
+// A level by name (names[0] is level 1) or by number
+bool parseLevel(const std::string& text, const std::vector<const char*>& names, int& level) {
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (text == names[i]) {
+            level = static_cast<int>(i) + 1;
+            return true;
+        }
+    }
+    long long number;
+    if (!parseNumber(text, 1, static_cast<long long>(names.size()), number)) return false;
+    level = static_cast<int>(number);
+    return true;
+}
+
+bool parseTaskId(const Arguments& parsed, long long& id, std::string& error) {
+    if (parsed.positional.size() != 1 || !parseNumber(parsed.positional[0], 1, std::numeric_limits<int>::max(), id)) {
+        error = "Expected one task id";
+        return false;
+    }
+    return true;
+}
+
+const char* priorityName(Priority priority) {
+    switch (priority) {
+        case Priority::LOW: return "low";
+        case Priority::HIGH: return "high";
+        default: return "medium";
+    }
+}
+
+const char* difficultyName(TaskDifficulty difficulty) {
+    switch (difficulty) {
+        case TaskDifficulty::EASY: return "easy";
+        case TaskDifficulty::HARD: return "hard";
+        default: return "medium";
+    }
+}
+
+void writeTask(const Task& task, std::ostream& out) {
+    JsonObject()
+        .number("id", task.id)
+        .string("title", task.title)
+        .string("description", task.description)
+        .string("priority", priorityName(task.priority))
+        .string("difficulty", difficultyName(task.difficulty))
+        .boolean("completed", task.completed)
+        .number("created", task.created)
+        .number("completed_time", task.completed_time)
+        .write(out);
+}
+
+void writeMood(const MoodEntry& entry, std::ostream& out) {
+    JsonObject()
+        .number("id", entry.id)
+        .number("mood", static_cast<int>(entry.mood))
+        .number("timestamp", entry.timestamp)
+        .string("text", entry.content)
+        .strings("keywords", entry.keywords)
+        .decimal("sentiment", entry.sentimentScore)
+        .write(out);
+}
+
+} // namespace
+
+Commands::Commands(Storage& storage)
+    : storage(storage), queries(&searchIndex), indexing(false), residentMode(false) {
+}
+
+Commands::~Commands() {
+    if (indexing) {
+        storage.removeListener(&queries);
+        storage.removeListener(&searchIndex);
+    }
+}
+
+void Commands::setResident() {
+    if (!residentMode) {
+        storage.setResident();
+        residentMode = true;
+        startIndexing();
+    }
+}
+
+bool Commands::warmUp(std::string& error) {
+    RecordSpan<Task> current;
+    RecordSpan<MoodEntry> entries;
+    if (!tasks(current, error) || !moods(std::numeric_limits<time_t>::min(), entries, error)) return false;
+    if (!storage.loadColumns()) {
+        error = "Could not load data";
+        return false;
+    }
+    return true;
+}
+
+bool Commands::tasks(RecordSpan<Task>& current, std::string& error) {
+    // Loading is also what tells storage the next free id
+    if (!storage.taskSpan(current)) {
+        error = "Could not load tasks";
+        return false;
+    }
+    return true;
+}
+
+bool Commands::moods(time_t since, RecordSpan<MoodEntry>& entries, std::string& error) {
+    if (!storage.moodSpan(since, entries)) {
+        error = "Could not load journal";
+        return false;
+    }
+    return true;
+}
+
+void Commands::usage(std::ostream& out) {
+    out << "Usage: moodoo <command> [options]\n"
+           "  add-task <title> [--description D] [--priority low|medium|high] [--difficulty easy|medium|hard]\n"
+           "  log-mood <very_low|low|neutral|good|excellent|1-5> <text>\n"
+           "  complete <id> [--undo]\n"
+           "  edit-task <id> [--title T] [--description D] [--priority P] [--difficulty D] [--done|--open]\n"
+           "  delete-task <id>\n"
+           "  list [--journal] [--filter QUERY] [--limit N]\n"
+           "  stats [--internal]\n"
+           "  weekly\n"
+           "  batch      Run commands from stdin, one per line\n"
+           "Output is one JSON object per line; see Query.h for the filter syntax.\n"
+           "Without a command, moodoo starts the interactive menu.\n";
+}
+
+bool Commands::splitLine(const std::string& line, std::vector<std::string>& args, std::string& error) {
+    args.clear();
+    std::string current;
+    bool inWord = false;
+    char quote = 0;
+    for (size_t i = 0; i < line.size(); ++i) {
+        char c = line[i];
+        if (c == '\\' && i + 1 < line.size() && quote != '\'') {
+            current += line[++i];
+            inWord = true;
+        } else if (quote) {
+            if (c == quote) quote = 0;
+            else current += c;
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+            inWord = true;
+        } else if (c == ' ' || c == '\t' || c == '\r') {
+            if (inWord) args.push_back(current);
+            current.clear();
+            inWord = false;
+        } else {
+            current += c;
+            inWord = true;
+        }
+    }
+    if (quote) {
+        error = "Missing closing quote";
+        return false;
+    }
+    if (inWord) args.push_back(current);
+    return true;
+}
+
+int Commands::run(const std::vector<std::string>& args, std::ostream& out) {
+    if (args.empty()) {
+        usage(std::cerr);
+        return 1;
+    }
+    const std::string& command = args[0];
+    std::string error;
+    bool ok;
+    if (command == "add-task") ok = addTask(args, out, error);
+    else if (command == "log-mood") ok = logMood(args, out, error);
+    else if (command == "complete") ok = complete(args, out, error);
+    else if (command == "edit-task") ok = editTask(args, out, error);
+    else if (command == "delete-task") ok = deleteTask(args, out, error);
+    else if (command == "list") ok = list(args, out, error);
+    else if (command == "stats") ok = stats(args, out, error);
+    else if (command == "weekly") ok = weekly(out, error);
+    else if (command == "batch") return runBatch(std::cin, out);
+    else if (command == "help" || command == "--help") {
+        usage(out);
+        return 0;
+    } else {
+        error = "Unknown command";
+        ok = false;
+    }
+
+    if (!ok) {
+        JsonObject().boolean("ok", false).string("command", command).string("error", error).write(out);
+    }
+    return ok ? 0 : 1;
+}
+
+int Commands::runLine(const std::string& line, std::ostream& out) {
+    size_t start = line.find_first_not_of(" \t\r");
+    if (start == std::string::npos || line[start] == '#') return 0;
+    std::vector<std::string> args;
+    std::string error;
+    if (!splitLine(line, args, error)) {
+        JsonObject().boolean("ok", false).string("command", "").string("error", error).write(out);
+        return 1;
+    }
+    if (args[0] == "batch") {
+        JsonObject().boolean("ok", false).string("command", "batch").string("error", "Batches don't nest").write(out);
+        return 1;
+    }
+    // Usage text has no status line, which would break the response framing
+    if (args[0] == "help" || args[0] == "--help") {
+        JsonObject().boolean("ok", false).string("command", args[0]).string("error", "Not available in batches").write(out);
+        return 1;
+    }
+    return run(args, out);
+}
+
+int Commands::runBatch(std::istream& in, std::ostream& out) {
+    int status = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (runLine(line, out) != 0) status = 1;
+    }
+    out.flush();
+    return status;
+}
+
+void Commands::startIndexing() {
+    // The next full load fills both indexes; saves keep them current after that
+    if (!indexing) {
+        storage.addListener(&searchIndex);
+        storage.addListener(&queries);
+        indexing = true;
+    }
+}
+
+bool Commands::addTask(const std::vector<std::string>& args, std::ostream& out, std::string& error) {
+    Arguments parsed;
+    if (!parseArguments(args, {}, parsed, error)) return false;
+
+    Task task;
+    task.title = parsed.has("title") ? parsed.get("title", "") : joined(parsed.positional, 0);
+    task.description = parsed.get("description", "");
+    if (task.title.empty()) {
+        error = "Missing title";
+        return false;
+    }
+    if (!storable(task.title, error) || !storable(task.description, error)) return false;
+
+    int level = 2;
+    if (parsed.has("priority") && !parseLevel(parsed.get("priority", ""), {"low", "medium", "high"}, level)) {
+        error = "Priority must be low, medium or high";
+        return false;
+    }
+    task.priority = static_cast<Priority>(level);
+    level = 2;
+    if (parsed.has("difficulty") && !parseLevel(parsed.get("difficulty", ""), {"easy", "medium", "hard"}, level)) {
+        error = "Difficulty must be easy, medium or hard";
+        return false;
+    }
+    task.difficulty = static_cast<TaskDifficulty>(level);
+
+    // Storage knows the next free id once the tasks have been loaded
+    RecordSpan<Task> current;
+    if (!tasks(current, error)) return false;
+    int id = storage.getNextTaskId();
+    task.id = id;
+    if (!storage.saveTask(std::move(task))) {
+        error = "Could not save task";
+        return false;
+    }
+    JsonObject().boolean("ok", true).string("command", "add-task").number("id", id).write(out);
+    return true;
+}
+
+bool Commands::logMood(const std::vector<std::string>& args, std::ostream& out, std::string& error) {
+    Arguments parsed;
+    if (!parseArguments(args, {}, parsed, error)) return false;
+
+    std::string levelText = parsed.has("mood") ? parsed.get("mood", "")
+                                               : (parsed.positional.empty() ? "" : parsed.positional[0]);
+    int level;
+    if (!parseLevel(levelText, {"very_low", "low", "neutral", "good", "excellent"}, level)) {
+        error = "Mood must be very_low, low, neutral, good, excellent or 1-5";
+        return false;
+    }
+    MoodEntry entry;
+    entry.mood = static_cast<MoodLevel>(level);
+    entry.content = parsed.has("text") ? parsed.get("text", "") : joined(parsed.positional, parsed.has("mood") ? 0 : 1);
+    if (!storable(entry.content, error)) return false;
+
+    // The hot journal and the segment index are enough to know the next id
+    RecordSpan<MoodEntry> entries;
+    if (!moods(std::numeric_limits<time_t>::max(), entries, error)) return false;
+    entry.id = storage.getNextMoodId();
+    MoodAnalyzer analyzer;
+    analyzer.analyzeMoodEntry(entry);
+    if (!storage.saveMoodEntry(entry)) {
+        error = "Could not save mood entry";
+        return false;
+    }
+    JsonObject()
+        .boolean("ok", true)
+        .string("command", "log-mood")
+        .number("id", entry.id)
+        .decimal("sentiment", entry.sentimentScore)
+        .strings("detected_keywords", entry.extractedKeywords)
+        .write(out);
+    return true;
+}
+
+bool Commands::complete(const std::vector<std::string>& args, std::ostream& out, std::string& error) {
+    Arguments parsed;
+    if (!parseArguments(args, {"undo"}, parsed, error)) return false;
+    long long id;
+    Task task;
+    if (!parseTaskId(parsed, id, error) || !findTask(id, task, error)) return false;
+    bool done = !parsed.has("undo");
+    if (task.completed != done) {
+        task.completed = done;
+        task.completed_time = done ? time(nullptr) : 0;
+        if (!storage.updateTask(task)) {
+            error = "Could not update task";
+            return false;
+        }
+    }
+    JsonObject()
+        .boolean("ok", true)
+        .string("command", "complete")
+        .number("id", task.id)
+        .boolean("completed", task.completed)
+        .number("completed_time", task.completed_time)
+        .write(out);
+    return true;
+}
+
+bool Commands::findTask(long long id, Task& task, std::string& error) {
+    RecordSpan<Task> current;
+    if (!tasks(current, error)) return false;
+    auto found = std::find_if(current.begin(), current.end(), [&](const Task& candidate) { return candidate.id == id; });
+    if (found == current.end()) {
+        error = "No task with id " + std::to_string(id);
+        return false;
+    }
+    // A copy: an update changes the records underneath current
+    task = *found;
+    return true;
+}
+
+bool Commands::editTask(const std::vector<std::string>& args, std::ostream& out, std::string& error) {
+    Arguments parsed;
+    if (!parseArguments(args, {"done", "open"}, parsed, error)) return false;
+    long long id;
+    Task task;
+    if (!parseTaskId(parsed, id, error) || !findTask(id, task, error)) return false;
+    if (parsed.has("done") && parsed.has("open")) {
+        error = "Use --done or --open, not both";
+        return false;
+    }
+
+    if (parsed.has("title")) task.title = parsed.get("title", "");
+    if (parsed.has("description")) task.description = parsed.get("description", "");
+    if (task.title.empty()) {
+        error = "Missing title";
+        return false;
+    }
+    if (!storable(task.title, error) || !storable(task.description, error)) return false;
+    int level;
+    if (parsed.has("priority")) {
+        if (!parseLevel(parsed.get("priority", ""), {"low", "medium", "high"}, level)) {
+            error = "Priority must be low, medium or high";
+            return false;
+        }
+        task.priority = static_cast<Priority>(level);
+    }
+    if (parsed.has("difficulty")) {
+        if (!parseLevel(parsed.get("difficulty", ""), {"easy", "medium", "hard"}, level)) {
+            error = "Difficulty must be easy, medium or hard";
+            return false;
+        }
+        task.difficulty = static_cast<TaskDifficulty>(level);
+    }
+    // Same as complete: the time is stamped here, when the change lands
+    if ((parsed.has("done") && !task.completed) || (parsed.has("open") && task.completed)) {
+        task.completed = parsed.has("done");
+        task.completed_time = task.completed ? time(nullptr) : 0;
+    }
+
+    if (!storage.updateTask(task)) {
+        error = "Could not update task";
+        return false;
+    }
+    writeTask(task, out);
+    JsonObject().boolean("ok", true).string("command", "edit-task").number("id", task.id).write(out);
+    return true;
+}
+
+bool Commands::deleteTask(const std::vector<std::string>& args, std::ostream& out, std::string& error) {
+    Arguments parsed;
+    if (!parseArguments(args, {}, parsed, error)) return false;
+    long long id;
+    Task task;
+    if (!parseTaskId(parsed, id, error) || !findTask(id, task, error)) return false;
+    if (!storage.deleteTask(task.id)) {
+        error = "Could not delete task";
+        return false;
+    }
+    JsonObject().boolean("ok", true).string("command", "delete-task").number("id", task.id).write(out);
+    return true;
+}
+
+bool Commands::list(const std::vector<std::string>& args, std::ostream& out, std::string& error) {
+    Arguments parsed;
+    if (!parseArguments(args, {"journal"}, parsed, error)) return false;
+    if (!parsed.positional.empty()) {
+        error = "Unexpected argument '" + parsed.positional[0] + "'";
+        return false;
+    }
+    long long limit = std::numeric_limits<int>::max();
+    if (parsed.has("limit") && !parseNumber(parsed.get("limit", ""), 0, std::numeric_limits<int>::max(), limit)) {
+        error = "Limit must be a number";
+        return false;
+    }
+    bool journal = parsed.has("journal");
+    Query::Target target = journal ? Query::Target::MOODS : Query::Target::TASKS;
+
+    Query query;
+    bool filtered = parsed.has("filter");
+    if (filtered) {
+        if (!Query::parse(parsed.get("filter", ""), target, query, error)) return false;
+        filtered = !query.empty();
+        if (filtered) startIndexing();
+    }
+
+    size_t count = 0;
+    if (!journal) {
+        RecordSpan<Task> current;
+        if (!tasks(current, error)) return false;
+        if (!filtered) {
+            for (size_t i = 0; i < current.size() && count < static_cast<size_t>(limit); ++i, ++count) {
+                writeTask(current[i], out);
+            }
+        } else {
+            std::vector<int> ids;
+            if (!queries.execute(query, ids)) {
+                error = "Could not run query";
+                return false;
+            }
+            std::unordered_map<int, const Task*> byId;
+            for (const auto& task : current) byId.emplace(task.id, &task);
+            for (int id : ids) {
+                if (count == static_cast<size_t>(limit)) break;
+                auto found = byId.find(id);
+                if (found != byId.end()) {
+                    writeTask(*found->second, out);
+                    ++count;
+                }
+            }
+        }
+    } else {
+        RecordSpan<MoodEntry> entries;
+        bool loaded = false;
+        if (!filtered || !queries.covers(Query::Target::MOODS) || residentMode) {
+            if (!moods(std::numeric_limits<time_t>::min(), entries, error)) return false;
+            loaded = true;
+        }
+        if (filtered) {
+            std::vector<int> ids;
+            if (!queries.execute(query, ids)) {
+                error = "Could not run query";
+                return false;
+            }
+            if (!loaded) {
+                // Indexed already: only read the segments back to the oldest match
+                time_t since = std::numeric_limits<time_t>::max();
+                for (int id : ids) {
+                    since = std::min(since, static_cast<time_t>(queries.valueOf(target, id, Query::CREATED)));
+                }
+                if (!moods(since, entries, error)) return false;
+            }
+            std::unordered_map<int, const MoodEntry*> byId;
+            for (const auto& entry : entries) byId.emplace(entry.id, &entry);
+            for (int id : ids) {
+                if (count == static_cast<size_t>(limit)) break;
+                auto found = byId.find(id);
+                if (found != byId.end()) {
+                    writeMood(*found->second, out);
+                    ++count;
+                }
+            }
+        } else {
+            for (size_t i = 0; i < entries.size() && count < static_cast<size_t>(limit); ++i, ++count) {
+                writeMood(entries[i], out);
+            }
+        }
+    }
+    JsonObject().boolean("ok", true).string("command", "list").number("count", count).write(out);
+    return true;
+}
+
+bool Commands::stats(const std::vector<std::string>& args, std::ostream& out, std::string& error) {
+    Arguments parsed;
+    if (!parseArguments(args, {"internal"}, parsed, error)) return false;
+    if (parsed.has("internal")) {
+        internalStats(out);
+        return true;
+    }
+
+    if (!storage.loadColumns()) {
+        error = "Could not load data";
+        return false;
+    }
+    const TaskColumns& tasks = storage.taskColumns();
+    const MoodColumns& moods = storage.moodColumns();
+    size_t completed = static_cast<size_t>(std::count(tasks.completed.begin(), tasks.completed.end(), 1));
+    MoodKernels::Histogram levels = MoodKernels::histogram(moods.mood.data(), moods.size());
+    uint64_t moodSum = 0;
+    for (int level = 1; level <= 5; ++level) {
+        moodSum += levels.counts[level] * level;
+    }
+
+    JsonObject()
+        .boolean("ok", true)
+        .string("command", "stats")
+        .number("tasks", tasks.size())
+        .number("completed", completed)
+        .number("pending", tasks.size() - completed)
+        .decimal("completion_rate", tasks.size() ? static_cast<double>(completed) / tasks.size() : 0.0)
+        .number("moods", moods.size())
+        .decimal("average_mood", moods.size() ? static_cast<double>(moodSum) / moods.size() : 0.0)
+        .number("mood_very_low", levels.counts[1])
+        .number("mood_low", levels.counts[2])
+        .number("mood_neutral", levels.counts[3])
+        .number("mood_good", levels.counts[4])
+        .number("mood_excellent", levels.counts[5])
+        .write(out);
+    return true;
+}
+
+void Commands::internalStats(std::ostream& out) {
+    // Covers this process only; ask moodood for the long-running numbers
+    Metrics::Snapshot snapshot = Metrics::snapshot();
+    for (int c = 0; c < Metrics::COUNTER_COUNT; ++c) {
+        JsonObject()
+            .string("counter", Metrics::counterName(static_cast<Metrics::Counter>(c)))
+            .number("value", static_cast<int64_t>(snapshot.counters[c]))
+            .write(out);
+    }
+    for (const auto& timer : snapshot.timers) {
+        if (timer.calls == 0) continue;
+        JsonObject()
+            .string("operation", Metrics::timerName(timer.timer))
+            .number("calls", static_cast<int64_t>(timer.calls))
+            .number("timed", static_cast<int64_t>(timer.samples))
+            .decimal("mean_us", timer.samples ? timer.totalNanos / 1000.0 / timer.samples : 0.0)
+            .decimal("p50_us", timer.percentile(0.50) / 1000.0)
+            .decimal("p99_us", timer.percentile(0.99) / 1000.0)
+            .decimal("p999_us", timer.percentile(0.999) / 1000.0)
+            .decimal("max_us", timer.maxNanos() / 1000.0)
+            .write(out);
+    }
+    JsonObject().boolean("ok", true).string("command", "stats").boolean("internal", true)
+        .boolean("enabled", Metrics::enabled()).write(out);
+}
+
+bool Commands::weekly(std::ostream& out, std::string& error) {
+    // Only the past week matters, so sealed history stays on disk
+    time_t weekAgo = time(nullptr) - kWeek;
+    RecordSpan<MoodEntry> recent;
+    if (!moods(weekAgo, recent, error)) return false;
+    // The resident cache holds more than the week; view it rather than copy
+    RecordView<MoodEntry> week;
+    week.select(recent, [&](const MoodEntry& entry) { return entry.timestamp >= weekAgo; });
+    RecordSpan<Task> current;
+    if (!tasks(current, error)) return false;
+
+    int moodSum = 0;
+    for (const auto& entry : week) {
+        moodSum += static_cast<int>(entry.mood);
+    }
+    size_t created = 0;
+    size_t completed = 0;
+    for (const auto& task : current) {
+        if (task.created >= weekAgo) ++created;
+        if (task.completed && task.completed_time >= weekAgo) ++completed;
+    }
+
+    MoodAnalyzer analyzer;
+    JsonObject()
+        .boolean("ok", true)
+        .string("command", "weekly")
+        .number("since", weekAgo)
+        .number("moods", week.size())
+        .decimal("average_mood", week.empty() ? 0.0 : static_cast<double>(moodSum) / week.size())
+        .number("tasks_created", created)
+        .number("tasks_completed", completed)
+        .string("summary", analyzer.analyzeWeeklyPatterns(recent, current))
+        .write(out);
+    return true;
+}
@@ -0,0 +1,77 @@
+#ifndef COMMANDS_H
+#define COMMANDS_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Storage.h"
+#include "SearchIndex.h"
+#include "QueryEngine.h"
+
+// Non-interactive front end for scripts:
+//
+//   moodoo add-task <title> [--description D] [--priority P] [--difficulty D]
+//   moodoo log-mood <level> <text>
+//   moodoo complete <id> [--undo]
+//   moodoo edit-task <id> [--title T] [--description D] [--priority P] [--difficulty D] [--done | --open]
+//   moodoo delete-task <id>
+//   moodoo list [--journal] [--filter QUERY] [--limit N]
+//   moodoo stats [--internal]      (--internal: call counts and latencies, see Metrics.h)
+//   moodoo weekly
+//   moodoo batch            (one command per line on stdin, one process)
+//
+// Every command prints one JSON object per line: results, or
+// {"ok":false,"command":...,"error":...}. A command only reads what it needs,
+// so adding a task never touches the journal. The search and query indexes
+// are built the first time a --filter needs them and then kept current, which
+// makes repeated filtered lists in a batch cheap. The daemon (moodood) runs
+// the same commands resident, with everything already in memory.
+class Commands {
+public:
+    explicit Commands(Storage& storage);
+    ~Commands();
+
+    // Keeps tasks, the journal and the indexes in memory after their first
+    // load and answers from there. Only safe in the files' single writer (moodood).
+    void setResident();
+    // Loads everything up front so the first requests don't pay for it
+    bool warmUp(std::string& error);
+
+    // Runs one command; the exit status is 0 on success and 1 otherwise
+    int run(const std::vector<std::string>& args, std::ostream& out);
+    // Runs one command line; blank lines and # comments print nothing and return 0
+    int runLine(const std::string& line, std::ostream& out);
+    // Runs every line of in; 1 if any command failed
+    int runBatch(std::istream& in, std::ostream& out);
+
+    // Shell-like split: spaces separate, quotes group, backslash escapes
+    static bool splitLine(const std::string& line, std::vector<std::string>& args, std::string& error);
+    static void usage(std::ostream& out);
+
+private:
+    Storage& storage;
+    SearchIndex searchIndex;
+    QueryEngine queries;
+    bool indexing;
+    bool residentMode;
+
+    void startIndexing();
+    // Spans over Storage's records, valid until the next write; false with error set
+    bool tasks(RecordSpan<Task>& current, std::string& error);
+    // Journal entries from since on (resident: the whole journal)
+    bool moods(time_t since, RecordSpan<MoodEntry>& entries, std::string& error);
+
+    bool addTask(const std::vector<std::string>& args, std::ostream& out, std::string& error);
+    bool logMood(const std::vector<std::string>& args, std::ostream& out, std::string& error);
+    bool complete(const std::vector<std::string>& args, std::ostream& out, std::string& error);
+    bool editTask(const std::vector<std::string>& args, std::ostream& out, std::string& error);
+    bool deleteTask(const std::vector<std::string>& args, std::ostream& out, std::string& error);
+    // A copy of the task with this id; false with error set
+    bool findTask(long long id, Task& task, std::string& error);
+    bool list(const std::vector<std::string>& args, std::ostream& out, std::string& error);
+    bool stats(const std::vector<std::string>& args, std::ostream& out, std::string& error);
+    void internalStats(std::ostream& out);
+    bool weekly(std::ostream& out, std::string& error);
+};
+
+#endif // COMMANDS_H
@@ -0,0 +1,237 @@
+#include "CompletionModel.h"
+#include "LocalTime.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+const double kL2 = 1e-4;
+// Moods older than this say nothing about the moment of a completion
+const time_t kContextWindow = 2 * 24 * 60 * 60;
+
+int clampLevel(int level) {
+    return std::min(3, std::max(1, level));
+}
+
+double sigmoid(double z) {
+    z = std::min(30.0, std::max(-30.0, z));
+    return 1.0 / (1.0 + std::exp(-z));
+}
+
+} // namespace
+
+CompletionModel::CompletionModel() : examples(0), completions(0), rng(20240611) {
+    std::fill(weights, weights + kFeatures, 0.0);
+}
+
+void CompletionModel::features(Priority priority, TaskDifficulty difficulty, const CompletionContext& context,
+                               double* out) {
+    std::fill(out, out + kFeatures, 0.0);
+    int difficultyIndex = clampLevel(static_cast<int>(difficulty)) - 1;
+    int priorityIndex = clampLevel(static_cast<int>(priority)) - 1;
+    double mood = (static_cast<int>(context.mood) - 3) / 2.0;   // -1 .. 1
+
+    out[0] = 1.0;
+    out[1] = mood;
+    out[2] = context.sentiment;
+    out[3 + difficultyIndex] = 1.0;
+    out[6 + priorityIndex] = 1.0;
+    // Mood band x difficulty, so "easy when low, hard when high" is learnable
+    int band = context.mood <= MoodLevel::LOW ? 0 : (context.mood == MoodLevel::NEUTRAL ? 1 : 2);
+    out[9 + band * 3 + difficultyIndex] = 1.0;
+
+    // Hour of day on a circle so 23:00 and 01:00 end up close
+    std::tm local = LocalTime::local(context.when);
+    double angle = 2.0 * kPi * (local.tm_hour + local.tm_min / 60.0) / 24.0;
+    out[18] = std::sin(angle);
+    out[19] = std::cos(angle);
+    out[20 + local.tm_wday] = 1.0;
+}
+
+double CompletionModel::learningRate() const {
+    return std::max(0.01, 0.1 / std::sqrt(1.0 + examples / 50.0));
+}
+
+double CompletionModel::probability(Priority priority, TaskDifficulty difficulty,
+                                    const CompletionContext& context) const {
+    double x[kFeatures];
+    features(priority, difficulty, context, x);
+    double z = 0.0;
+    for (int i = 0; i < kFeatures; ++i) {
+        z += weights[i] * x[i];
+    }
+    return sigmoid(z);
+}
+
+void CompletionModel::observe(Priority priority, TaskDifficulty difficulty, const CompletionContext& context,
+                              bool completed) {
+    double x[kFeatures];
+    features(priority, difficulty, context, x);
+    double z = 0.0;
+    for (int i = 0; i < kFeatures; ++i) {
+        z += weights[i] * x[i];
+    }
+
+    double error = (completed ? 1.0 : 0.0) - sigmoid(z);
+    double rate = learningRate();
+    for (int i = 0; i < kFeatures; ++i) {
+        weights[i] += rate * (error * x[i] - kL2 * weights[i]);
+    }
+    examples++;
+}
+
+void CompletionModel::train(RecordSpan<Task> tasks, RecordSpan<MoodEntry> moods, int epochs) {
+    // Mood timeline, oldest first
+    std::vector<CompletionContext> timeline;
+    timeline.reserve(moods.size());
+    for (const auto& entry : moods) {
+        CompletionContext context;
+        context.mood = entry.mood;
+        context.sentiment = entry.sentimentScore;
+        context.when = entry.timestamp;
+        timeline.push_back(context);
+    }
+    std::sort(timeline.begin(), timeline.end(),
+              [](const CompletionContext& a, const CompletionContext& b) { return a.when < b.when; });
+
+    // Each completion with a recent enough mood becomes one training event
+    std::vector<std::pair<size_t, CompletionContext>> events;
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        const Task& task = tasks[i];
+        if (!task.completed || task.completed_time <= 0) continue;
+
+        auto after = std::upper_bound(timeline.begin(), timeline.end(), task.completed_time,
+                                      [](time_t when, const CompletionContext& c) { return when < c.when; });
+        if (after == timeline.begin()) continue;
+        CompletionContext context = *(after - 1);
+        if (task.completed_time - context.when > kContextWindow) continue;
+        context.when = task.completed_time;
+        events.emplace_back(i, context);
+    }
+    if (events.empty() || tasks.size() < 2) {
+        return;
+    }
+
+    for (int epoch = 0; epoch < epochs; ++epoch) {
+        std::shuffle(events.begin(), events.end(), rng);
+        for (const auto& event : events) {
+            const Task& done = tasks[event.first];
+            const CompletionContext& context = event.second;
+            observe(done.priority, done.difficulty, context, true);
+
+            // Negatives: tasks that were open at that moment but not the one picked
+            size_t found = 0;
+            for (size_t attempt = 0; attempt < 10 * kNegativesPerCompletion && found < kNegativesPerCompletion; ++attempt) {
+                const Task& other = tasks[rng() % tasks.size()];
+                bool openThen = other.created <= context.when &&
+                                (!other.completed || other.completed_time > context.when);
+                if (&other != &done && openThen) {
+                    observe(other.priority, other.difficulty, context, false);
+                    found++;
+                }
+            }
+        }
+    }
+    completions += events.size();
+}
+
+std::vector<std::pair<const RankedTask*, double>> CompletionModel::likeliest(const TaskRanker& ranker,
+                                                                             size_t k) const {
+    // Only nine task shapes exist, so score each shape once and let the ranker
+    // merge its shape heads by it; nothing else pending is looked at
+    CompletionContext context = currentContext();
+    double table[3][3];
+    for (int p = 0; p < 3; ++p) {
+        for (int d = 0; d < 3; ++d) {
+            table[p][d] = probability(static_cast<Priority>(p + 1), static_cast<TaskDifficulty>(d + 1), context);
+        }
+    }
+
+    std::vector<std::pair<const RankedTask*, double>> scored;
+    for (const RankedTask* task : ranker.top(k, table)) {
+        int p = clampLevel(static_cast<int>(task->priority)) - 1;
+        int d = clampLevel(static_cast<int>(task->difficulty)) - 1;
+        scored.emplace_back(task, table[p][d]);
+    }
+    return scored;
+}
+
+CompletionContext CompletionModel::currentContext() const {
+    CompletionContext context = latest;
+    context.when = time(nullptr);
+    return context;
+}
+
+void CompletionModel::addPending(int id, Priority priority, TaskDifficulty difficulty) {
+    auto slot = pendingSlots.find(id);
+    if (slot != pendingSlots.end()) {
+        pending[slot->second] = PendingTask{id, priority, difficulty};
+        return;
+    }
+    pendingSlots[id] = pending.size();
+    pending.push_back(PendingTask{id, priority, difficulty});
+}
+
+void CompletionModel::removePending(int id) {
+    auto slot = pendingSlots.find(id);
+    if (slot == pendingSlots.end()) {
+        return;
+    }
+    // Swap-remove keeps the array dense
+    size_t index = slot->second;
+    pending[index] = pending.back();
+    pendingSlots[pending[index].id] = index;
+    pending.pop_back();
+    pendingSlots.erase(id);
+}
+
+void CompletionModel::observeCompletion(const Task& task, const CompletionContext& context) {
+    // Called while the task is still in pending, so pending is never empty here
+    observe(task.priority, task.difficulty, context, true);
+    completions++;
+
+    size_t negatives = std::min(kNegativesPerCompletion, pending.size() - 1);
+    for (size_t attempt = 0, found = 0; found < negatives && attempt < 10 * kNegativesPerCompletion; ++attempt) {
+        const PendingTask& other = pending[rng() % pending.size()];
+        if (other.id == task.id) continue;
+        observe(other.priority, other.difficulty, context, false);
+        found++;
+    }
+}
+
+void CompletionModel::tasksLoaded(const std::vector<Task>& tasks) {
+    pending.clear();
+    pendingSlots.clear();
+    for (const auto& task : tasks) {
+        if (!task.completed) {
+            addPending(task.id, task.priority, task.difficulty);
+        }
+    }
+}
+
+void CompletionModel::taskSaved(const Task& task) {
+    if (!task.completed) {
+        addPending(task.id, task.priority, task.difficulty);
+        return;
+    }
+    // Learn only from the pending -> completed transition
+    if (pendingSlots.count(task.id)) {
+        CompletionContext context = latest;
+        context.when = task.completed_time > 0 ? task.completed_time : time(nullptr);
+        observeCompletion(task, context);
+        removePending(task.id);
+    }
+}
+
+void CompletionModel::taskRemoved(int taskId) {
+    removePending(taskId);
+}
+
+void CompletionModel::moodSaved(const MoodEntry& entry) {
+    if (entry.timestamp >= latest.when) {
+        latest.mood = entry.mood;
+        latest.sentiment = entry.sentimentScore;
+        latest.when = entry.timestamp;
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef COMPLETION_MODEL_H
+#define COMPLETION_MODEL_H
+
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Storage.h"
+#include "TaskRanker.h"
+
+// When and in what state the user is
+struct CompletionContext {
+    MoodLevel mood;
+    double sentiment;
+    time_t when;
+
+    CompletionContext() : mood(MoodLevel::NEUTRAL), sentiment(0.0), when(0) {}
+};
+
+// Online logistic regression predicting whether the user would finish a task
+// of a given difficulty and priority right now. Features are mood, sentiment,
+// difficulty, priority, mood band x difficulty, hour of day and weekday.
+//
+// Each completion is a positive example; a few tasks that were pending at the
+// same moment are negatives. Trained once from history, then one SGD step per
+// example as completions arrive through StorageListener.
+class CompletionModel : public StorageListener {
+public:
+    static const int kFeatures = 27;
+    static const size_t kNegativesPerCompletion = 3;
+    // Below this many completions the predictions are mostly the prior
+    static const uint64_t kMinCompletions = 5;
+
+    CompletionModel();
+
+    // Replays history: tasks.txt completions against the journal's moods
+    void train(RecordSpan<Task> tasks, RecordSpan<MoodEntry> moods, int epochs = 3);
+    // One SGD step
+    void observe(Priority priority, TaskDifficulty difficulty, const CompletionContext& context, bool completed);
+
+    double probability(Priority priority, TaskDifficulty difficulty, const CompletionContext& context) const;
+    // The k pending tasks likeliest to be finished under the current context,
+    // likeliest first; equally likely tasks keep the ranker's order
+    std::vector<std::pair<const RankedTask*, double>> likeliest(const TaskRanker& ranker, size_t k) const;
+
+    bool trained() const { return completions >= kMinCompletions; }
+    uint64_t completionsSeen() const { return completions; }
+    // Latest mood the model has heard about, stamped with the current time
+    CompletionContext currentContext() const;
+
+    // StorageListener
+    void tasksLoaded(const std::vector<Task>& tasks) override;
+    void taskSaved(const Task& task) override;
+    void taskRemoved(int taskId) override;
+    void moodSaved(const MoodEntry& entry) override;
+
+private:
+    struct PendingTask {
+        int id;
+        Priority priority;
+        TaskDifficulty difficulty;
+    };
+
+    double weights[kFeatures];
+    uint64_t examples;      // SGD steps taken; drives the learning rate
+    uint64_t completions;   // Distinct completions learned from
+    CompletionContext latest;
+    std::vector<PendingTask> pending;               // Dense, so negatives can be sampled by index
+    std::unordered_map<int, size_t> pendingSlots;   // id -> index in pending
+    std::mt19937 rng;
+
+    static void features(Priority priority, TaskDifficulty difficulty, const CompletionContext& context,
+                         double* out);
+    double learningRate() const;
+    void addPending(int id, Priority priority, TaskDifficulty difficulty);
+    void removePending(int id);
+    void observeCompletion(const Task& task, const CompletionContext& context);
+};
+
+#endif // COMPLETION_MODEL_H
@@ -0,0 +1,274 @@
+#include "CorrelationEngine.h"
+#include "LocalTime.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+namespace {
+
+const int64_t kSecondsPerDay = 24 * 60 * 60;
+// Timestamps further ahead than this are treated as corrupt and skipped
+const int64_t kFutureSlack = 366 * kSecondsPerDay;
+
+int64_t floorDiv(int64_t value, int64_t divisor) {
+    int64_t quotient = value / divisor;
+    return (value % divisor < 0) ? quotient - 1 : quotient;
+}
+
+std::string strengthLabel(double r) {
+    double size = std::fabs(r);
+    std::string label;
+    if (size < 0.1) return "no clear link";
+    if (size < 0.3) label = "weak";
+    else if (size < 0.5) label = "moderate";
+    else label = "strong";
+    return label + (r > 0 ? " positive" : " negative");
+}
+
+std::string formatLine(const std::string& name, const Correlation& result) {
+    std::ostringstream line;
+    line << name << ": ";
+    if (!result.meaningful()) {
+        line << "not enough data yet\n";
+        return line.str();
+    }
+    line << strengthLabel(result.pearson) << std::fixed << std::setprecision(2)
+         << " (r = " << result.pearson << ", rank r = " << result.spearman
+         << ", " << result.days << " days)\n";
+    return line.str();
+}
+
+} // namespace
+
+CorrelationEngine::CorrelationEngine()
+    : firstDay(0), horizon(0), moodRewrites(0), taskRewrites(0),
+      moodRows(0), taskRows(0), synced(false) {
+}
+
+CorrelationEngine::DayBucket* CorrelationEngine::bucketFor(int64_t timestamp) {
+    if (timestamp <= 0 || timestamp > horizon) {
+        return nullptr;
+    }
+
+    int64_t day = localDays.dayOf(timestamp);
+    if (days.empty()) {
+        firstDay = day;
+    }
+    if (day < firstDay) {
+        days.insert(days.begin(), static_cast<size_t>(firstDay - day), DayBucket());
+        firstDay = day;
+    }
+    size_t index = static_cast<size_t>(day - firstDay);
+    if (index >= days.size()) {
+        days.resize(index + 1, DayBucket());
+    }
+    return &days[index];
+}
+
+void CorrelationEngine::addMoodRows(const MoodColumns& moods, size_t from) {
+    for (size_t row = from; row < moods.size(); ++row) {
+        DayBucket* bucket = bucketFor(moods.timestamps[row]);
+        if (bucket) {
+            bucket->moodSum += moods.mood[row];
+            bucket->moodCount++;
+        }
+    }
+}
+
+void CorrelationEngine::addTaskRows(const TaskColumns& tasks, size_t from) {
+    for (size_t row = from; row < tasks.size(); ++row) {
+        addCompletion(tasks.completed[row], tasks.completedTime[row], tasks.difficulty[row], 1);
+    }
+}
+
+void CorrelationEngine::addCompletion(uint8_t completed, int64_t completedTime, uint8_t difficulty, int sign) {
+    if (!completed) {
+        return;
+    }
+    // Anything being taken back was counted under the same horizon, so its bucket exists
+    DayBucket* bucket = bucketFor(completedTime);
+    if (bucket) {
+        bucket->completions[0] += sign;
+        bucket->completions[difficulty & 3] += sign;
+    }
+}
+
+bool CorrelationEngine::replayTaskEdits(const TaskColumns& tasks) {
+    if (tasks.rewrites == taskRewrites) {
+        return true;
+    }
+    // The log has to reach back to the first edit not seen yet; clear() empties it
+    if (tasks.edits.empty() || tasks.edits.front().rewrite > taskRewrites + 1) {
+        return false;
+    }
+    for (const auto& edit : tasks.edits) {
+        // Rows past taskRows haven't been folded in; the append pass reads their current values
+        if (edit.rewrite <= taskRewrites || edit.row >= taskRows) {
+            continue;
+        }
+        addCompletion(edit.oldCompleted, edit.oldCompletedTime, edit.oldDifficulty, -1);
+        if (edit.erased) {
+            taskRows--;
+        } else {
+            addCompletion(edit.newCompleted, edit.newCompletedTime, edit.newDifficulty, 1);
+        }
+    }
+    taskRewrites = tasks.rewrites;
+    return true;
+}
+
+void CorrelationEngine::sync(const MoodColumns& moods, const TaskColumns& tasks) {
+    // The horizon moves a day at a time; rows it newly admits need a rebuild to be seen
+    int64_t latest = (floorDiv(static_cast<int64_t>(time(nullptr)), kSecondsPerDay) + 1) * kSecondsPerDay + kFutureSlack;
+    bool moved = latest != horizon;
+    horizon = latest;
+
+    // Appends are folded in and task edits replayed; any other change means rebuilding that side
+    bool rebuildMoods = !synced || moved || moods.rewrites != moodRewrites || moods.size() < moodRows;
+    bool rebuildTasks = !synced || moved || !replayTaskEdits(tasks) || tasks.size() < taskRows;
+
+    if (rebuildMoods && rebuildTasks) {
+        days.clear();
+    } else if (rebuildMoods || rebuildTasks) {
+        for (auto& bucket : days) {
+            if (rebuildMoods) {
+                bucket.moodSum = 0;
+                bucket.moodCount = 0;
+            } else {
+                std::fill(std::begin(bucket.completions), std::end(bucket.completions), 0);
+            }
+        }
+    }
+    if (rebuildMoods) moodRows = 0;
+    if (rebuildTasks) taskRows = 0;
+
+    addMoodRows(moods, moodRows);
+    addTaskRows(tasks, taskRows);
+
+    moodRows = moods.size();
+    taskRows = tasks.size();
+    moodRewrites = moods.rewrites;
+    taskRewrites = tasks.rewrites;
+    synced = true;
+}
+
+void CorrelationEngine::pairDays(time_t from, time_t to, int lagDays, int difficulty,
+                                 std::vector<double>& moodByDay, std::vector<double>& doneByDay) const {
+    moodByDay.clear();
+    doneByDay.clear();
+    if (days.empty() || to <= from) {
+        return;
+    }
+
+    int64_t lastDay = firstDay + static_cast<int64_t>(days.size()) - 1;
+    int64_t fromDay = std::max(LocalTime::dayOf(from), firstDay);
+    int64_t toDay = std::min(LocalTime::dayOf(static_cast<int64_t>(to) - 1), lastDay);
+    int column = (difficulty >= 1 && difficulty <= 3) ? difficulty : 0;
+
+    for (int64_t day = fromDay; day <= toDay; ++day) {
+        const DayBucket& bucket = days[static_cast<size_t>(day - firstDay)];
+        int64_t target = day + lagDays;
+        // Days whose outcome lies outside the recorded history carry no information
+        if (bucket.moodCount == 0 || target < firstDay || target > lastDay) {
+            continue;
+        }
+        moodByDay.push_back(static_cast<double>(bucket.moodSum) / bucket.moodCount);
+        doneByDay.push_back(days[static_cast<size_t>(target - firstDay)].completions[column]);
+    }
+}
+
+double CorrelationEngine::pearson(const std::vector<double>& x, const std::vector<double>& y) {
+    size_t n = x.size();
+    if (n < 2) {
+        return 0.0;
+    }
+
+    double meanX = std::accumulate(x.begin(), x.end(), 0.0) / n;
+    double meanY = std::accumulate(y.begin(), y.end(), 0.0) / n;
+    double covariance = 0.0, varianceX = 0.0, varianceY = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double dx = x[i] - meanX;
+        double dy = y[i] - meanY;
+        covariance += dx * dy;
+        varianceX += dx * dx;
+        varianceY += dy * dy;
+    }
+
+    // A constant series has no correlation with anything
+    if (varianceX == 0.0 || varianceY == 0.0) {
+        return 0.0;
+    }
+    return covariance / std::sqrt(varianceX * varianceY);
+}
+
+std::vector<double> CorrelationEngine::ranks(const std::vector<double>& values) {
+    std::vector<size_t> order(values.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&values](size_t a, size_t b) { return values[a] < values[b]; });
+
+    // Tied values share the average of the ranks they span
+    std::vector<double> result(values.size());
+    size_t start = 0;
+    while (start < order.size()) {
+        size_t end = start + 1;
+        while (end < order.size() && values[order[end]] == values[order[start]]) {
+            end++;
+        }
+        double rank = (start + end + 1) / 2.0;
+        for (size_t i = start; i < end; ++i) {
+            result[order[i]] = rank;
+        }
+        start = end;
+    }
+    return result;
+}
+
+Correlation CorrelationEngine::correlate(time_t from, time_t to, int lagDays, int difficulty) const {
+    std::vector<double> moodByDay, doneByDay;
+    pairDays(from, to, lagDays, difficulty, moodByDay, doneByDay);
+
+    Correlation result;
+    result.days = moodByDay.size();
+    result.lagDays = lagDays;
+    result.difficulty = difficulty;
+    result.pearson = pearson(moodByDay, doneByDay);
+    result.spearman = pearson(ranks(moodByDay), ranks(doneByDay));
+    return result;
+}
+
+std::vector<Correlation> CorrelationEngine::lagProfile(time_t from, time_t to, int maxLag, int difficulty) const {
+    std::vector<Correlation> profile;
+    for (int lag = 0; lag <= maxLag; ++lag) {
+        profile.push_back(correlate(from, to, lag, difficulty));
+    }
+    return profile;
+}
+
+std::string CorrelationEngine::describe(time_t from, time_t to) const {
+    Correlation sameDay = correlate(from, to, 0);
+    if (!sameDay.meaningful()) {
+        return "🔗 Log your mood on a few more days to see how it relates to your tasks.\n";
+    }
+    Correlation nextDay = correlate(from, to, 1);
+
+    long windowDays = static_cast<long>((to - from) / kSecondsPerDay);
+    std::string report = "\n🔗 Mood & Productivity Correlation (over " + std::to_string(windowDays) + " days):\n";
+    report += formatLine("Same day", sameDay);
+    report += formatLine("Next day", nextDay);
+    report += formatLine("Easy tasks", correlate(from, to, 0, 1));
+    report += formatLine("Medium tasks", correlate(from, to, 0, 2));
+    report += formatLine("Hard tasks", correlate(from, to, 0, 3));
+
+    if (nextDay.meaningful() && nextDay.pearson >= 0.3 && nextDay.pearson > sameDay.pearson + 0.1) {
+        report += "💡 A good mood seems to carry into the next day's work.\n";
+    } else if (sameDay.pearson >= 0.3) {
+        report += "💡 Your better mood days tend to be your most productive ones.\n";
+    } else if (sameDay.pearson <= -0.3) {
+        report += "💡 You get things done even on tough days - that's real resilience!\n";
+    } else {
+        report += "💡 Your productivity stays fairly steady whatever your mood.\n";
+    }
+    return report;
+}
@@ -0,0 +1,83 @@
+#ifndef CORRELATION_ENGINE_H
+#define CORRELATION_ENGINE_H
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+#include "LocalTime.h"
+#include "RecordColumns.h"
+
+// Correlation between a day's average mood and the tasks completed
+// lagDays later, over the days in a window that have a mood entry
+struct Correlation {
+    size_t days;        // Paired days the coefficients were computed from
+    double pearson;
+    double spearman;
+    int lagDays;
+    int difficulty;     // TaskDifficulty as 1..3, or 0 for all tasks
+
+    Correlation() : days(0), pearson(0.0), spearman(0.0), lagDays(0), difficulty(0) {}
+    bool meaningful() const { return days >= 3; }
+};
+
+// Joins mood entries and task completions into per-day buckets and answers
+// correlation queries over any window. sync() folds in appended rows and
+// replays task edits (see TaskRowEdit), so refreshing after a save or a
+// completion costs as much as the save did.
+class CorrelationEngine {
+public:
+    static const int kAllDifficulties = 0;
+
+    CorrelationEngine();
+
+    // Brings the day buckets up to date with the columns
+    void sync(const MoodColumns& moods, const TaskColumns& tasks);
+
+    // Window is [from, to); lagDays shifts completions forward in time
+    Correlation correlate(time_t from, time_t to, int lagDays = 0,
+                          int difficulty = kAllDifficulties) const;
+    std::vector<Correlation> lagProfile(time_t from, time_t to, int maxLag,
+                                        int difficulty = kAllDifficulties) const;
+
+    // Human-readable summary in the style of the other analyzer reports
+    std::string describe(time_t from, time_t to) const;
+
+    size_t dayCount() const { return days.size(); }
+
+private:
+    struct DayBucket {
+        uint32_t moodSum;
+        uint32_t moodCount;
+        uint32_t completions[4];    // [0] all tasks, [1..3] by difficulty
+
+        DayBucket() : moodSum(0), moodCount(0), completions{0, 0, 0, 0} {}
+    };
+
+    // Local day boundaries follow the offset in force at each timestamp, so DST
+    // doesn't shift completions into a neighbouring day
+    LocalTime::DayCache localDays;
+    int64_t firstDay;
+    std::vector<DayBucket> days;
+    int64_t horizon;                // Latest timestamp accepted; moving it means a rebuild
+
+    // What the buckets were last built from
+    uint64_t moodRewrites;
+    uint64_t taskRewrites;
+    size_t moodRows;
+    size_t taskRows;
+    bool synced;
+
+    DayBucket* bucketFor(int64_t timestamp);
+    void addMoodRows(const MoodColumns& moods, size_t from);
+    void addTaskRows(const TaskColumns& tasks, size_t from);
+    void addCompletion(uint8_t completed, int64_t completedTime, uint8_t difficulty, int sign);
+    bool replayTaskEdits(const TaskColumns& tasks);
+    void pairDays(time_t from, time_t to, int lagDays, int difficulty,
+                  std::vector<double>& moodByDay, std::vector<double>& doneByDay) const;
+
+    static double pearson(const std::vector<double>& x, const std::vector<double>& y);
+    static std::vector<double> ranks(const std::vector<double>& values);
+};
+
+#endif // CORRELATION_ENGINE_H
@@ -0,0 +1,242 @@
+#include "Daemon.h"
+#include "DaemonClient.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace {
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void requestStop(int) {
+    stopRequested = 1;
+}
+
+} // namespace
+
+Daemon::Daemon(Storage& storage, const std::string& socketPath)
+    : commands(storage), socketPath(socketPath), listenFd(-1), requests(0) {
+}
+
+#ifndef _WIN32
+
+Daemon::~Daemon() {
+    for (auto& connection : connections) {
+        close(connection.fd);
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+        unlink(socketPath.c_str());
+    }
+}
+
+bool Daemon::start() {
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: Socket path too long: " << socketPath << std::endl;
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    // A socket file nobody answers on is left over from a daemon that died
+    DaemonClient probe;
+    if (probe.connect(socketPath)) {
+        std::cerr << "Error: moodood is already running on " << socketPath << std::endl;
+        return false;
+    }
+    unlink(socketPath.c_str());
+
+    // Everything is loaded before the socket exists, so clients never see a cold daemon
+    commands.setResident();
+    std::string error;
+    if (!commands.warmUp(error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return false;
+    }
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        std::cerr << "Error: Could not create socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    // Only this user may talk to the daemon
+    mode_t previous = umask(0177);
+    int bound = bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    umask(previous);
+    if (bound != 0 || listen(listenFd, 64) != 0) {
+        std::cerr << "Error: Could not listen on " << socketPath << ": " << std::strerror(errno) << std::endl;
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    fcntl(listenFd, F_SETFL, fcntl(listenFd, F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+int Daemon::run() {
+    if (listenFd < 0) return 1;
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::vector<pollfd> descriptors;
+    time_t lastDump = time(nullptr);
+    while (!stopRequested) {
+        // Refresh the metrics file for scrapers even when idle
+        time_t now = time(nullptr);
+        if (now - lastDump >= kMetricsInterval) {
+            Metrics::dumpIfConfigured();
+            lastDump = now;
+        }
+        descriptors.clear();
+        descriptors.push_back({listenFd, POLLIN, 0});
+        for (const auto& connection : connections) {
+            short events = 0;
+            if (!connection.closing && connection.output.size() - connection.written < kMaxBuffered) events |= POLLIN;
+            if (connection.written < connection.output.size()) events |= POLLOUT;
+            descriptors.push_back({connection.fd, events, 0});
+        }
+        if (poll(descriptors.data(), descriptors.size(), kMetricsInterval * 1000) < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Error: poll failed: " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+
+        // Connections accepted below aren't in descriptors yet
+        size_t polled = connections.size();
+        std::vector<bool> drop(polled, false);
+        for (size_t i = 0; i < polled; ++i) {
+            short revents = descriptors[i + 1].revents;
+            Connection& connection = connections[i];
+            if ((revents & POLLOUT) && !writeTo(connection)) drop[i] = true;
+            if (!drop[i] && (revents & (POLLIN | POLLHUP | POLLERR)) && !connection.closing &&
+                !readFrom(connection)) {
+                drop[i] = true;
+            }
+            // Try to send at once; most responses fit the socket buffer
+            if (!drop[i] && connection.written < connection.output.size() && !writeTo(connection)) drop[i] = true;
+            if (connection.closing && connection.written == connection.output.size()) drop[i] = true;
+        }
+        for (size_t i = polled; i-- > 0;) {
+            if (drop[i]) {
+                close(connections[i].fd);
+                connections.erase(connections.begin() + static_cast<long>(i));
+            }
+        }
+        if (descriptors[0].revents & POLLIN) {
+            accept();
+        }
+    }
+    return 0;
+}
+
+void Daemon::accept() {
+    while (true) {
+        int fd = ::accept(listenFd, nullptr, nullptr);
+        if (fd < 0) return;     // EAGAIN: no more waiting
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+#ifdef SO_NOSIGPIPE
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+        connections.push_back({fd, std::string(), std::string(), 0, false});
+    }
+}
+
+bool Daemon::readFrom(Connection& connection) {
+    char buffer[64 * 1024];
+    ssize_t count = recv(connection.fd, buffer, sizeof(buffer), 0);
+    if (count < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    if (count == 0) {
+        // The peer is done sending; a last line without '\n' still counts
+        if (!connection.input.empty()) connection.input += '\n';
+        connection.closing = true;
+    } else {
+        connection.input.append(buffer, static_cast<size_t>(count));
+    }
+    serveLines(connection);
+    if (connection.input.size() > kMaxRequestLine) {
+        std::cerr << "Error: Dropping client with an oversized request" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void Daemon::serveLines(Connection& connection) {
+    size_t begin = 0;
+    size_t end;
+    while ((end = connection.input.find('\n', begin)) != std::string::npos) {
+        std::string line = connection.input.substr(begin, end - begin);
+        begin = end + 1;
+        MOODOO_TRACE_SCOPE("daemon", "request");
+        responses.str(std::string());
+        commands.runLine(line, responses);
+        connection.output += responses.str();
+        ++requests;
+    }
+    connection.input.erase(0, begin);
+}
+
+bool Daemon::writeTo(Connection& connection) {
+    while (connection.written < connection.output.size()) {
+        ssize_t count = send(connection.fd, connection.output.data() + connection.written,
+                             connection.output.size() - connection.written, MSG_NOSIGNAL);
+        if (count < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        connection.written += static_cast<size_t>(count);
+    }
+    connection.output.clear();
+    connection.written = 0;
+    return true;
+}
+
+#else
+
+Daemon::~Daemon() {
+}
+
+bool Daemon::start() {
+    std::cerr << "Error: moodood needs Unix domain sockets" << std::endl;
+    return false;
+}
+
+int Daemon::run() {
+    return 1;
+}
+
+void Daemon::accept() {
+}
+
+bool Daemon::readFrom(Connection&) {
+    return false;
+}
+
+bool Daemon::writeTo(Connection&) {
+    return false;
+}
+
+void Daemon::serveLines(Connection&) {
+}
+
+#endif
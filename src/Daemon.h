@@ -0,0 +1,62 @@
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Commands.h"
+#include "Storage.h"
+
+// moodood: keeps tasks, the journal and their indexes in memory and serves
+// the command language of Commands.h over a Unix domain socket.
+//
+// A request is one command line, exactly as `moodoo batch` reads them. Its
+// response is zero or more JSON row lines followed by one status line that
+// starts with {"ok":. Clients may pipeline any number of requests (write many
+// lines, then read); responses come back in request order.
+//
+// One thread runs everything around poll(), so requests never interleave and
+// the daemon is the only writer of the data files while it runs. A connection
+// whose unread responses pass kMaxBuffered isn't read from until it catches up.
+class Daemon {
+public:
+    static const size_t kMaxBuffered = 8 * 1024 * 1024;
+    static const size_t kMaxRequestLine = 1024 * 1024;
+    // Seconds between rewrites of $MOODOO_METRICS_FILE, see Metrics.h
+    static const int kMetricsInterval = 10;
+
+    Daemon(Storage& storage, const std::string& socketPath);
+    ~Daemon();
+
+    // Loads the data and binds the socket; false when another daemon is
+    // already listening or the socket can't be created
+    bool start();
+    // Serves until SIGINT or SIGTERM; returns the exit status
+    int run();
+
+    size_t requestsServed() const { return requests; }
+
+private:
+    struct Connection {
+        int fd;
+        std::string input;
+        std::string output;
+        size_t written;
+        bool closing;       // Peer finished sending; close once output is flushed
+    };
+
+    Commands commands;
+    std::string socketPath;
+    int listenFd;
+    std::vector<Connection> connections;
+    std::ostringstream responses;
+    size_t requests;
+
+    void accept();
+    // False when the connection should be dropped
+    bool readFrom(Connection& connection);
+    bool writeTo(Connection& connection);
+    void serveLines(Connection& connection);
+};
+
+#endif // DAEMON_H
@@ -0,0 +1,188 @@
+#include "DaemonClient.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace {
+
+bool isStatusLine(const std::string& line) {
+    return line.compare(0, 6, "{\"ok\":") == 0;
+}
+
+} // namespace
+
+DaemonClient::DaemonClient() : socketFd(-1) {
+}
+
+DaemonClient::~DaemonClient() {
+#ifndef _WIN32
+    if (socketFd >= 0) close(socketFd);
+#endif
+}
+
+std::string DaemonClient::defaultSocketPath() {
+    const char* path = std::getenv("MOODOO_SOCKET");
+    return (path && *path) ? path : "data/moodood.sock";
+}
+
+bool DaemonClient::running(const std::string& socketPath) {
+    DaemonClient probe;
+    return probe.connect(socketPath);
+}
+
+bool DaemonClient::call(const std::string& socketPath, const std::vector<std::string>& args, std::string& status) {
+    DaemonClient client;
+    if (!client.connect(socketPath)) return false;
+    std::ostringstream out;
+    client.forward({quote(args)}, out);
+    // The status line comes last
+    std::string text = out.str();
+    size_t end = text.find_last_not_of('\n');
+    if (end == std::string::npos) {
+        status = "{\"ok\":false,\"command\":\"\",\"error\":\"No answer from moodood\"}";
+        return true;
+    }
+    size_t begin = text.rfind('\n', end);
+    begin = begin == std::string::npos ? 0 : begin + 1;
+    status = text.substr(begin, end + 1 - begin);
+    return true;
+}
+
+bool DaemonClient::succeeded(const std::string& status) {
+    return status.compare(0, 10, "{\"ok\":true") == 0;
+}
+
+bool DaemonClient::numberField(const std::string& status, const char* name, long long& value) {
+    std::string key = std::string("\"") + name + "\":";
+    size_t at = status.find(key);
+    if (at == std::string::npos) return false;
+    const char* first = status.c_str() + at + key.size();
+    char* end = nullptr;
+    value = std::strtoll(first, &end, 10);
+    return end != first;
+}
+
+std::string DaemonClient::quote(const std::vector<std::string>& args) {
+    std::string line;
+    for (const auto& arg : args) {
+        if (!line.empty()) line += ' ';
+        line += '"';
+        for (char c : arg) {
+            if (c == '"' || c == '\\') line += '\\';
+            line += c;
+        }
+        line += '"';
+    }
+    return line;
+}
+
+#ifndef _WIN32
+
+bool DaemonClient::connect(const std::string& socketPath) {
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path)) return false;
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    socketFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (socketFd < 0) return false;
+#ifdef SO_NOSIGPIPE
+    int on = 1;
+    setsockopt(socketFd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+    if (::connect(socketFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(socketFd);
+        socketFd = -1;
+        return false;
+    }
+    return true;
+}
+
+int DaemonClient::forward(const std::vector<std::string>& lines, std::ostream& out) {
+    // Blank lines and comments get no response, so they aren't sent
+    std::string request;
+    size_t expected = 0;
+    for (const auto& line : lines) {
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') continue;
+        request += line;
+        request += '\n';
+        ++expected;
+    }
+    if (socketFd < 0) return 1;
+    fcntl(socketFd, F_SETFL, fcntl(socketFd, F_GETFL) | O_NONBLOCK);
+
+    // Write and read together: a long pipeline fills both directions at once
+    size_t sent = 0;
+    size_t answered = 0;
+    int status = 0;
+    std::string pending;
+    char buffer[64 * 1024];
+    while (answered < expected) {
+        pollfd descriptor{socketFd, static_cast<short>(POLLIN | (sent < request.size() ? POLLOUT : 0)), 0};
+        if (poll(&descriptor, 1, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (descriptor.revents & POLLOUT) {
+            ssize_t count = send(socketFd, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+            if (count > 0) sent += static_cast<size_t>(count);
+            else if (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) break;
+        }
+        if (descriptor.revents & (POLLIN | POLLHUP | POLLERR)) {
+            ssize_t count = recv(socketFd, buffer, sizeof(buffer), 0);
+            if (count == 0) break;
+            if (count < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) continue;
+                break;
+            }
+            pending.append(buffer, static_cast<size_t>(count));
+            size_t begin = 0;
+            size_t end;
+            while ((end = pending.find('\n', begin)) != std::string::npos) {
+                std::string line = pending.substr(begin, end - begin);
+                out << line << '\n';
+                if (isStatusLine(line)) {
+                    ++answered;
+                    if (line.compare(0, 11, "{\"ok\":false") == 0) status = 1;
+                }
+                begin = end + 1;
+            }
+            pending.erase(0, begin);
+        }
+    }
+    out.flush();
+    if (answered < expected) {
+        out << "{\"ok\":false,\"command\":\"\",\"error\":\"Lost connection to moodood\"}" << std::endl;
+        return 1;
+    }
+    return status;
+}
+
+#else
+
+bool DaemonClient::connect(const std::string& socketPath) {
+    (void)socketPath;
+    return false;   // No Unix sockets: every client runs its commands in-process
+}
+
+int DaemonClient::forward(const std::vector<std::string>& lines, std::ostream& out) {
+    (void)lines;
+    (void)out;
+    return 1;
+}
+
+#endif
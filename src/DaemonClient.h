@@ -0,0 +1,44 @@
+#ifndef DAEMON_CLIENT_H
+#define DAEMON_CLIENT_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Thin client for moodood (see Daemon.h). Sends command lines over the Unix
+// socket and copies the JSON responses back; when no daemon is listening the
+// caller runs the commands itself.
+class DaemonClient {
+public:
+    DaemonClient();
+    ~DaemonClient();
+
+    // $MOODOO_SOCKET, or data/moodood.sock next to the data files
+    static std::string defaultSocketPath();
+
+    // False when nothing is listening at socketPath
+    bool connect(const std::string& socketPath);
+
+    // Whether a daemon is listening; the probe connection is closed again
+    static bool running(const std::string& socketPath);
+
+    // Sends one command and keeps its status line (rows are dropped). False
+    // when nothing is listening; a dropped connection is a failed status.
+    // Storage sends its writes this way while moodood holds the data.
+    static bool call(const std::string& socketPath, const std::vector<std::string>& args, std::string& status);
+    static bool succeeded(const std::string& status);
+    // Integer field of a status line, e.g. the "id" of add-task
+    static bool numberField(const std::string& status, const char* name, long long& value);
+
+    // Pipelines every line and copies the responses to out until the daemon
+    // has answered them all. Returns 1 if any response was an error, like Commands.
+    int forward(const std::vector<std::string>& lines, std::ostream& out);
+
+    // One command line that splits back into args (see Commands::splitLine)
+    static std::string quote(const std::vector<std::string>& args);
+
+private:
+    int socketFd;
+};
+
+#endif // DAEMON_CLIENT_H
@@ -0,0 +1,63 @@
+#include "Keyword.h"
+#include <stdexcept>
+
+SymbolTable::SymbolTable() : chunks(new std::atomic<std::string*>[kMaxChunks]), count(0) {
+    for (size_t i = 0; i < kMaxChunks; ++i) {
+        chunks[i].store(nullptr, std::memory_order_relaxed);
+    }
+    intern(""); // Symbol 0
+}
+
+SymbolTable::~SymbolTable() {
+    for (size_t i = 0; i < kMaxChunks; ++i) {
+        delete[] chunks[i].load(std::memory_order_relaxed);
+    }
+}
+
+SymbolTable& SymbolTable::global() {
+    static SymbolTable table;
+    return table;
+}
+
+uint32_t SymbolTable::intern(std::string_view text) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(text);
+        if (it != ids.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto it = ids.find(text);
+    if (it != ids.end()) {
+        return it->second; // Another thread got there first
+    }
+
+    size_t chunk = count >> kChunkBits;
+    if (chunk >= kMaxChunks) {
+        throw std::length_error("SymbolTable is full");
+    }
+    std::string* names = chunks[chunk].load(std::memory_order_relaxed);
+    if (!names) {
+        names = new std::string[kChunkSize];
+        chunks[chunk].store(names, std::memory_order_release);
+    }
+
+    uint32_t symbol = count++;
+    std::string& stored = names[symbol & (kChunkSize - 1)];
+    stored.assign(text.data(), text.size());
+    ids.emplace(std::string_view(stored), symbol);
+    return symbol;
+}
+
+const std::string& SymbolTable::name(uint32_t symbol) const {
+    // Whoever handed out this id already saw the name written
+    std::string* names = chunks[symbol >> kChunkBits].load(std::memory_order_acquire);
+    return names[symbol & (kChunkSize - 1)];
+}
+
+size_t SymbolTable::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return count;
+}
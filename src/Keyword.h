@@ -0,0 +1,67 @@
+#ifndef KEYWORD_H
+#define KEYWORD_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Process-wide table of interned strings. Symbols are never removed, so a
+// symbol id stays valid (and its text stays at the same address) for the
+// lifetime of the process.
+class SymbolTable {
+private:
+    static const size_t kChunkBits = 10;
+    static const size_t kChunkSize = size_t(1) << kChunkBits;
+    static const size_t kMaxChunks = size_t(1) << 16;
+
+    // Names live in fixed-size chunks so lookups by id never need the lock
+    std::unique_ptr<std::atomic<std::string*>[]> chunks;
+    std::unordered_map<std::string_view, uint32_t> ids;
+    uint32_t count;
+    mutable std::shared_mutex mutex;
+
+    SymbolTable();
+
+public:
+    ~SymbolTable();
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    static SymbolTable& global();
+
+    uint32_t intern(std::string_view text);
+    const std::string& name(uint32_t symbol) const;
+    size_t size() const;
+};
+
+// A keyword stored as a 4-byte symbol id. Converts to and from std::string so
+// code that treats keywords as strings keeps working.
+class Keyword {
+private:
+    uint32_t symbol;
+
+public:
+    Keyword() : symbol(0) {}   // Symbol 0 is the empty string
+    Keyword(const std::string& text) : symbol(SymbolTable::global().intern(text)) {}
+    Keyword(const char* text) : symbol(SymbolTable::global().intern(text)) {}
+    explicit Keyword(std::string_view text) : symbol(SymbolTable::global().intern(text)) {}
+
+    const std::string& str() const { return SymbolTable::global().name(symbol); }
+    operator const std::string&() const { return str(); }
+    uint32_t id() const { return symbol; }
+    bool empty() const { return symbol == 0; }
+
+    friend bool operator==(const Keyword& a, const Keyword& b) { return a.symbol == b.symbol; }
+    friend bool operator!=(const Keyword& a, const Keyword& b) { return a.symbol != b.symbol; }
+    friend bool operator==(const Keyword& a, const std::string& b) { return a.str() == b; }
+    friend bool operator==(const std::string& a, const Keyword& b) { return a == b.str(); }
+    friend bool operator!=(const Keyword& a, const std::string& b) { return a.str() != b; }
+    friend bool operator!=(const std::string& a, const Keyword& b) { return a != b.str(); }
+};
+
+#endif // KEYWORD_H
@@ -0,0 +1,61 @@
+#include "LocalTime.h"
+
+namespace {
+
+const int64_t kSecondsPerDay = 24 * 60 * 60;
+
+int64_t floorDiv(int64_t value, int64_t divisor) {
+    int64_t quotient = value / divisor;
+    return (value % divisor < 0) ? quotient - 1 : quotient;
+}
+
+} // namespace
+
+std::tm LocalTime::local(time_t time) {
+    std::tm result{};
+#ifdef _WIN32
+    localtime_s(&result, &time);
+#else
+    localtime_r(&time, &result);
+#endif
+    return result;
+}
+
+std::tm LocalTime::utc(time_t time) {
+    std::tm result{};
+#ifdef _WIN32
+    gmtime_s(&result, &time);
+#else
+    gmtime_r(&time, &result);
+#endif
+    return result;
+}
+
+int64_t LocalTime::utcOffset(time_t when) {
+    // Read the UTC fields back as if they were local time; the difference is the offset
+    std::tm asUtc = utc(when);
+    asUtc.tm_isdst = -1;
+    return static_cast<int64_t>(when - std::mktime(&asUtc));
+}
+
+int64_t LocalTime::dayOf(int64_t timestamp) {
+    return floorDiv(timestamp + utcOffset(static_cast<time_t>(timestamp)), kSecondsPerDay);
+}
+
+int64_t LocalTime::DayCache::dayOf(int64_t timestamp) {
+    // A day whose two ends agree has one offset throughout
+    int64_t utcDay = floorDiv(timestamp, kSecondsPerDay);
+    auto found = offsetByUtcDay.find(utcDay);
+    if (found == offsetByUtcDay.end()) {
+        int64_t start = utcDay * kSecondsPerDay;
+        int64_t offset = utcOffset(static_cast<time_t>(start));
+        if (offset != utcOffset(static_cast<time_t>(start + kSecondsPerDay - 1))) {
+            offset = kOffsetVaries;
+        }
+        found = offsetByUtcDay.emplace(utcDay, offset).first;
+    }
+    if (found->second == kOffsetVaries) {
+        return LocalTime::dayOf(timestamp);
+    }
+    return floorDiv(timestamp + found->second, kSecondsPerDay);
+}
@@ -0,0 +1,39 @@
+#ifndef LOCAL_TIME_H
+#define LOCAL_TIME_H
+
+#include <cstdint>
+#include <ctime>
+#include <unordered_map>
+
+// Reentrant calendar conversions. std::localtime and std::gmtime hand back a
+// shared static buffer, which is a data race as soon as two threads use them.
+class LocalTime {
+public:
+    static std::tm local(time_t time);
+    static std::tm utc(time_t time);
+
+    // Seconds to add to a UTC timestamp to get local wall-clock time at `when`
+    static int64_t utcOffset(time_t when);
+
+    // Local calendar day (days since the epoch) of a timestamp, by the offset
+    // in force at that moment, so DST doesn't move it into a neighbouring day
+    static int64_t dayOf(int64_t timestamp);
+
+    // dayOf() for long runs of timestamps: offsets are looked up once per UTC
+    // day, and per timestamp only on the few days with a switch in them
+    class DayCache {
+    public:
+        int64_t dayOf(int64_t timestamp);
+
+    private:
+        static const int64_t kOffsetVaries = INT64_MIN;
+        std::unordered_map<int64_t, int64_t> offsetByUtcDay;
+    };
+
+    // Same local calendar day
+    static bool sameDay(const std::tm& a, const std::tm& b) {
+        return a.tm_mday == b.tm_mday && a.tm_mon == b.tm_mon && a.tm_year == b.tm_year;
+    }
+};
+
+#endif // LOCAL_TIME_H
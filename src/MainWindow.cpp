@@ -1,34 +1,90 @@
 #include "MainWindow.h"
+#include "MoodKernels.h"
 #include <QApplication>
 #include <QMenuBar>
 #include <QStatusBar>
 #include <QMessageBox>
 #include <QHBoxLayout>
 #include <QGroupBox>
+#include <QFileDialog>
+#include <QTimer>
+#include <limits>
 
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent)
+    : QMainWindow(parent), queries(&searchIndex), taskListPage(nullptr), moodHistoryPage(nullptr),
+      constructed(Trace::now()), warmUpScheduled(false)
 {
+    MOODOO_TRACE_SCOPE("startup", "MainWindow");
     setWindowTitle("MooDoo - Your Mood-Aware Planner");
     setMinimumSize(1000, 700);
     
     // Initialize storage
     storage = new Storage();
     
+    // The ranker, completion model and indexes follow every write from here on
+    storage->addListener(&ranker);
+    storage->addListener(&completionModel);
+    storage->addListener(&searchIndex);
+    storage->addListener(&queries);
+    
     setupUI();
     createMenuBar();
     
-    // Task list page will load tasks when needed
-    
-    // Set status bar
-    statusBar()->showMessage("Ready");
+    // Nothing is loaded before the first paint; last run's numbers stand in until warmUp()
+    StatsSummary summary;
+    if (storage->loadStatsSummary(summary)) {
+        showStatistics(summary);
+    }
+    statusBar()->showMessage("Loading your data...");
 }
 
 MainWindow::~MainWindow()
 {
+    // Move old journal history into compressed cold segments
+    storage->sealJournalSegments(time(nullptr) - Storage::kHotJournalAge);
+    // Next start maps these instead of parsing
+    storage->saveSnapshots();
+    Metrics::dumpIfConfigured();
+    Trace::dumpIfConfigured();
+    delete recommendationPanel; // Unregisters itself, so it must go before storage
     delete storage;
 }
 
+void MainWindow::showEvent(QShowEvent *event)
+{
+    QMainWindow::showEvent(event);
+    if (!warmUpScheduled) {
+        // Queued behind the first paint
+        warmUpScheduled = true;
+        QTimer::singleShot(0, this, &MainWindow::warmUp);
+    }
+}
+
+void MainWindow::warmUp()
+{
+    Trace::record("startup", "firstPaint", constructed, Trace::now());
+    MOODOO_TRACE_SCOPE("startup", "warmUp");
+    RecordSpan<Task> tasks;
+    storage->taskSpan(tasks);
+    
+    // Settle the trend detector and the current mood on recent history; sealed segments stay on disk
+    RecordSpan<MoodEntry> recentMoods;
+    if (storage->moodSpan(time(nullptr) - Storage::kHotJournalAge, recentMoods)) {
+        for (const auto& entry : recentMoods) {
+            trends.update(entry);
+            ranker.moodSaved(entry);
+            completionModel.moodSaved(entry);
+        }
+    }
+    completionModel.train(tasks, recentMoods);
+    
+    // Full history for the statistics goes in its own turn, so the suggestions show first
+    QTimer::singleShot(0, this, [this]() {
+        updateStatistics();
+        statusBar()->showMessage("Ready", 3000);
+    });
+}
+
 void MainWindow::setupUI()
 {
     // Create central widget and main layout
@@ -83,6 +139,10 @@ void MainWindow::setupUI()
     statsDisplay->setAlignment(Qt::AlignCenter);
     mainLayout->addWidget(statsDisplay);
     
+    // Mood-aware task suggestions, kept current by the ranker
+    recommendationPanel = new RecommendationPanel(storage, &ranker, &completionModel, this);
+    mainLayout->addWidget(recommendationPanel);
+    
     // Create buttons
     addTaskButton = new QPushButton("➕ Add New Task", this);
     addTaskButton->setStyleSheet(
@@ -168,12 +228,6 @@ void MainWindow::setupUI()
     // Add some spacing
     mainLayout->addSpacing(20);
     
-    // Create pages (hidden initially)
-    taskListPage = new TaskListPage(storage, this);
-    taskListPage->hide();
-    moodHistoryPage = new MoodHistoryPage(storage, this);
-    moodHistoryPage->hide();
-    
     // Add some spacing at the bottom
     mainLayout->addStretch();
     
@@ -182,9 +236,6 @@ void MainWindow::setupUI()
     connect(addMoodButton, &QPushButton::clicked, this, &MainWindow::onAddMoodClicked);
     connect(viewMoodHistoryButton, &QPushButton::clicked, this, &MainWindow::onViewMoodHistoryClicked);
     connect(viewTasksButton, &QPushButton::clicked, this, &MainWindow::onViewTasksClicked);
-    
-    // Update statistics initially
-    updateStatistics();
 }
 
 void MainWindow::createMenuBar()
@@ -198,6 +249,22 @@ void MainWindow::createMenuBar()
     
     // Help menu
     QMenu *helpMenu = menuBar->addMenu("&Help");
+    QAction *metricsAction = helpMenu->addAction("Internal &Metrics...");
+    connect(metricsAction, &QAction::triggered, [this]() {
+        MetricsDialog dialog(this);
+        dialog.exec();
+    });
+    if (Trace::kEnabled) {
+        // Only in builds with CONFIG+=tracing; see Trace.h
+        QAction *traceAction = helpMenu->addAction("Save &Trace...");
+        connect(traceAction, &QAction::triggered, [this]() {
+            QString path = QFileDialog::getSaveFileName(this, "Save Trace", "moodoo_trace.json",
+                                                        "Chrome trace (*.json)");
+            if (!path.isEmpty() && !Trace::save(path.toStdString())) {
+                QMessageBox::warning(this, "Error", "Could not write " + path);
+            }
+        });
+    }
     QAction *aboutAction = helpMenu->addAction("&About");
     connect(aboutAction, &QAction::triggered, [this]() {
         QMessageBox::about(this, "About MooDoo", 
@@ -229,59 +296,91 @@ void MainWindow::onAddMoodClicked()
     if (dialog.exec() == QDialog::Accepted) {
         statusBar()->showMessage("Mood entry logged successfully! 💚", 3000);
         updateStatistics();
+        
+        // Speak up as soon as this entry completes a sustained drop or shift
+        unsigned alerts = trends.update(dialog.savedEntry());
+        if (alerts != MoodTrendDetector::NONE) {
+            QMessageBox::information(this, "Checking In 💙",
+                                     QString::fromStdString(MoodTrendDetector::describe(alerts)).trimmed());
+        }
     }
 }
 
 void MainWindow::onViewTasksClicked()
 {
-    // Show task list page as a separate window
+    // Show task list page as a separate window; a new page loads the list itself
+    if (!taskListPage) {
+        taskListPage = new TaskListPage(storage, &queries, this);
+    } else {
+        taskListPage->refreshTaskList();
+    }
     taskListPage->show();
     taskListPage->raise();
-    taskListPage->refreshTaskList();
 }
 
 void MainWindow::onViewMoodHistoryClicked()
 {
-    // Show mood history page as a separate window
+    // Show mood history page as a separate window; a new page loads the list itself
+    if (!moodHistoryPage) {
+        moodHistoryPage = new MoodHistoryPage(storage, this);
+    } else {
+        moodHistoryPage->refreshMoodList();
+    }
     moodHistoryPage->show();
     moodHistoryPage->raise();
-    moodHistoryPage->refreshMoodList();
 }
 
 void MainWindow::updateStatistics()
 {
-    // Get task statistics
-    std::vector<Task> tasks;
-    int totalTasks = 0, completedTasks = 0, pendingTasks = 0;
-    if (storage->loadTasks(tasks)) {
-        totalTasks = tasks.size();
-        for (const auto& task : tasks) {
-            if (task.completed) {
-                completedTasks++;
-            } else {
-                pendingTasks++;
-            }
-        }
+    MOODOO_TRACE_SCOPE("ui", "updateStatistics");
+    StatsSummary summary;
+    summary.updated = time(nullptr);
+    
+    // Reloads refresh the columns; the records stay in Storage, which recycles them next time
+    RecordSpan<Task> tasks;
+    if (storage->taskSpan(tasks)) {
+        const TaskColumns& columns = storage->taskColumns();
+        summary.totalTasks = columns.size();
+        summary.completedTasks = MoodKernels::histogram(columns.completed.data(), columns.size()).counts[1];
     }
     
     // Get mood statistics
-    std::vector<MoodEntry> moods;
-    int totalMoods = 0;
-    if (storage->loadMoodEntries(moods)) {
-        totalMoods = moods.size();
+    RecordSpan<MoodEntry> moods;
+    if (storage->moodSpan(std::numeric_limits<time_t>::min(), moods)) {
+        summary.totalMoods = storage->moodColumns().size();
+    }
+    
+    // Mood/productivity link over the last 90 days; the sync only folds in new rows and edits
+    {
+        MOODOO_TRACE_SCOPE("analysis", "correlations");
+        correlations.sync(storage->moodColumns(), storage->taskColumns());
+        Correlation sameDay = correlations.correlate(summary.updated - 90 * 24 * 60 * 60, summary.updated + 1);
+        summary.hasCorrelation = sameDay.meaningful();
+        summary.moodTaskCorrelation = sameDay.pearson;
     }
     
+    showStatistics(summary);
+    // Shown at the next startup while the data loads
+    storage->saveStatsSummary(summary);
+}
+
+void MainWindow::showStatistics(const StatsSummary& summary)
+{
     // Create statistics text
     QString statsText = QString("📋 Tasks: %1 total (%2 pending, %3 completed)\n"
                                "💭 Moods: %4 entries logged")
-                               .arg(totalTasks)
-                               .arg(pendingTasks)
-                               .arg(completedTasks)
-                               .arg(totalMoods);
+                               .arg(summary.totalTasks)
+                               .arg(summary.totalTasks - summary.completedTasks)
+                               .arg(summary.completedTasks)
+                               .arg(summary.totalMoods);
+    if (summary.hasCorrelation) {
+        statsText += QString("\n🔗 Mood vs. completed tasks (90 days): r = %1")
+                         .arg(summary.moodTaskCorrelation, 0, 'f', 2);
+    }
     
     // Update the display
     QLabel *statsDisplay = findChild<QLabel*>("statsDisplay");
     if (statsDisplay) {
         statsDisplay->setText(statsText);
     }
-} 
\ No newline at end of file
+}
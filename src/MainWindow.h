@@ -9,8 +9,18 @@
 #include <QListWidget>
 #include <QPushButton>
 #include "Storage.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include "CorrelationEngine.h"
+#include "MoodTrendDetector.h"
+#include "TaskRanker.h"
+#include "CompletionModel.h"
+#include "SearchIndex.h"
+#include "QueryEngine.h"
+#include "RecommendationPanel.h"
 #include "AddTaskDialog.h"
 #include "MoodEntryDialog.h"
+#include "MetricsDialog.h"
 #include "MoodHistoryPage.h"
 #include "TaskListPage.h"
 
@@ -22,15 +32,20 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+protected:
+    void showEvent(QShowEvent *event) override;
+
 private slots:
     void onAddTaskClicked();
     void onAddMoodClicked();
     void onViewMoodHistoryClicked();
     void onViewTasksClicked();
+    void warmUp();
+    void updateStatistics();
 private:
     void setupUI();
     void createMenuBar();
-    void updateStatistics();
+    void showStatistics(const StatsSummary& summary);
     
     // UI elements
     QWidget *centralWidget;
@@ -40,13 +55,24 @@ private:
     QPushButton *addTaskButton;
     QPushButton *addMoodButton;
     QPushButton *viewTasksButton;
+    RecommendationPanel *recommendationPanel;
     
     // Storage
     Storage *storage;
+    CorrelationEngine correlations;
+    MoodTrendDetector trends;
+    TaskRanker ranker;
+    CompletionModel completionModel;
+    SearchIndex searchIndex;
+    QueryEngine queries;                // Reads searchIndex, so declared after it
     
-    // Pages
+    // Pages, created the first time they're opened
     TaskListPage *taskListPage;
     MoodHistoryPage *moodHistoryPage;
+    
+    // Startup: the window paints from the saved summary, then warmUp() loads the data
+    int64_t constructed;                // Trace::now() when the constructor began
+    bool warmUpScheduled;
 };
 
 #endif // MAINWINDOW_H 
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include "MessageCatalog.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+struct MessageDefinition {
+    MessageId id;
+    const char* text;
+};
+
+const char* const kKeys[] = {
+    "support.header",
+    "support.low",
+    "support.low.overwhelmed",
+    "support.low.tired",
+    "support.neutral",
+    "support.good",
+    "support.good.energized",
+    "support.closing",
+
+    "weekly.no_data",
+    "weekly.no_recent",
+    "weekly.header",
+    "weekly.avg.excellent",
+    "weekly.avg.good",
+    "weekly.avg.neutral",
+    "weekly.avg.low",
+    "weekly.completion",
+    "weekly.pattern.rhythm",
+    "weekly.pattern.challenging",
+    "weekly.pattern.helping",
+    "weekly.pattern.mixed",
+    "weekly.suggestions.header",
+    "weekly.suggest.self_care",
+    "weekly.suggest.smaller_steps",
+    "weekly.suggest.momentum",
+
+    "insights.header",
+    "insights.keywords",
+    "insights.sentiment.positive",
+    "insights.sentiment.negative",
+    "insights.sentiment.neutral",
+    "insights.energy",
+
+    "suggest.nothing_pending",
+    "suggest.likeliest"
+};
+
+static_assert(sizeof(kKeys) / sizeof(kKeys[0]) == static_cast<size_t>(MessageId::COUNT),
+              "every MessageId needs a key");
+
+// Built-in English; a repeated id is another variant
+const MessageDefinition kDefaults[] = {
+    {MessageId::SUPPORT_HEADER, "\n💙 MooDoo's Supportive Message:\n"},
+    {MessageId::SUPPORT_LOW, "I can see you're having a tough day. That's completely okay - we all have them! 💙\n"},
+    {MessageId::SUPPORT_LOW, "It's okay to not be okay. Remember, you don't have to be productive every single day.\n"},
+    {MessageId::SUPPORT_LOW, "I understand this feels hard right now. Let's take it one small step at a time.\n"},
+    {MessageId::SUPPORT_LOW, "You're doing better than you think. Even getting out of bed is an achievement on hard days.\n"},
+    {MessageId::SUPPORT_LOW_OVERWHELMED,
+     "I notice you're feeling overwhelmed. Let's break things down together.\n"
+     "What's one tiny thing you could do that would make you feel even slightly better?\n"},
+    {MessageId::SUPPORT_LOW_TIRED,
+     "It sounds like you're really tired. Rest is productive too!\n"
+     "Maybe today is a day for gentle self-care instead of pushing yourself.\n"},
+    {MessageId::SUPPORT_NEUTRAL, "You're in a balanced place today. That's actually really good!\n"},
+    {MessageId::SUPPORT_NEUTRAL, "Neutral is totally fine. Sometimes steady progress is the best kind.\n"},
+    {MessageId::SUPPORT_NEUTRAL, "How about we check in on your tasks and see what feels right for today?\n"},
+    {MessageId::SUPPORT_NEUTRAL, "You're doing great. Let's find something that feels good to work on.\n"},
+    {MessageId::SUPPORT_GOOD, "You're feeling great! This is a perfect time to tackle those important tasks! ✨\n"},
+    {MessageId::SUPPORT_GOOD, "Your positive energy is wonderful! Let's channel that into something productive.\n"},
+    {MessageId::SUPPORT_GOOD, "You're in a great headspace today. What would you like to accomplish?\n"},
+    {MessageId::SUPPORT_GOOD, "This is your moment! You've got the energy and motivation - let's make the most of it!\n"},
+    {MessageId::SUPPORT_GOOD_ENERGIZED,
+     "I love your energy! You're clearly in a great place to get things done.\n"
+     "This is the perfect time to tackle those challenging tasks you've been putting off!\n"},
+    {MessageId::SUPPORT_CLOSING,
+     "\nRemember: You're doing great, and it's okay to adjust your plans based on how you're feeling. 💙\n"},
+
+    {MessageId::WEEKLY_NO_DATA, "No mood data available. Add some mood entries to see patterns!"},
+    {MessageId::WEEKLY_NO_RECENT, "No mood data from the past week. Keep logging to see patterns!"},
+    {MessageId::WEEKLY_HEADER, "\n📊 Weekly Mood & Productivity Patterns:\n"},
+    {MessageId::WEEKLY_AVG_EXCELLENT, "💭 Average Mood: 😄 Excellent ({0:1}/5)\n"},
+    {MessageId::WEEKLY_AVG_GOOD, "💭 Average Mood: 😊 Good ({0:1}/5)\n"},
+    {MessageId::WEEKLY_AVG_NEUTRAL, "💭 Average Mood: 😐 Neutral ({0:1}/5)\n"},
+    {MessageId::WEEKLY_AVG_LOW, "💭 Average Mood: 😔 Low ({0:1}/5)\n"},
+    {MessageId::WEEKLY_COMPLETION, "✅ Task Completion: {0}/{1} ({2}%)\n"},
+    {MessageId::WEEKLY_PATTERN_RHYTHM, "💪 Pattern: You're in a great productive rhythm!\n"},
+    {MessageId::WEEKLY_PATTERN_CHALLENGING, "💙 Pattern: You're having a challenging week. That's okay!\n"},
+    {MessageId::WEEKLY_PATTERN_HELPING, "📈 Pattern: Good mood is helping your productivity!\n"},
+    {MessageId::WEEKLY_PATTERN_MIXED, "🔄 Pattern: Mixed week - you're adapting well!\n"},
+    {MessageId::WEEKLY_SUGGESTIONS_HEADER, "\n🎯 Suggestions:\n"},
+    {MessageId::WEEKLY_SUGGEST_SELF_CARE,
+     "   • Focus on self-care and gentle tasks\n"
+     "   • Remember: low productivity days are normal\n"},
+    {MessageId::WEEKLY_SUGGEST_SMALLER_STEPS,
+     "   • Try breaking big tasks into smaller steps\n"
+     "   • Your mood is good - channel that energy!\n"},
+    {MessageId::WEEKLY_SUGGEST_MOMENTUM, "   • You're doing great! Keep this momentum going\n"},
+
+    {MessageId::INSIGHTS_HEADER, "\n🔍 Detailed Mood Analysis:\n"},
+    {MessageId::INSIGHTS_KEYWORDS, "📝 Detected keywords: {0}\n"},
+    {MessageId::INSIGHTS_SENTIMENT_POSITIVE, "📊 Sentiment score: Positive ({0:2})\n"},
+    {MessageId::INSIGHTS_SENTIMENT_NEGATIVE, "📊 Sentiment score: Negative ({0:2})\n"},
+    {MessageId::INSIGHTS_SENTIMENT_NEUTRAL, "📊 Sentiment score: Neutral ({0:2})\n"},
+    {MessageId::INSIGHTS_ENERGY, "💡 Energy level detected in your entry. This helps us provide better task suggestions!\n"},
+
+    {MessageId::SUGGEST_NOTHING_PENDING,
+     "💡 Suggestion: Nothing pending right now. Maybe add one small thing you'd like to do today?"},
+    {MessageId::SUGGEST_LIKELIEST,
+     "💡 Suggestion: Moments like this are when you usually get things like '{0}' done ({1}% likely). "
+     "Maybe start there?"}
+};
+
+const MessageTemplate kEmpty;
+
+std::string unescape(const std::string& text) {
+    std::string result;
+    result.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\\' && i + 1 < text.size()) {
+            char next = text[++i];
+            result += next == 'n' ? '\n' : next;
+        } else {
+            result += text[i];
+        }
+    }
+    return result;
+}
+
+// Position of the first '|' that isn't escaped
+size_t findSeparator(const std::string& line) {
+    for (size_t i = 0; i < line.size(); ++i) {
+        if (line[i] == '\\') ++i;
+        else if (line[i] == '|') return i;
+    }
+    return std::string::npos;
+}
+
+} // namespace
+
+MessageCatalog::MessageCatalog() {
+    for (const auto& definition : kDefaults) {
+        messages[static_cast<size_t>(definition.id)].emplace_back(definition.text);
+    }
+}
+
+const MessageCatalog& MessageCatalog::global() {
+    static const MessageCatalog catalog = []() {
+        MessageCatalog loaded;
+        // English is the built-in text; en.txt is only a template to translate from
+        const char* language = std::getenv("MOODOO_LANG");
+        std::string name = (language && *language) ? language : "en";
+        if (name != "en") loaded.load("data/messages/" + name + ".txt");
+        return loaded;
+    }();
+    return catalog;
+}
+
+const char* MessageCatalog::keyOf(MessageId id) {
+    size_t index = static_cast<size_t>(id);
+    return index < static_cast<size_t>(MessageId::COUNT) ? kKeys[index] : "";
+}
+
+bool MessageCatalog::load(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;   // No catalog: the built-in text stays
+    }
+
+    bool replaced[static_cast<size_t>(MessageId::COUNT)] = {};
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+
+        size_t separator = findSeparator(line);
+        if (separator == std::string::npos) {
+            std::cerr << "Error: Malformed message at " << filename << ":" << lineNumber << std::endl;
+            continue;
+        }
+        std::string key = line.substr(0, separator);
+        size_t index = 0;
+        while (index < static_cast<size_t>(MessageId::COUNT) && key != kKeys[index]) ++index;
+        if (index == static_cast<size_t>(MessageId::COUNT)) {
+            std::cerr << "Error: Unknown message key '" << key << "' at " << filename << ":" << lineNumber
+                      << std::endl;
+            continue;
+        }
+
+        if (!replaced[index]) {
+            messages[index].clear();
+            replaced[index] = true;
+        }
+        messages[index].emplace_back(unescape(line.substr(separator + 1)));
+    }
+    return true;
+}
+
+const MessageTemplate& MessageCatalog::get(MessageId id, size_t variant) const {
+    size_t index = static_cast<size_t>(id);
+    if (index >= static_cast<size_t>(MessageId::COUNT) || messages[index].empty()) {
+        return kEmpty;
+    }
+    const std::vector<MessageTemplate>& variants = messages[index];
+    return variants[variant < variants.size() ? variant : 0];
+}
+
+size_t MessageCatalog::variantCount(MessageId id) const {
+    size_t index = static_cast<size_t>(id);
+    return index < static_cast<size_t>(MessageId::COUNT) ? messages[index].size() : 0;
+}
@@ -0,0 +1,79 @@
+#ifndef MESSAGE_CATALOG_H
+#define MESSAGE_CATALOG_H
+
+#include <string>
+#include <vector>
+#include "MessageTemplate.h"
+
+// Every message MoodAnalyzer renders. Looked up by id so rendering never
+// touches a string key.
+enum class MessageId {
+    SUPPORT_HEADER,
+    SUPPORT_LOW,
+    SUPPORT_LOW_OVERWHELMED,
+    SUPPORT_LOW_TIRED,
+    SUPPORT_NEUTRAL,
+    SUPPORT_GOOD,
+    SUPPORT_GOOD_ENERGIZED,
+    SUPPORT_CLOSING,
+
+    WEEKLY_NO_DATA,
+    WEEKLY_NO_RECENT,
+    WEEKLY_HEADER,
+    WEEKLY_AVG_EXCELLENT,
+    WEEKLY_AVG_GOOD,
+    WEEKLY_AVG_NEUTRAL,
+    WEEKLY_AVG_LOW,
+    WEEKLY_COMPLETION,
+    WEEKLY_PATTERN_RHYTHM,
+    WEEKLY_PATTERN_CHALLENGING,
+    WEEKLY_PATTERN_HELPING,
+    WEEKLY_PATTERN_MIXED,
+    WEEKLY_SUGGESTIONS_HEADER,
+    WEEKLY_SUGGEST_SELF_CARE,
+    WEEKLY_SUGGEST_SMALLER_STEPS,
+    WEEKLY_SUGGEST_MOMENTUM,
+
+    INSIGHTS_HEADER,
+    INSIGHTS_KEYWORDS,
+    INSIGHTS_SENTIMENT_POSITIVE,
+    INSIGHTS_SENTIMENT_NEGATIVE,
+    INSIGHTS_SENTIMENT_NEUTRAL,
+    INSIGHTS_ENERGY,
+
+    SUGGEST_NOTHING_PENDING,
+    SUGGEST_LIKELIEST,
+
+    COUNT
+};
+
+// Message templates keyed by MessageId. Starts with the built-in English text;
+// load() overlays a catalog file:
+//
+//   # comment
+//   support.low|It's okay to not be okay.\n
+//   support.low|Let's take it one small step at a time.\n
+//
+// Repeating a key adds a variant (one is picked at random where the analyzer
+// has several). The first line for a key in a file replaces the built-in
+// variants, so a translation never mixes languages. \n, \| and \\ are escapes.
+class MessageCatalog {
+public:
+    MessageCatalog();
+
+    // Built-in text, overlaid with data/messages/<MOODOO_LANG>.txt for any
+    // language but "en" (the default)
+    static const MessageCatalog& global();
+
+    bool load(const std::string& filename);
+
+    const MessageTemplate& get(MessageId id, size_t variant = 0) const;
+    size_t variantCount(MessageId id) const;
+
+    static const char* keyOf(MessageId id);
+
+private:
+    std::vector<MessageTemplate> messages[static_cast<size_t>(MessageId::COUNT)];
+};
+
+#endif // MESSAGE_CATALOG_H
@@ -0,0 +1,132 @@
+#include "MessageTemplate.h"
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+const int kDefaultPrecision = 1;
+const int kMaxPrecision = 6;
+
+void appendInteger(std::string& out, int64_t value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+// Fixed-point through integer to_chars: floating-point to_chars is missing from
+// some of the standard libraries we build against
+void appendFixed(std::string& out, double value, int precision) {
+    static const int64_t scales[kMaxPrecision + 1] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+    precision = std::min(std::max(precision, 0), kMaxPrecision);
+
+    double scaled = std::round(std::fabs(value) * scales[precision]);
+    if (!std::isfinite(scaled) || scaled >= 9.0e18) {
+        char buffer[64];
+        int length = std::snprintf(buffer, sizeof(buffer), "%.*f", precision, value);
+        out.append(buffer, static_cast<size_t>(std::max(length, 0)));
+        return;
+    }
+
+    int64_t units = static_cast<int64_t>(scaled);
+    if (value < 0 && units != 0) {
+        out += '-';
+    }
+    appendInteger(out, units / scales[precision]);
+    if (precision > 0) {
+        char fraction[8];
+        int64_t rest = units % scales[precision];
+        for (int i = precision - 1; i >= 0; --i) {
+            fraction[i] = static_cast<char>('0' + rest % 10);
+            rest /= 10;
+        }
+        out += '.';
+        out.append(fraction, static_cast<size_t>(precision));
+    }
+}
+
+} // namespace
+
+void MessageArg::appendTo(std::string& out, int precision) const {
+    switch (kind) {
+        case Kind::INTEGER:
+            appendInteger(out, integer);
+            break;
+        case Kind::DECIMAL:
+            appendFixed(out, decimal, precision < 0 ? kDefaultPrecision : precision);
+            break;
+        case Kind::TEXT:
+            out.append(text.data(), text.size());
+            break;
+        case Kind::KEYWORDS:
+            for (size_t i = 0; i < keywords->size(); ++i) {
+                if (i > 0) out += ", ";
+                out += (*keywords)[i].str();
+            }
+            break;
+    }
+}
+
+MessageTemplate::MessageTemplate(std::string_view source) {
+    text.reserve(source.size());
+    size_t literalStart = 0;
+
+    auto closeLiteral = [&]() {
+        if (text.size() > literalStart) {
+            tokens.push_back(Token{static_cast<uint32_t>(literalStart),
+                                   static_cast<uint32_t>(text.size() - literalStart), -1, -1});
+        }
+        literalStart = text.size();
+    };
+
+    size_t i = 0;
+    while (i < source.size()) {
+        char c = source[i];
+        if ((c == '{' || c == '}') && i + 1 < source.size() && source[i + 1] == c) {
+            text += c;
+            i += 2;
+            continue;
+        }
+        if (c == '{') {
+            // {index} or {index:precision}; anything else stays literal
+            size_t close = source.find('}', i);
+            if (close != std::string_view::npos) {
+                std::string_view body = source.substr(i + 1, close - i - 1);
+                std::string_view indexText = body.substr(0, body.find(':'));
+                int index = -1;
+                int precision = -1;
+                auto parsed = std::from_chars(indexText.data(), indexText.data() + indexText.size(), index);
+                bool ok = parsed.ec == std::errc() && parsed.ptr == indexText.data() + indexText.size() &&
+                          index >= 0 && index < 64;
+                if (ok && indexText.size() < body.size()) {
+                    std::string_view precisionText = body.substr(indexText.size() + 1);
+                    auto parsedPrecision = std::from_chars(precisionText.data(),
+                                                           precisionText.data() + precisionText.size(), precision);
+                    ok = parsedPrecision.ec == std::errc() &&
+                         parsedPrecision.ptr == precisionText.data() + precisionText.size();
+                }
+                if (ok) {
+                    closeLiteral();
+                    tokens.push_back(Token{0, 0, static_cast<int16_t>(index), static_cast<int16_t>(precision)});
+                    arguments = std::max(arguments, static_cast<size_t>(index) + 1);
+                    i = close + 1;
+                    continue;
+                }
+            }
+        }
+        text += c;
+        ++i;
+    }
+    closeLiteral();
+}
+
+void MessageTemplate::render(std::string& out, const MessageArg* args, size_t count) const {
+    for (const Token& token : tokens) {
+        if (token.argument < 0) {
+            out.append(text, token.offset, token.length);
+        } else if (static_cast<size_t>(token.argument) < count) {
+            args[token.argument].appendTo(out, token.precision);
+        }
+        // Missing arguments render as nothing rather than failing the message
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef MESSAGE_TEMPLATE_H
+#define MESSAGE_TEMPLATE_H
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "Keyword.h"
+
+// One value substituted into a template. Holds views, so it must not outlive
+// the data it was built from (in practice: build it in the render() call).
+class MessageArg {
+public:
+    enum class Kind { INTEGER, DECIMAL, TEXT, KEYWORDS };
+
+    template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+    MessageArg(T value) : kind(Kind::INTEGER), integer(static_cast<int64_t>(value)) {}
+    MessageArg(double value) : kind(Kind::DECIMAL), decimal(value) {}
+    MessageArg(const char* value) : kind(Kind::TEXT), text(value) {}
+    MessageArg(const std::string& value) : kind(Kind::TEXT), text(value) {}
+    MessageArg(std::string_view value) : kind(Kind::TEXT), text(value) {}
+    MessageArg(const std::vector<Keyword>& value) : kind(Kind::KEYWORDS), keywords(&value) {}   // Joined with ", "
+
+    void appendTo(std::string& out, int precision) const;
+
+private:
+    Kind kind;
+    union {
+        int64_t integer;
+        double decimal;
+        std::string_view text;
+        const std::vector<Keyword>* keywords;
+    };
+};
+
+// A message parsed once into literal runs and placeholders.
+//   {0}, {1}, ...   positional argument
+//   {0:2}           decimal argument with 2 digits after the point (default 1)
+//   {{ and }}       literal braces
+// render() appends to a caller-owned buffer; once the buffer has grown to fit,
+// rendering allocates nothing.
+class MessageTemplate {
+public:
+    MessageTemplate() = default;
+    explicit MessageTemplate(std::string_view source);
+
+    void render(std::string& out, const MessageArg* args, size_t count) const;
+    void render(std::string& out, std::initializer_list<MessageArg> args = {}) const {
+        render(out, args.begin(), args.size());
+    }
+
+    size_t argumentCount() const { return arguments; }
+
+private:
+    struct Token {
+        uint32_t offset;    // Literal: range in text
+        uint32_t length;
+        int16_t argument;   // -1 for a literal
+        int16_t precision;  // -1 when not given
+    };
+
+    std::string text;
+    std::vector<Token> tokens;
+    size_t arguments = 0;
+};
+
+#endif // MESSAGE_TEMPLATE_H
@@ -0,0 +1,282 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+// Timed on calls where (count & mask) == 0
+const uint32_t kSampleMasks[Metrics::TIMER_COUNT] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,     // Storage: file I/O dwarfs the clock
+    63, 63, 63, 63, 0, 0, 0, 0, 63          // Analyzer: only whole-history scans every time
+};
+
+const char* const kCounterNames[Metrics::COUNTER_COUNT] = {
+    "storage_bytes_read", "storage_bytes_written", "storage_tasks_parsed", "storage_moods_parsed",
+    "storage_task_file_rewrites", "storage_journal_rewrites", "storage_segments_read",
+    "storage_segments_written", "storage_snapshot_records", "storage_snapshots_written"
+};
+
+const char* const kTimerNames[Metrics::TIMER_COUNT] = {
+    "storage_load_tasks", "storage_save_task", "storage_update_task", "storage_delete_task",
+    "storage_load_moods", "storage_load_recent_moods", "storage_save_mood", "storage_update_mood",
+    "storage_delete_mood", "storage_seal_segments", "storage_backup", "storage_restore",
+    "analyzer_analyze_entry", "analyzer_extract_keywords", "analyzer_sentiment_score",
+    "analyzer_supportive_message", "analyzer_task_suggestion", "analyzer_task_recommendations",
+    "analyzer_weekly_patterns", "analyzer_mood_trend", "analyzer_detailed_insights"
+};
+
+// One thread's numbers. Only the owning thread writes, so relaxed load+store
+// is enough and readers may see a slightly stale but never torn value.
+struct ThreadBlock {
+    std::atomic<uint64_t> counters[Metrics::COUNTER_COUNT];
+    std::atomic<uint64_t> calls[Metrics::TIMER_COUNT];
+    std::atomic<uint64_t> totals[Metrics::TIMER_COUNT];
+    std::atomic<uint64_t> buckets[Metrics::TIMER_COUNT][Metrics::kBuckets];
+    uint32_t active;        // Timers currently open on the owning thread
+    bool inUse;
+
+    ThreadBlock() : active(0), inUse(true) {
+        for (auto& value : counters) value.store(0, std::memory_order_relaxed);
+        for (auto& value : calls) value.store(0, std::memory_order_relaxed);
+        for (auto& value : totals) value.store(0, std::memory_order_relaxed);
+        for (auto& row : buckets) {
+            for (auto& value : row) value.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+static_assert(Metrics::TIMER_COUNT <= 32, "ThreadBlock::active holds one bit per timer");
+
+int highestBit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(value);
+#else
+    int bit = 0;
+    while (value >>= 1) ++bit;
+    return bit;
+#endif
+}
+
+inline void bump(std::atomic<uint64_t>& value, uint64_t amount) {
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+// Blocks live until exit; a thread that ends hands its block, totals and all,
+// to the next new thread, so short-lived threads don't grow the list
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBlock>> blocks;
+
+    static Registry& instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    ThreadBlock* acquire() {
+        std::lock_guard<std::mutex> guard(mutex);
+        for (auto& block : blocks) {
+            if (!block->inUse) {
+                block->inUse = true;
+                return block.get();
+            }
+        }
+        blocks.push_back(std::make_unique<ThreadBlock>());
+        return blocks.back().get();
+    }
+
+    void release(ThreadBlock* block) {
+        std::lock_guard<std::mutex> guard(mutex);
+        block->inUse = false;
+    }
+};
+
+struct ThreadSlot {
+    ThreadBlock* block;
+    ThreadSlot() : block(Registry::instance().acquire()) {}
+    ~ThreadSlot() { Registry::instance().release(block); }
+};
+
+// The plain pointer is a cheap TLS read; the slot's guarded construction
+// only runs on a thread's first use
+ThreadBlock& localBlock() {
+    thread_local ThreadBlock* block = nullptr;
+    if (!block) {
+        thread_local ThreadSlot slot;
+        block = slot.block;
+    }
+    return *block;
+}
+
+bool enabledAtStartup() {
+    const char* setting = std::getenv("MOODOO_METRICS");
+    return !(setting && std::string(setting) == "0");
+}
+
+std::atomic<bool> recording(enabledAtStartup());
+
+} // namespace
+
+bool Metrics::enabled() {
+    return recording.load(std::memory_order_relaxed);
+}
+
+void Metrics::setEnabled(bool on) {
+    recording.store(on, std::memory_order_relaxed);
+}
+
+void Metrics::add(Counter counter, uint64_t amount) {
+    if (!enabled()) return;
+    bump(localBlock().counters[counter], amount);
+}
+
+bool Metrics::enter(Timer timer, bool& timed) {
+    timed = false;
+    if (!enabled()) return false;
+    ThreadBlock& block = localBlock();
+    uint32_t bit = uint32_t(1) << timer;
+    if (block.active & bit) return false;
+    block.active |= bit;
+    uint64_t count = block.calls[timer].load(std::memory_order_relaxed);
+    block.calls[timer].store(count + 1, std::memory_order_relaxed);
+    timed = (count & kSampleMasks[timer]) == 0;
+    return true;
+}
+
+void Metrics::leave(Timer timer, bool timed, uint64_t nanos) {
+    ThreadBlock& block = localBlock();
+    block.active &= ~(uint32_t(1) << timer);
+    if (timed) {
+        bump(block.totals[timer], nanos);
+        bump(block.buckets[timer][bucketOf(nanos)], 1);
+    }
+}
+
+size_t Metrics::bucketOf(uint64_t nanos) {
+    const uint64_t subBuckets = 1u << kSubBucketBits;
+    if (nanos < subBuckets) return static_cast<size_t>(nanos);
+    int exponent = highestBit(nanos);
+    if (exponent > kMaxExponent) return kBuckets - 1;
+    // Top kSubBucketBits bits below the leading one pick the sub-bucket
+    uint64_t sub = (nanos >> (exponent - kSubBucketBits)) & (subBuckets - 1);
+    return static_cast<size_t>(((exponent - kSubBucketBits + 1) << kSubBucketBits) + sub);
+}
+
+uint64_t Metrics::bucketUpperBound(size_t bucket) {
+    const size_t subBuckets = size_t(1) << kSubBucketBits;
+    if (bucket < subBuckets) return bucket;
+    int exponent = static_cast<int>(bucket >> kSubBucketBits) + kSubBucketBits - 1;
+    uint64_t sub = bucket & (subBuckets - 1);
+    uint64_t low = (uint64_t(1) << exponent) + (sub << (exponent - kSubBucketBits));
+    return low + (uint64_t(1) << (exponent - kSubBucketBits)) - 1;
+}
+
+uint64_t Metrics::TimerSnapshot::percentile(double q) const {
+    if (samples == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(samples) + 0.999999);
+    rank = std::min(std::max<uint64_t>(rank, 1), samples);
+    uint64_t seen = 0;
+    for (size_t b = 0; b < buckets.size(); ++b) {
+        seen += buckets[b];
+        if (seen >= rank) return bucketUpperBound(b);
+    }
+    return bucketUpperBound(buckets.size() - 1);
+}
+
+uint64_t Metrics::TimerSnapshot::maxNanos() const {
+    for (size_t b = buckets.size(); b-- > 0;) {
+        if (buckets[b]) return bucketUpperBound(b);
+    }
+    return 0;
+}
+
+Metrics::Snapshot Metrics::snapshot() {
+    Snapshot result;
+    result.counters.assign(COUNTER_COUNT, 0);
+    result.timers.resize(TIMER_COUNT);
+    for (int t = 0; t < TIMER_COUNT; ++t) {
+        result.timers[t].timer = static_cast<Timer>(t);
+        result.timers[t].buckets.assign(kBuckets, 0);
+    }
+
+    Registry& registry = Registry::instance();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+    for (const auto& block : registry.blocks) {
+        for (int c = 0; c < COUNTER_COUNT; ++c) {
+            result.counters[c] += block->counters[c].load(std::memory_order_relaxed);
+        }
+        for (int t = 0; t < TIMER_COUNT; ++t) {
+            TimerSnapshot& timer = result.timers[t];
+            timer.calls += block->calls[t].load(std::memory_order_relaxed);
+            timer.totalNanos += block->totals[t].load(std::memory_order_relaxed);
+            for (size_t b = 0; b < kBuckets; ++b) {
+                uint64_t count = block->buckets[t][b].load(std::memory_order_relaxed);
+                timer.buckets[b] += count;
+                timer.samples += count;
+            }
+        }
+    }
+    return result;
+}
+
+const char* Metrics::counterName(Counter counter) {
+    return counter < COUNTER_COUNT ? kCounterNames[counter] : "?";
+}
+
+const char* Metrics::timerName(Timer timer) {
+    return timer < TIMER_COUNT ? kTimerNames[timer] : "?";
+}
+
+void Metrics::writePrometheus(std::ostream& out) {
+    Snapshot snap = snapshot();
+
+    for (int c = 0; c < COUNTER_COUNT; ++c) {
+        const char* name = counterName(static_cast<Counter>(c));
+        out << "# TYPE moodoo_" << name << "_total counter\n"
+            << "moodoo_" << name << "_total " << snap.counters[c] << "\n";
+    }
+
+    out << "# HELP moodoo_calls_total Calls of each instrumented operation\n"
+           "# TYPE moodoo_calls_total counter\n";
+    for (const auto& timer : snap.timers) {
+        out << "moodoo_calls_total{op=\"" << timerName(timer.timer) << "\"} " << timer.calls << "\n";
+    }
+
+    // The fine buckets are folded into powers of four from 1us to about 17 minutes
+    out << "# HELP moodoo_operation_seconds Latency of the timed calls of each operation\n"
+           "# TYPE moodoo_operation_seconds histogram\n";
+    for (const auto& timer : snap.timers) {
+        const char* name = timerName(timer.timer);
+        uint64_t cumulative = 0;
+        size_t b = 0;
+        for (uint64_t bound = 1000; bound <= (uint64_t(1) << kMaxExponent); bound *= 4) {
+            while (b < timer.buckets.size() && bucketUpperBound(b) <= bound) cumulative += timer.buckets[b++];
+            out << "moodoo_operation_seconds_bucket{op=\"" << name << "\",le=\"" << bound / 1e9 << "\"} "
+                << cumulative << "\n";
+        }
+        out << "moodoo_operation_seconds_bucket{op=\"" << name << "\",le=\"+Inf\"} " << timer.samples << "\n"
+            << "moodoo_operation_seconds_sum{op=\"" << name << "\"} " << timer.totalNanos / 1e9 << "\n"
+            << "moodoo_operation_seconds_count{op=\"" << name << "\"} " << timer.samples << "\n";
+    }
+}
+
+bool Metrics::dumpIfConfigured() {
+    const char* path = std::getenv("MOODOO_METRICS_FILE");
+    if (!path || !*path) return true;
+    // Write aside and rename, so a scraper never reads half a file
+    std::string temporary = std::string(path) + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not write metrics to " << temporary << std::endl;
+            return false;
+        }
+        writePrometheus(file);
+        if (!file) return false;
+    }
+    return std::rename(temporary.c_str(), path) == 0;
+}
@@ -0,0 +1,144 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Trace.h"
+
+// Process-wide counters and latency histograms for the Storage and
+// MoodAnalyzer hot paths.
+//
+// Each thread writes only its own block of relaxed atomics, so recording is a
+// plain load and store with no locking or shared cache lines; snapshot() sums
+// the blocks. Histograms are log-linear (HDR style): 8 sub-buckets per power
+// of two, so any percentile is within 12.5% of the true value.
+//
+// Cheap calls (analyzer helpers that run in about a microsecond) are timed on
+// one call in 64 per thread and counted on every call, which keeps the clock
+// reads well under 1% of their cost. Set MOODOO_METRICS=0 to turn recording off.
+class Metrics {
+public:
+    enum Counter {
+        BYTES_READ,
+        BYTES_WRITTEN,
+        TASKS_PARSED,
+        MOODS_PARSED,
+        TASK_FILE_REWRITES,
+        JOURNAL_REWRITES,
+        SEGMENTS_READ,
+        SEGMENTS_WRITTEN,
+        SNAPSHOT_RECORDS,       // Served from a warm-start snapshot instead of parsed
+        SNAPSHOTS_WRITTEN,
+        COUNTER_COUNT
+    };
+
+    enum Timer {
+        LOAD_TASKS,
+        SAVE_TASK,
+        UPDATE_TASK,
+        DELETE_TASK,
+        LOAD_MOODS,
+        LOAD_RECENT_MOODS,
+        SAVE_MOOD,
+        UPDATE_MOOD,
+        DELETE_MOOD,
+        SEAL_SEGMENTS,
+        BACKUP,
+        RESTORE,
+        ANALYZE_ENTRY,          // First analyzer timer; the ones above are Storage
+        EXTRACT_KEYWORDS,
+        SENTIMENT_SCORE,
+        SUPPORTIVE_MESSAGE,
+        TASK_SUGGESTION,
+        TASK_RECOMMENDATIONS,
+        WEEKLY_PATTERNS,
+        MOOD_TREND,
+        DETAILED_INSIGHTS,
+        TIMER_COUNT
+    };
+
+    // Values up to 2^40 ns (about 18 minutes); longer ones land in the last bucket
+    static const int kSubBucketBits = 3;
+    static const int kMaxExponent = 40;
+    static const size_t kBuckets = (kMaxExponent - kSubBucketBits + 2) << kSubBucketBits;
+
+    struct TimerSnapshot {
+        Timer timer;
+        uint64_t calls = 0;             // Every call
+        uint64_t samples = 0;           // Calls that were timed
+        uint64_t totalNanos = 0;        // Over the timed calls
+        std::vector<uint64_t> buckets;
+
+        // Latency at fraction q (0..1) of the timed calls, in nanoseconds
+        uint64_t percentile(double q) const;
+        uint64_t maxNanos() const;
+    };
+
+    struct Snapshot {
+        std::vector<uint64_t> counters;
+        std::vector<TimerSnapshot> timers;
+    };
+
+    static bool enabled();
+    static void setEnabled(bool on);
+
+    static void add(Counter counter, uint64_t amount);
+    // Counts a call and sets timed when this one should be timed. A call
+    // nested in another of the same timer (an overload delegating to
+    // another) returns false and isn't counted again.
+    static bool enter(Timer timer, bool& timed);
+    static void leave(Timer timer, bool timed, uint64_t nanos);
+
+    static Snapshot snapshot();
+    static const char* counterName(Counter counter);
+    static const char* timerName(Timer timer);
+
+    static size_t bucketOf(uint64_t nanos);
+    static uint64_t bucketUpperBound(size_t bucket);
+
+    // Prometheus text exposition format
+    static void writePrometheus(std::ostream& out);
+    // Writes the dump to $MOODOO_METRICS_FILE, if set; false on a write error
+    static bool dumpIfConfigured();
+};
+
+// Times the enclosing scope: MetricsTimer timer(Metrics::LOAD_TASKS);
+// In tracing builds it also records a span named after the timer.
+class MetricsTimer {
+private:
+#ifdef MOODOO_ENABLE_TRACING
+    TraceSpan span;
+#endif
+    Metrics::Timer timer;
+    bool counted;
+    bool timing;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit MetricsTimer(Metrics::Timer timer)
+        :
+#ifdef MOODOO_ENABLE_TRACING
+          span(timer < Metrics::ANALYZE_ENTRY ? "storage" : "analyzer", Metrics::timerName(timer)),
+#endif
+          timer(timer), timing(false) {
+        counted = Metrics::enter(timer, timing);
+        if (timing) start = std::chrono::steady_clock::now();
+    }
+    ~MetricsTimer() {
+        if (!counted) return;
+        uint64_t nanos = 0;
+        if (timing) {
+            nanos = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count());
+        }
+        Metrics::leave(timer, timing, nanos);
+    }
+
+    MetricsTimer(const MetricsTimer&) = delete;
+    MetricsTimer& operator=(const MetricsTimer&) = delete;
+};
+
+#endif // METRICS_H
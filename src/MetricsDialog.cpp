@@ -0,0 +1,104 @@
+#include "MetricsDialog.h"
+#include <QFileDialog>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <fstream>
+#include "Metrics.h"
+
+MetricsDialog::MetricsDialog(QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle("Internal Metrics");
+    resize(720, 560);
+    
+    setupUI();
+    onRefreshClicked();
+}
+
+MetricsDialog::~MetricsDialog()
+{
+}
+
+void MetricsDialog::setupUI()
+{
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    
+    statusLabel = new QLabel(this);
+    mainLayout->addWidget(statusLabel);
+    
+    // One row per instrumented operation
+    timerTable = new QTableWidget(0, 7, this);
+    timerTable->setHorizontalHeaderLabels({"Operation", "Calls", "Timed", "p50 µs", "p99 µs", "p99.9 µs", "Max µs"});
+    timerTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    timerTable->verticalHeader()->setVisible(false);
+    timerTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    mainLayout->addWidget(timerTable, 3);
+    
+    counterTable = new QTableWidget(0, 2, this);
+    counterTable->setHorizontalHeaderLabels({"Counter", "Value"});
+    counterTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    counterTable->verticalHeader()->setVisible(false);
+    counterTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    mainLayout->addWidget(counterTable, 2);
+    
+    // Button row
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    refreshButton = new QPushButton("Refresh", this);
+    saveButton = new QPushButton("Save Prometheus Dump...", this);
+    closeButton = new QPushButton("Close", this);
+    buttonLayout->addWidget(refreshButton);
+    buttonLayout->addWidget(saveButton);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(closeButton);
+    mainLayout->addLayout(buttonLayout);
+    
+    connect(refreshButton, &QPushButton::clicked, this, &MetricsDialog::onRefreshClicked);
+    connect(saveButton, &QPushButton::clicked, this, &MetricsDialog::onSaveClicked);
+    connect(closeButton, &QPushButton::clicked, this, &QDialog::accept);
+}
+
+void MetricsDialog::onRefreshClicked()
+{
+    Metrics::Snapshot snapshot = Metrics::snapshot();
+    auto micros = [](uint64_t nanos) { return QString::number(nanos / 1000.0, 'f', 1); };
+    
+    timerTable->setRowCount(0);
+    for (const auto& timer : snapshot.timers) {
+        if (timer.calls == 0) continue;
+        int row = timerTable->rowCount();
+        timerTable->insertRow(row);
+        timerTable->setItem(row, 0, new QTableWidgetItem(Metrics::timerName(timer.timer)));
+        timerTable->setItem(row, 1, new QTableWidgetItem(QString::number(timer.calls)));
+        timerTable->setItem(row, 2, new QTableWidgetItem(QString::number(timer.samples)));
+        timerTable->setItem(row, 3, new QTableWidgetItem(micros(timer.percentile(0.50))));
+        timerTable->setItem(row, 4, new QTableWidgetItem(micros(timer.percentile(0.99))));
+        timerTable->setItem(row, 5, new QTableWidgetItem(micros(timer.percentile(0.999))));
+        timerTable->setItem(row, 6, new QTableWidgetItem(micros(timer.maxNanos())));
+    }
+    
+    counterTable->setRowCount(Metrics::COUNTER_COUNT);
+    for (int c = 0; c < Metrics::COUNTER_COUNT; ++c) {
+        counterTable->setItem(c, 0, new QTableWidgetItem(Metrics::counterName(static_cast<Metrics::Counter>(c))));
+        counterTable->setItem(c, 1, new QTableWidgetItem(QString::number(snapshot.counters[c])));
+    }
+    
+    statusLabel->setText(Metrics::enabled()
+        ? "Recording since start-up. Percentiles are within 12.5%."
+        : "Recording is off (MOODOO_METRICS=0).");
+}
+
+void MetricsDialog::onSaveClicked()
+{
+    QString path = QFileDialog::getSaveFileName(this, "Save Metrics", "moodoo_metrics.prom",
+                                                "Prometheus text (*.prom *.txt)");
+    if (path.isEmpty()) {
+        return;
+    }
+    
+    std::ofstream file(path.toStdString(), std::ios::trunc);
+    if (!file.is_open()) {
+        QMessageBox::warning(this, "Error", "Could not write " + path);
+        return;
+    }
+    Metrics::writePrometheus(file);
+}
@@ -0,0 +1,36 @@
+#ifndef METRICSDIALOG_H
+#define METRICSDIALOG_H
+
+#include <QDialog>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QTableWidget>
+
+// Debug panel: call counts, latency percentiles and I/O counters from Metrics
+class MetricsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    MetricsDialog(QWidget *parent = nullptr);
+    ~MetricsDialog();
+
+private slots:
+    void onRefreshClicked();
+    void onSaveClicked();
+
+private:
+    void setupUI();
+    
+    // UI elements
+    QLabel *statusLabel;
+    QTableWidget *timerTable;
+    QTableWidget *counterTable;
+    QPushButton *refreshButton;
+    QPushButton *saveButton;
+    QPushButton *closeButton;
+};
+
+#endif // METRICSDIALOG_H
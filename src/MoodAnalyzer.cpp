@@ -1,94 +1,111 @@
 #include "MoodAnalyzer.h"
+#include "Metrics.h"
+#include "MoodKernels.h"
+#include "MoodTrendDetector.h"
+#include "TaskRanker.h"
+#include "CompletionModel.h"
+#include "Tokenizer.h"
 #include <algorithm>
 #include <random>
 #include <ctime>
 
-bool MoodAnalyzer::containsKeyword(const std::string& text, const std::vector<std::string>& keywords) {
-    std::string lowerText = text;
-    std::transform(lowerText.begin(), lowerText.end(), lowerText.begin(), ::tolower);
-    
+namespace {
+
+struct FoldedText {
+    std::string source;
+    std::string text;
+    std::vector<Tokenizer::Span> tokens;
+};
+
+// Folds and tokenizes into per-thread scratch that keeps its capacity, so
+// matching allocates nothing once the buffers have grown. The result is only
+// valid until the next call on the same thread. Analyzing one entry matches
+// the same text several times, so the last result is reused.
+const FoldedText& foldForMatching(const std::string& text) {
+    thread_local FoldedText scratch;
+    if (scratch.source == text && !scratch.text.empty()) {
+        return scratch;
+    }
+    scratch.source.assign(text);
+    Tokenizer::foldCase(text, scratch.text);
+    scratch.tokens.clear();
+    Tokenizer::tokenize(scratch.text, scratch.tokens);
+    return scratch;
+}
+
+// Keywords match whole words, with the last word allowed to continue
+// ("stress" finds "stressed" but "happy" does not find "unhappy")
+bool containsAny(const FoldedText& folded, const std::vector<std::string>& keywords) {
     for (const auto& keyword : keywords) {
-        if (lowerText.find(keyword) != std::string::npos) {
+        if (Tokenizer::containsPhrase(folded.text, folded.tokens, keyword, true)) {
             return true;
         }
     }
     return false;
 }
 
-std::string MoodAnalyzer::getRandomMessage(const std::vector<std::string>& messages) {
-    if (messages.empty()) return "";
+} // namespace
+
+bool MoodAnalyzer::containsKeyword(const std::string& text, const std::vector<std::string>& keywords) const {
+    return containsAny(foldForMatching(text), keywords);
+}
+
+const MessageTemplate& MoodAnalyzer::getRandomMessage(MessageId id) const {
+    size_t variants = catalog->variantCount(id);
+    if (variants <= 1) return catalog->get(id);
     
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, messages.size() - 1);
+    // One engine per thread: no lock, and no shared state between analyzers
+    thread_local std::mt19937 gen(std::random_device{}());
+    std::uniform_int_distribution<size_t> dis(0, variants - 1);
     
-    return messages[dis(gen)];
+    return catalog->get(id, dis(gen));
+}
+
+std::string MoodAnalyzer::generateSupportiveMessage(const MoodEntry& entry) const {
+    MetricsTimer timer(Metrics::SUPPORTIVE_MESSAGE);
+    std::string response;
+    renderSupportiveMessage(entry, response);
+    return response;
 }
 
-std::string MoodAnalyzer::generateSupportiveMessage(const MoodEntry& entry) {
-    std::string response = "\n💙 MooDoo's Supportive Message:\n";
+void MoodAnalyzer::renderSupportiveMessage(const MoodEntry& entry, std::string& out) const {
+    MetricsTimer timer(Metrics::SUPPORTIVE_MESSAGE);
+    catalog->get(MessageId::SUPPORT_HEADER).render(out);
     
     // Analyze mood level and content
     switch (entry.mood) {
         case MoodLevel::VERY_LOW:
-        case MoodLevel::LOW: {
-            std::vector<std::string> lowMoodMessages = {
-                "I can see you're having a tough day. That's completely okay - we all have them! 💙",
-                "It's okay to not be okay. Remember, you don't have to be productive every single day.",
-                "I understand this feels hard right now. Let's take it one small step at a time.",
-                "You're doing better than you think. Even getting out of bed is an achievement on hard days."
-            };
-            
+        case MoodLevel::LOW:
             // Add specific responses based on keywords
-            if (containsKeyword(entry.content, {"overwhelmed", "stress", "anxiety", "pressure"})) {
-                response += "I notice you're feeling overwhelmed. Let's break things down together.\n";
-                response += "What's one tiny thing you could do that would make you feel even slightly better?\n";
-            } else if (containsKeyword(entry.content, {"tired", "exhausted", "drained", "fatigue"})) {
-                response += "It sounds like you're really tired. Rest is productive too!\n";
-                response += "Maybe today is a day for gentle self-care instead of pushing yourself.\n";
+            if (containsKeyword(entry.content, lexicon->overwhelmed)) {
+                catalog->get(MessageId::SUPPORT_LOW_OVERWHELMED).render(out);
+            } else if (containsKeyword(entry.content, lexicon->tired)) {
+                catalog->get(MessageId::SUPPORT_LOW_TIRED).render(out);
             } else {
-                response += getRandomMessage(lowMoodMessages) + "\n";
+                getRandomMessage(MessageId::SUPPORT_LOW).render(out);
             }
             break;
-        }
         
-        case MoodLevel::NEUTRAL: {
-            std::vector<std::string> neutralMessages = {
-                "You're in a balanced place today. That's actually really good!",
-                "Neutral is totally fine. Sometimes steady progress is the best kind.",
-                "How about we check in on your tasks and see what feels right for today?",
-                "You're doing great. Let's find something that feels good to work on."
-            };
-            response += getRandomMessage(neutralMessages) + "\n";
+        case MoodLevel::NEUTRAL:
+            getRandomMessage(MessageId::SUPPORT_NEUTRAL).render(out);
             break;
-        }
         
         case MoodLevel::GOOD:
-        case MoodLevel::EXCELLENT: {
-            std::vector<std::string> goodMoodMessages = {
-                "You're feeling great! This is a perfect time to tackle those important tasks! ✨",
-                "Your positive energy is wonderful! Let's channel that into something productive.",
-                "You're in a great headspace today. What would you like to accomplish?",
-                "This is your moment! You've got the energy and motivation - let's make the most of it!"
-            };
-            
-            if (containsKeyword(entry.content, {"energized", "motivated", "excited", "happy"})) {
-                response += "I love your energy! You're clearly in a great place to get things done.\n";
-                response += "This is the perfect time to tackle those challenging tasks you've been putting off!\n";
+        case MoodLevel::EXCELLENT:
+            if (containsKeyword(entry.content, lexicon->energized)) {
+                catalog->get(MessageId::SUPPORT_GOOD_ENERGIZED).render(out);
             } else {
-                response += getRandomMessage(goodMoodMessages) + "\n";
+                getRandomMessage(MessageId::SUPPORT_GOOD).render(out);
             }
             break;
-        }
     }
     
     // Add a general supportive closing
-    response += "\nRemember: You're doing great, and it's okay to adjust your plans based on how you're feeling. 💙\n";
-    
-    return response;
+    catalog->get(MessageId::SUPPORT_CLOSING).render(out);
 }
 
-std::string MoodAnalyzer::generateTaskSuggestion(MoodLevel mood, int completedTasks, int totalTasks) {
+std::string MoodAnalyzer::generateTaskSuggestion(MoodLevel mood, int completedTasks, int totalTasks) const {
+    MetricsTimer timer(Metrics::TASK_SUGGESTION);
     if (totalTasks == 0) {
         return "You don't have any tasks yet. How about adding one small thing you'd like to accomplish today?";
     }
@@ -119,111 +136,97 @@ std::string MoodAnalyzer::generateTaskSuggestion(MoodLevel mood, int completedTa
     return "💡 Suggestion: Check your task list and pick something that feels right for your energy level today.";
 }
 
-std::string MoodAnalyzer::generateMoodBasedTaskRecommendations(MoodLevel mood, const std::vector<Task>& tasks) {
-    if (tasks.empty()) {
-        return "No tasks available. Add some tasks to get personalized recommendations!";
+std::string MoodAnalyzer::generateTaskSuggestion(const CompletionModel& model, const TaskRanker& ranker) const {
+    MetricsTimer timer(Metrics::TASK_SUGGESTION);
+    std::string out;
+    std::vector<std::pair<const RankedTask*, double>> likely = model.likeliest(ranker, 1);
+    if (likely.empty()) {
+        catalog->get(MessageId::SUGGEST_NOTHING_PENDING).render(out);
+        return out;
     }
     
-    std::string recommendations = "\n🎯 Mood-Based Task Recommendations:\n";
-    
-    // Filter tasks by difficulty based on mood
-    std::vector<Task> easyTasks, mediumTasks, hardTasks;
-    
-    for (const auto& task : tasks) {
-        if (!task.completed) {  // Only show incomplete tasks
-            switch (task.difficulty) {
-                case TaskDifficulty::EASY: easyTasks.push_back(task); break;
-                case TaskDifficulty::MEDIUM: mediumTasks.push_back(task); break;
-                case TaskDifficulty::HARD: hardTasks.push_back(task); break;
-            }
-        }
+    int percent = static_cast<int>(likely.front().second * 100.0 + 0.5);
+    catalog->get(MessageId::SUGGEST_LIKELIEST).render(out, {likely.front().first->title, percent});
+    return out;
+}
+
+std::string MoodAnalyzer::generateMoodBasedTaskRecommendations(const TaskRanker& ranker) const {
+    MetricsTimer timer(Metrics::TASK_RECOMMENDATIONS);
+    std::vector<const RankedTask*> best = ranker.top(3);
+    if (best.empty()) {
+        return "\n🎉 No pending tasks - enjoy the breathing room!\n";
     }
     
-    switch (mood) {
+    std::string recommendations = "\n🎯 Mood-Based Task Recommendations:\n";
+    
+    switch (ranker.mood()) {
         case MoodLevel::VERY_LOW:
         case MoodLevel::LOW:
-            if (!easyTasks.empty()) {
-                recommendations += "💙 Low energy? Try these gentle tasks:\n";
-                for (size_t i = 0; i < std::min(size_t(3), easyTasks.size()); ++i) {
-                    recommendations += "   • " + easyTasks[i].title + "\n";
-                }
-            } else {
-                recommendations += "💙 Low energy day - maybe add some easy tasks like 'drink water' or 'make bed'?\n";
-            }
+            recommendations += "💙 Low energy? Try these gentle tasks:\n";
             break;
-            
         case MoodLevel::NEUTRAL:
-            if (!mediumTasks.empty()) {
-                recommendations += "😐 Balanced mood? These medium tasks might feel right:\n";
-                for (size_t i = 0; i < std::min(size_t(3), mediumTasks.size()); ++i) {
-                    recommendations += "   • " + mediumTasks[i].title + "\n";
-                }
-            } else if (!easyTasks.empty()) {
-                recommendations += "😐 Try these manageable tasks:\n";
-                for (size_t i = 0; i < std::min(size_t(2), easyTasks.size()); ++i) {
-                    recommendations += "   • " + easyTasks[i].title + "\n";
-                }
-            }
+            recommendations += "😐 Balanced mood? These tasks might feel right:\n";
             break;
-            
         case MoodLevel::GOOD:
         case MoodLevel::EXCELLENT:
-            if (!hardTasks.empty()) {
-                recommendations += "✨ High energy! Perfect for challenging tasks:\n";
-                for (size_t i = 0; i < std::min(size_t(3), hardTasks.size()); ++i) {
-                    recommendations += "   • " + hardTasks[i].title + "\n";
-                }
-            } else if (!mediumTasks.empty()) {
-                recommendations += "✨ Great mood! Try these engaging tasks:\n";
-                for (size_t i = 0; i < std::min(size_t(3), mediumTasks.size()); ++i) {
-                    recommendations += "   • " + mediumTasks[i].title + "\n";
-                }
-            }
+            recommendations += "✨ High energy! Perfect for these tasks:\n";
             break;
     }
     
+    // Ranked by mood fit, priority, age and how often similar tasks get done
+    for (const RankedTask* task : best) {
+        recommendations += "   • " + task->title + "\n";
+    }
+    
     return recommendations;
 }
 
-std::string MoodAnalyzer::analyzeWeeklyPatterns(const std::vector<MoodEntry>& moods, const std::vector<Task>& tasks) {
-    if (moods.empty()) {
-        return "No mood data available. Add some mood entries to see patterns!";
+std::string MoodAnalyzer::analyzeWeeklyPatterns(RecordSpan<MoodEntry> moods, RecordSpan<Task> tasks) const {
+    MetricsTimer timer(Metrics::WEEKLY_PATTERNS);
+    MoodColumns moodColumns;
+    TaskColumns taskColumns;
+    moodColumns.reserve(moods.size());
+    taskColumns.reserve(tasks.size());
+    for (const auto& mood : moods) moodColumns.append(mood);
+    for (const auto& task : tasks) taskColumns.append(task);
+    return analyzeWeeklyPatterns(moodColumns, taskColumns);
+}
+
+std::string MoodAnalyzer::analyzeWeeklyPatterns(const MoodColumns& moods, const TaskColumns& tasks) const {
+    MetricsTimer timer(Metrics::WEEKLY_PATTERNS);
+    std::string patterns;
+    renderWeeklyPatterns(moods, tasks, patterns);
+    return patterns;
+}
+
+void MoodAnalyzer::renderWeeklyPatterns(const MoodColumns& moods, const TaskColumns& tasks, std::string& out) const {
+    MetricsTimer timer(Metrics::WEEKLY_PATTERNS);
+    if (moods.size() == 0) {
+        catalog->get(MessageId::WEEKLY_NO_DATA).render(out);
+        return;
     }
     
     // Get last 7 days of data
-    time_t weekAgo = time(nullptr) - (7 * 24 * 60 * 60);
-    std::vector<MoodEntry> recentMoods;
-    std::vector<Task> recentTasks;
-    
-    for (const auto& mood : moods) {
-        if (mood.timestamp >= weekAgo) {
-            recentMoods.push_back(mood);
-        }
-    }
-    
-    for (const auto& task : tasks) {
-        if (task.created >= weekAgo) {
-            recentTasks.push_back(task);
-        }
-    }
-    
-    if (recentMoods.empty()) {
-        return "No mood data from the past week. Keep logging to see patterns!";
+    const int64_t weekAgo = time(nullptr) - (7 * 24 * 60 * 60);
+    
+    // Windowed column scans (SIMD where the CPU allows it)
+    MoodKernels::WindowSum recentMoods = MoodKernels::windowSum(
+        moods.timestamps.data(), moods.mood.data(), moods.size(), weekAgo, INT64_MAX);
+    long totalMood = static_cast<long>(recentMoods.sum);
+    long recentMoodCount = static_cast<long>(recentMoods.count);
+    
+    MoodKernels::CompletionRatio recentTasks = MoodKernels::completionRatio(
+        tasks.created.data(), tasks.completed.data(), tasks.size(), weekAgo, INT64_MAX);
+    int completedTasks = static_cast<int>(recentTasks.completed);
+    int totalTasks = static_cast<int>(recentTasks.total);
+    
+    if (recentMoodCount == 0) {
+        catalog->get(MessageId::WEEKLY_NO_RECENT).render(out);
+        return;
     }
     
     // Calculate average mood for the week
-    double totalMood = 0;
-    for (const auto& mood : recentMoods) {
-        totalMood += static_cast<int>(mood.mood);
-    }
-    double avgMood = totalMood / recentMoods.size();
-    
-    // Calculate task completion rate
-    int completedTasks = 0, totalTasks = 0;
-    for (const auto& task : recentTasks) {
-        totalTasks++;
-        if (task.completed) completedTasks++;
-    }
+    double avgMood = static_cast<double>(totalMood) / recentMoodCount;
     
     int completionRate = 0;
     if (totalTasks > 0) {
@@ -231,68 +234,63 @@ std::string MoodAnalyzer::analyzeWeeklyPatterns(const std::vector<MoodEntry>& mo
     }
     
     // Generate insights
-    std::string patterns = "\n📊 Weekly Mood & Productivity Patterns:\n";
-    patterns += "💭 Average Mood: ";
+    catalog->get(MessageId::WEEKLY_HEADER).render(out);
     
-    if (avgMood >= 4.5) patterns += "😄 Excellent";
-    else if (avgMood >= 3.5) patterns += "😊 Good";
-    else if (avgMood >= 2.5) patterns += "😐 Neutral";
-    else patterns += "😔 Low";
-    patterns += " (" + std::to_string(avgMood).substr(0, 3) + "/5)\n";
+    MessageId average = MessageId::WEEKLY_AVG_LOW;
+    if (avgMood >= 4.5) average = MessageId::WEEKLY_AVG_EXCELLENT;
+    else if (avgMood >= 3.5) average = MessageId::WEEKLY_AVG_GOOD;
+    else if (avgMood >= 2.5) average = MessageId::WEEKLY_AVG_NEUTRAL;
+    catalog->get(average).render(out, {avgMood});
     
     if (totalTasks > 0) {
-        patterns += "✅ Task Completion: " + std::to_string(completedTasks) + "/" + 
-                   std::to_string(totalTasks) + " (" + std::to_string(completionRate) + "%)\n";
+        catalog->get(MessageId::WEEKLY_COMPLETION).render(out, {completedTasks, totalTasks, completionRate});
     }
     
     // Find patterns
-    if (recentMoods.size() >= 3) {
+    if (recentMoodCount >= 3) {
         if (avgMood >= 4.0 && completionRate >= 70) {
-            patterns += "💪 Pattern: You're in a great productive rhythm!\n";
+            catalog->get(MessageId::WEEKLY_PATTERN_RHYTHM).render(out);
         } else if (avgMood <= 2.5 && completionRate <= 30) {
-            patterns += "💙 Pattern: You're having a challenging week. That's okay!\n";
+            catalog->get(MessageId::WEEKLY_PATTERN_CHALLENGING).render(out);
         } else if (avgMood >= 3.5 && completionRate >= 50) {
-            patterns += "📈 Pattern: Good mood is helping your productivity!\n";
+            catalog->get(MessageId::WEEKLY_PATTERN_HELPING).render(out);
         } else {
-            patterns += "🔄 Pattern: Mixed week - you're adapting well!\n";
+            catalog->get(MessageId::WEEKLY_PATTERN_MIXED).render(out);
         }
     }
     
     // Suggestions
-    patterns += "\n🎯 Suggestions:\n";
+    catalog->get(MessageId::WEEKLY_SUGGESTIONS_HEADER).render(out);
     if (avgMood < 3.0) {
-        patterns += "   • Focus on self-care and gentle tasks\n";
-        patterns += "   • Remember: low productivity days are normal\n";
+        catalog->get(MessageId::WEEKLY_SUGGEST_SELF_CARE).render(out);
     } else if (completionRate < 50) {
-        patterns += "   • Try breaking big tasks into smaller steps\n";
-        patterns += "   • Your mood is good - channel that energy!\n";
+        catalog->get(MessageId::WEEKLY_SUGGEST_SMALLER_STEPS).render(out);
     } else {
-        patterns += "   • You're doing great! Keep this momentum going\n";
+        catalog->get(MessageId::WEEKLY_SUGGEST_MOMENTUM).render(out);
     }
-    
-    return patterns;
 }
 
-std::string MoodAnalyzer::analyzeMoodTrend(const std::vector<MoodEntry>& recentEntries) {
+std::string MoodAnalyzer::analyzeMoodTrend(const std::vector<MoodEntry>& recentEntries) const {
+    MetricsTimer timer(Metrics::MOOD_TREND);
     if (recentEntries.size() < 2) {
         return "Keep logging your mood to see patterns over time!";
     }
     
-    // Simple trend analysis
-    int lowMoodCount = 0;
-    int highMoodCount = 0;
-    
+    // Stream the entries through the detector; its final state is the trend
+    MoodTrendDetector detector;
     for (const auto& entry : recentEntries) {
-        if (entry.mood == MoodLevel::VERY_LOW || entry.mood == MoodLevel::LOW) {
-            lowMoodCount++;
-        } else if (entry.mood == MoodLevel::GOOD || entry.mood == MoodLevel::EXCELLENT) {
-            highMoodCount++;
-        }
+        detector.update(entry);
     }
+    const MoodTrendDetector::Series& mood = detector.moodSeries();
     
-    if (lowMoodCount > highMoodCount) {
+    if (detector.lowStreak() >= MoodTrendDetector::kLowStreakDays) {
+        std::string streak = MoodTrendDetector::describe(MoodTrendDetector::SUSTAINED_LOW);
+        streak.pop_back(); // Trailing newline
+        return "📊 Mood Insight: " + streak;
+    }
+    if (mood.mean <= mood.baseline - 0.5 || mood.mean < 2.5) {
         return "📊 Mood Insight: You've been having more challenging days lately. Remember, this is temporary and you're doing great just by showing up.";
-    } else if (highMoodCount > lowMoodCount) {
+    } else if (mood.mean >= mood.baseline + 0.5 || mood.mean > 3.5) {
         return "📊 Mood Insight: You've been in a really good place lately! Keep up whatever's working for you.";
     } else {
         return "📊 Mood Insight: Your mood has been pretty balanced lately. That's actually really healthy!";
@@ -301,52 +299,52 @@ std::string MoodAnalyzer::analyzeMoodTrend(const std::vector<MoodEntry>& recentE
 
 // NEW: Keyword extraction and sentiment analysis methods
 
-std::vector<std::string> MoodAnalyzer::getPositiveKeywords() {
-    return {
-        "happy", "excited", "energized", "motivated", "great", "wonderful", 
-        "amazing", "fantastic", "productive", "accomplished", "proud", "confident",
-        "optimistic", "hopeful", "grateful", "blessed", "lucky", "successful"
-    };
-}
-
-std::vector<std::string> MoodAnalyzer::getNegativeKeywords() {
-    return {
-        "sad", "depressed", "anxious", "worried", "stressed", "overwhelmed",
-        "frustrated", "angry", "tired", "exhausted", "drained", "hopeless",
-        "defeated", "lonely", "isolated", "fearful", "scared", "nervous"
+const MoodLexicon& MoodLexicon::shared() {
+    static const MoodLexicon lexicon = {
+        {
+            "happy", "excited", "energized", "motivated", "great", "wonderful", 
+            "amazing", "fantastic", "productive", "accomplished", "proud", "confident",
+            "optimistic", "hopeful", "grateful", "blessed", "lucky", "successful"
+        },
+        {
+            "sad", "depressed", "anxious", "worried", "stressed", "overwhelmed",
+            "frustrated", "angry", "tired", "exhausted", "drained", "hopeless",
+            "defeated", "lonely", "isolated", "fearful", "scared", "nervous"
+        },
+        {
+            "tired", "exhausted", "drained", "fatigue", "low energy", "sluggish",
+            "energized", "motivated", "active", "awake", "alert", "focused",
+            "rested", "refreshed", "rejuvenated", "lazy", "unmotivated"
+        },
+        {"overwhelmed", "stress", "anxiety", "pressure"},
+        {"tired", "exhausted", "drained", "fatigue"},
+        {"energized", "motivated", "excited", "happy"}
     };
+    return lexicon;
 }
 
-std::vector<std::string> MoodAnalyzer::getEnergyKeywords() {
-    return {
-        "tired", "exhausted", "drained", "fatigue", "low energy", "sluggish",
-        "energized", "motivated", "active", "awake", "alert", "focused",
-        "rested", "refreshed", "rejuvenated", "lazy", "unmotivated"
-    };
-}
-
-std::vector<std::string> MoodAnalyzer::extractKeywords(const std::string& text) {
-    std::vector<std::string> extractedKeywords;
-    std::string lowerText = text;
-    std::transform(lowerText.begin(), lowerText.end(), lowerText.begin(), ::tolower);
+std::vector<Keyword> MoodAnalyzer::extractKeywords(const std::string& text) const {
+    MetricsTimer timer(Metrics::EXTRACT_KEYWORDS);
+    std::vector<Keyword> extractedKeywords;
+    const FoldedText& folded = foldForMatching(text);
     
     // Check for positive keywords
-    for (const auto& keyword : getPositiveKeywords()) {
-        if (lowerText.find(keyword) != std::string::npos) {
+    for (const auto& keyword : lexicon->positive) {
+        if (Tokenizer::containsPhrase(folded.text, folded.tokens, keyword, true)) {
             extractedKeywords.push_back(keyword);
         }
     }
     
     // Check for negative keywords
-    for (const auto& keyword : getNegativeKeywords()) {
-        if (lowerText.find(keyword) != std::string::npos) {
+    for (const auto& keyword : lexicon->negative) {
+        if (Tokenizer::containsPhrase(folded.text, folded.tokens, keyword, true)) {
             extractedKeywords.push_back(keyword);
         }
     }
     
     // Check for energy-related keywords
-    for (const auto& keyword : getEnergyKeywords()) {
-        if (lowerText.find(keyword) != std::string::npos) {
+    for (const auto& keyword : lexicon->energy) {
+        if (Tokenizer::containsPhrase(folded.text, folded.tokens, keyword, true)) {
             extractedKeywords.push_back(keyword);
         }
     }
@@ -354,24 +352,24 @@ std::vector<std::string> MoodAnalyzer::extractKeywords(const std::string& text)
     return extractedKeywords;
 }
 
-double MoodAnalyzer::calculateSentimentScore(const std::string& text) {
-    std::string lowerText = text;
-    std::transform(lowerText.begin(), lowerText.end(), lowerText.begin(), ::tolower);
+double MoodAnalyzer::calculateSentimentScore(const std::string& text) const {
+    MetricsTimer timer(Metrics::SENTIMENT_SCORE);
+    const FoldedText& folded = foldForMatching(text);
     
     double score = 0.0;
     int totalWords = 0;
     
     // Count positive words
-    for (const auto& keyword : getPositiveKeywords()) {
-        if (lowerText.find(keyword) != std::string::npos) {
+    for (const auto& keyword : lexicon->positive) {
+        if (Tokenizer::containsPhrase(folded.text, folded.tokens, keyword, true)) {
             score += 0.3;  // Positive words add to score
             totalWords++;
         }
     }
     
     // Count negative words
-    for (const auto& keyword : getNegativeKeywords()) {
-        if (lowerText.find(keyword) != std::string::npos) {
+    for (const auto& keyword : lexicon->negative) {
+        if (Tokenizer::containsPhrase(folded.text, folded.tokens, keyword, true)) {
             score -= 0.3;  // Negative words subtract from score
             totalWords++;
         }
@@ -389,7 +387,8 @@ double MoodAnalyzer::calculateSentimentScore(const std::string& text) {
     return score;
 }
 
-void MoodAnalyzer::analyzeMoodEntry(MoodEntry& entry) {
+void MoodAnalyzer::analyzeMoodEntry(MoodEntry& entry) const {
+    MetricsTimer timer(Metrics::ANALYZE_ENTRY);
     // Extract keywords automatically from the content
     entry.extractedKeywords = extractKeywords(entry.content);
     
@@ -405,42 +404,34 @@ void MoodAnalyzer::analyzeMoodEntry(MoodEntry& entry) {
     }
 }
 
-std::string MoodAnalyzer::generateDetailedInsights(const MoodEntry& entry) {
-    std::string insights = "\n🔍 Detailed Mood Analysis:\n";
+std::string MoodAnalyzer::generateDetailedInsights(const MoodEntry& entry) const {
+    MetricsTimer timer(Metrics::DETAILED_INSIGHTS);
+    std::string insights;
+    renderDetailedInsights(entry, insights);
+    return insights;
+}
+
+void MoodAnalyzer::renderDetailedInsights(const MoodEntry& entry, std::string& out) const {
+    MetricsTimer timer(Metrics::DETAILED_INSIGHTS);
+    catalog->get(MessageId::INSIGHTS_HEADER).render(out);
     
     // Show extracted keywords
     if (!entry.extractedKeywords.empty()) {
-        insights += "📝 Detected keywords: ";
-        for (size_t i = 0; i < entry.extractedKeywords.size(); ++i) {
-            if (i > 0) insights += ", ";
-            insights += entry.extractedKeywords[i];
-        }
-        insights += "\n";
+        catalog->get(MessageId::INSIGHTS_KEYWORDS).render(out, {entry.extractedKeywords});
     }
     
     // Show sentiment score
-    insights += "📊 Sentiment score: ";
-    if (entry.sentimentScore > 0.3) {
-        insights += "Positive (" + std::to_string(entry.sentimentScore).substr(0, 4) + ")";
-    } else if (entry.sentimentScore < -0.3) {
-        insights += "Negative (" + std::to_string(entry.sentimentScore).substr(0, 4) + ")";
-    } else {
-        insights += "Neutral (" + std::to_string(entry.sentimentScore).substr(0, 4) + ")";
-    }
-    insights += "\n";
+    MessageId sentiment = MessageId::INSIGHTS_SENTIMENT_NEUTRAL;
+    if (entry.sentimentScore > 0.3) sentiment = MessageId::INSIGHTS_SENTIMENT_POSITIVE;
+    else if (entry.sentimentScore < -0.3) sentiment = MessageId::INSIGHTS_SENTIMENT_NEGATIVE;
+    catalog->get(sentiment).render(out, {entry.sentimentScore});
     
     // Provide insights based on keywords
-    bool hasEnergyKeywords = false;
+    const std::vector<std::string>& energyKeywords = lexicon->energy;
     for (const auto& keyword : entry.extractedKeywords) {
-        if (std::find(getEnergyKeywords().begin(), getEnergyKeywords().end(), keyword) != getEnergyKeywords().end()) {
-            hasEnergyKeywords = true;
+        if (std::find(energyKeywords.begin(), energyKeywords.end(), keyword.str()) != energyKeywords.end()) {
+            catalog->get(MessageId::INSIGHTS_ENERGY).render(out);
             break;
         }
     }
-    
-    if (hasEnergyKeywords) {
-        insights += "💡 Energy level detected in your entry. This helps us provide better task suggestions!\n";
-    }
-    
-    return insights;
-} 
\ No newline at end of file
+}
@@ -4,41 +4,70 @@
 #include <string>
 #include <vector>
 #include "Storage.h"
+#include "MessageCatalog.h"
 
+class TaskRanker;
+class CompletionModel;
+
+// Word lists the analyzer matches against. Built once and never modified,
+// so any number of analyzers and threads can share one.
+struct MoodLexicon {
+    std::vector<std::string> positive;
+    std::vector<std::string> negative;
+    std::vector<std::string> energy;
+    std::vector<std::string> overwhelmed;   // Picks the "let's break it down" message
+    std::vector<std::string> tired;         // Picks the "rest is productive" message
+    std::vector<std::string> energized;     // Picks the "tackle the hard ones" message
+
+    static const MoodLexicon& shared();
+};
+
+// Every method is const and the only state is pointers to immutable data, so
+// one analyzer can be used from many threads at once. Variant choice uses a
+// per-thread random engine.
 class MoodAnalyzer {
 private:
+    const MoodLexicon* lexicon;
+    const MessageCatalog* catalog;
+
     // Helper methods
-    bool containsKeyword(const std::string& text, const std::vector<std::string>& keywords);
-    std::string getRandomMessage(const std::vector<std::string>& messages);
-    
-    // NEW: Keyword extraction and sentiment analysis
-    std::vector<std::string> extractKeywords(const std::string& text);
-    double calculateSentimentScore(const std::string& text);
-    std::vector<std::string> getPositiveKeywords();
-    std::vector<std::string> getNegativeKeywords();
-    std::vector<std::string> getEnergyKeywords();
+    bool containsKeyword(const std::string& text, const std::vector<std::string>& keywords) const;
+    const MessageTemplate& getRandomMessage(MessageId id) const;
 
 public:
-    MoodAnalyzer() = default;
+    MoodAnalyzer() : MoodAnalyzer(MoodLexicon::shared(), MessageCatalog::global()) {}
+    MoodAnalyzer(const MoodLexicon& lexicon, const MessageCatalog& catalog)
+        : lexicon(&lexicon), catalog(&catalog) {}
     
     // Main method to generate supportive response
-    std::string generateSupportiveMessage(const MoodEntry& entry);
+    std::string generateSupportiveMessage(const MoodEntry& entry) const;
+    // render* variants append to a caller-owned buffer; reuse it to avoid allocating
+    void renderSupportiveMessage(const MoodEntry& entry, std::string& out) const;
     
     // Generate task suggestions based on mood
-    std::string generateTaskSuggestion(MoodLevel mood, int completedTasks, int totalTasks);
+    std::string generateTaskSuggestion(MoodLevel mood, int completedTasks, int totalTasks) const;
+    // Learned version: the pending task the user is likeliest to finish right now
+    std::string generateTaskSuggestion(const CompletionModel& model, const TaskRanker& ranker) const;
     
     // NEW: Generate mood-based task recommendations
-    std::string generateMoodBasedTaskRecommendations(MoodLevel mood, const std::vector<Task>& tasks);
+    std::string generateMoodBasedTaskRecommendations(const TaskRanker& ranker) const;
     
     // NEW: Analyze weekly mood and productivity patterns
-    std::string analyzeWeeklyPatterns(const std::vector<MoodEntry>& moods, const std::vector<Task>& tasks);
+    std::string analyzeWeeklyPatterns(RecordSpan<MoodEntry> moods, RecordSpan<Task> tasks) const;
+    std::string analyzeWeeklyPatterns(const MoodColumns& moods, const TaskColumns& tasks) const;
+    void renderWeeklyPatterns(const MoodColumns& moods, const TaskColumns& tasks, std::string& out) const;
     
     // Analyze mood patterns
-    std::string analyzeMoodTrend(const std::vector<MoodEntry>& recentEntries);
+    std::string analyzeMoodTrend(const std::vector<MoodEntry>& recentEntries) const;
+    
+    // NEW: Keyword extraction and sentiment analysis (analyzeMoodEntry runs both)
+    std::vector<Keyword> extractKeywords(const std::string& text) const;
+    double calculateSentimentScore(const std::string& text) const;
     
     // NEW: Enhanced mood analysis
-    void analyzeMoodEntry(MoodEntry& entry);
-    std::string generateDetailedInsights(const MoodEntry& entry);
+    void analyzeMoodEntry(MoodEntry& entry) const;
+    std::string generateDetailedInsights(const MoodEntry& entry) const;
+    void renderDetailedInsights(const MoodEntry& entry, std::string& out) const;
 };
 
-#endif // MOOD_ANALYZER_H 
\ No newline at end of file
+#endif // MOOD_ANALYZER_H
@@ -126,7 +126,7 @@ void MoodEntryDialog::onSaveMoodClicked()
     }
     
     // Create mood entry
-    MoodEntry entry;
+    entry = MoodEntry();
     entry.content = content.toStdString();
     entry.mood = static_cast<MoodLevel>(moodComboBox->currentData().toInt());
     entry.timestamp = time(nullptr);
@@ -16,6 +16,9 @@ class MoodEntryDialog : public QDialog
 
 public:
     MoodEntryDialog(Storage* storage, QWidget* parent = nullptr);
+    
+    // The entry written by the last successful save
+    const MoodEntry& savedEntry() const { return entry; }
 
 private slots:
     void onSaveMoodClicked();
@@ -37,6 +40,7 @@ private:
     
     // Storage
     Storage *storage;
+    MoodEntry entry;
 };
 
 #endif // MOODENTRYDIALOG_H
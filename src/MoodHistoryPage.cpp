@@ -1,5 +1,7 @@
 #include "MoodHistoryPage.h"
 #include <QDateTime>
+#include <limits>
+#include "Trace.h"
 
 MoodHistoryPage::MoodHistoryPage(Storage* storage, QWidget *parent)
     : QWidget(parent), storage(storage)
@@ -110,51 +112,51 @@ void MoodHistoryPage::setupUI()
 
 void MoodHistoryPage::refreshMoodList()
 {
+    MOODOO_TRACE_SCOPE("ui", "refreshMoodList");
     moodListWidget->clear();
     
-    std::vector<MoodEntry> moods;
-    if (storage->loadMoodEntries(moods)) {
-        if (moods.empty()) {
-            moodListWidget->addItem("No mood entries found. Start logging your moods!");
-            return;
+    // Streamed a segment at a time; the list needs no copy of the journal
+    bool any = false;
+    bool loaded = storage->scanMoods(std::numeric_limits<time_t>::min(), std::numeric_limits<time_t>::max(),
+                                     [&](const MoodEntry& mood) {
+        QString moodText;
+        
+        // Add mood emoji
+        switch(mood.mood) {
+            case MoodLevel::VERY_LOW: moodText += "😢 "; break;
+            case MoodLevel::LOW: moodText += "😕 "; break;
+            case MoodLevel::NEUTRAL: moodText += "😐 "; break;
+            case MoodLevel::GOOD: moodText += "😊 "; break;
+            case MoodLevel::EXCELLENT: moodText += "😄 "; break;
         }
         
-        for (const auto& mood : moods) {
-            QString moodText;
-            
-            // Add mood emoji
-            switch(mood.mood) {
-                case MoodLevel::VERY_LOW: moodText += "😢 "; break;
-                case MoodLevel::LOW: moodText += "😕 "; break;
-                case MoodLevel::NEUTRAL: moodText += "😐 "; break;
-                case MoodLevel::GOOD: moodText += "😊 "; break;
-                case MoodLevel::EXCELLENT: moodText += "😄 "; break;
-            }
-            
-            // Add mood level text
-            switch(mood.mood) {
-                case MoodLevel::VERY_LOW: moodText += "Very Low"; break;
-                case MoodLevel::LOW: moodText += "Low"; break;
-                case MoodLevel::NEUTRAL: moodText += "Neutral"; break;
-                case MoodLevel::GOOD: moodText += "Good"; break;
-                case MoodLevel::EXCELLENT: moodText += "Excellent"; break;
-            }
-            
-            // Add timestamp
-            QDateTime dateTime = QDateTime::fromSecsSinceEpoch(mood.timestamp);
-            moodText += " - " + dateTime.toString("MMM dd, h:mm AP");
-            
-            // Add content preview (first 50 chars)
-            QString content = QString::fromStdString(mood.content);
-            if (content.length() > 50) {
-                content = content.left(50) + "...";
-            }
-            moodText += "\n   " + content;
-            
-            moodListWidget->addItem(moodText);
+        // Add mood level text
+        switch(mood.mood) {
+            case MoodLevel::VERY_LOW: moodText += "Very Low"; break;
+            case MoodLevel::LOW: moodText += "Low"; break;
+            case MoodLevel::NEUTRAL: moodText += "Neutral"; break;
+            case MoodLevel::GOOD: moodText += "Good"; break;
+            case MoodLevel::EXCELLENT: moodText += "Excellent"; break;
         }
-    } else {
+        
+        // Add timestamp
+        QDateTime dateTime = QDateTime::fromSecsSinceEpoch(mood.timestamp);
+        moodText += " - " + dateTime.toString("MMM dd, h:mm AP");
+        
+        // Add content preview (first 50 chars)
+        QString content = QString::fromStdString(mood.content);
+        if (content.length() > 50) {
+            content = content.left(50) + "...";
+        }
+        moodText += "\n   " + content;
+        
+        moodListWidget->addItem(moodText);
+        any = true;
+    });
+    if (!loaded) {
         moodListWidget->addItem("Error loading mood entries");
+    } else if (!any) {
+        moodListWidget->addItem("No mood entries found. Start logging your moods!");
     }
 }
 
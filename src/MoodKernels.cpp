@@ -0,0 +1,262 @@
+#include "MoodKernels.h"
+#include <atomic>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define MOODOO_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const int kUnset = -1;
+std::atomic<int> forcedIsa(kUnset);
+
+// Scalar versions: also the reference the SIMD paths must agree with
+
+MoodKernels::Histogram histogramScalar(const uint8_t* levels, size_t count) {
+    // Four interleaved tables avoid stalls on runs of the same level
+    uint64_t partial[4][8] = {};
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        partial[0][levels[i] & 7]++;
+        partial[1][levels[i + 1] & 7]++;
+        partial[2][levels[i + 2] & 7]++;
+        partial[3][levels[i + 3] & 7]++;
+    }
+    for (; i < count; ++i) {
+        partial[0][levels[i] & 7]++;
+    }
+
+    MoodKernels::Histogram result = {};
+    for (int level = 0; level < 8; ++level) {
+        result.counts[level] = partial[0][level] + partial[1][level] + partial[2][level] + partial[3][level];
+    }
+    return result;
+}
+
+MoodKernels::WindowSum windowSumScalar(const int64_t* timestamps, const uint8_t* values, size_t count,
+                                       int64_t from, int64_t to) {
+    MoodKernels::WindowSum result = {0, 0};
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t inWindow = (timestamps[i] >= from) & (timestamps[i] < to);
+        result.sum += inWindow * values[i];
+        result.count += inWindow;
+    }
+    return result;
+}
+
+#ifdef MOODOO_X86_KERNELS
+
+__attribute__((target("avx2")))
+MoodKernels::Histogram histogramAvx2(const uint8_t* levels, size_t count) {
+    MoodKernels::Histogram result = {};
+    const __m256i low3 = _mm256_set1_epi8(7);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i totals[8];
+    for (int level = 1; level < 8; ++level) totals[level] = zero;
+
+    size_t i = 0;
+    while (i + 32 <= count) {
+        // Byte counters overflow after 255 blocks, so widen them in batches
+        __m256i counters[8];
+        for (int level = 1; level < 8; ++level) counters[level] = zero;
+
+        size_t batchEnd = i + 255 * 32;
+        for (; i + 32 <= count && i < batchEnd; i += 32) {
+            __m256i block = _mm256_and_si256(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(levels + i)), low3);
+            for (int level = 1; level < 8; ++level) {
+                // cmpeq yields -1 per match
+                __m256i match = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(static_cast<char>(level)));
+                counters[level] = _mm256_sub_epi8(counters[level], match);
+            }
+        }
+        for (int level = 1; level < 8; ++level) {
+            totals[level] = _mm256_add_epi64(totals[level], _mm256_sad_epu8(counters[level], zero));
+        }
+    }
+
+    uint64_t counted = 0;
+    for (int level = 1; level < 8; ++level) {
+        alignas(32) uint64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), totals[level]);
+        result.counts[level] = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        counted += result.counts[level];
+    }
+    result.counts[0] = i - counted;
+
+    MoodKernels::Histogram tail = histogramScalar(levels + i, count - i);
+    for (int level = 0; level < 8; ++level) result.counts[level] += tail.counts[level];
+    return result;
+}
+
+__attribute__((target("avx2")))
+MoodKernels::WindowSum windowSumAvx2(const int64_t* timestamps, const uint8_t* values, size_t count,
+                                     int64_t from, int64_t to) {
+    const __m256i fromBound = _mm256_set1_epi64x(from);
+    const __m256i toBound = _mm256_set1_epi64x(to);
+    __m256i sums = _mm256_setzero_si256();
+    __m256i counts = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i stamps = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(timestamps + i));
+        int32_t packed;
+        __builtin_memcpy(&packed, values + i, sizeof(packed));
+        __m256i widened = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(packed));
+
+        // ts >= from is !(from > ts); andnot negates its first operand
+        __m256i inWindow = _mm256_andnot_si256(_mm256_cmpgt_epi64(fromBound, stamps),
+                                               _mm256_cmpgt_epi64(toBound, stamps));
+        sums = _mm256_add_epi64(sums, _mm256_and_si256(widened, inWindow));
+        counts = _mm256_sub_epi64(counts, inWindow);
+    }
+
+    alignas(32) uint64_t sumLanes[4];
+    alignas(32) uint64_t countLanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(sumLanes), sums);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(countLanes), counts);
+
+    MoodKernels::WindowSum result = windowSumScalar(timestamps + i, values + i, count - i, from, to);
+    for (int lane = 0; lane < 4; ++lane) {
+        result.sum += sumLanes[lane];
+        result.count += countLanes[lane];
+    }
+    return result;
+}
+
+__attribute__((target("sse4.2")))
+MoodKernels::Histogram histogramSse42(const uint8_t* levels, size_t count) {
+    MoodKernels::Histogram result = {};
+    const __m128i low3 = _mm_set1_epi8(7);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i totals[8];
+    for (int level = 1; level < 8; ++level) totals[level] = zero;
+
+    size_t i = 0;
+    while (i + 16 <= count) {
+        __m128i counters[8];
+        for (int level = 1; level < 8; ++level) counters[level] = zero;
+
+        size_t batchEnd = i + 255 * 16;
+        for (; i + 16 <= count && i < batchEnd; i += 16) {
+            __m128i block = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(levels + i)), low3);
+            for (int level = 1; level < 8; ++level) {
+                __m128i match = _mm_cmpeq_epi8(block, _mm_set1_epi8(static_cast<char>(level)));
+                counters[level] = _mm_sub_epi8(counters[level], match);
+            }
+        }
+        for (int level = 1; level < 8; ++level) {
+            totals[level] = _mm_add_epi64(totals[level], _mm_sad_epu8(counters[level], zero));
+        }
+    }
+
+    uint64_t counted = 0;
+    for (int level = 1; level < 8; ++level) {
+        alignas(16) uint64_t lanes[2];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), totals[level]);
+        result.counts[level] = lanes[0] + lanes[1];
+        counted += result.counts[level];
+    }
+    result.counts[0] = i - counted;
+
+    MoodKernels::Histogram tail = histogramScalar(levels + i, count - i);
+    for (int level = 0; level < 8; ++level) result.counts[level] += tail.counts[level];
+    return result;
+}
+
+__attribute__((target("sse4.2")))
+MoodKernels::WindowSum windowSumSse42(const int64_t* timestamps, const uint8_t* values, size_t count,
+                                      int64_t from, int64_t to) {
+    const __m128i fromBound = _mm_set1_epi64x(from);
+    const __m128i toBound = _mm_set1_epi64x(to);
+    __m128i sums = _mm_setzero_si128();
+    __m128i counts = _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128i stamps = _mm_loadu_si128(reinterpret_cast<const __m128i*>(timestamps + i));
+        uint16_t packed;
+        __builtin_memcpy(&packed, values + i, sizeof(packed));
+        __m128i widened = _mm_cvtepu8_epi64(_mm_cvtsi32_si128(packed));
+
+        __m128i inWindow = _mm_andnot_si128(_mm_cmpgt_epi64(fromBound, stamps),
+                                            _mm_cmpgt_epi64(toBound, stamps));
+        sums = _mm_add_epi64(sums, _mm_and_si128(widened, inWindow));
+        counts = _mm_sub_epi64(counts, inWindow);
+    }
+
+    alignas(16) uint64_t sumLanes[2];
+    alignas(16) uint64_t countLanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(sumLanes), sums);
+    _mm_store_si128(reinterpret_cast<__m128i*>(countLanes), counts);
+
+    MoodKernels::WindowSum result = windowSumScalar(timestamps + i, values + i, count - i, from, to);
+    result.sum += sumLanes[0] + sumLanes[1];
+    result.count += countLanes[0] + countLanes[1];
+    return result;
+}
+
+#endif // MOODOO_X86_KERNELS
+
+MoodKernels::Isa detectIsa() {
+#ifdef MOODOO_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return MoodKernels::Isa::AVX2;
+    if (__builtin_cpu_supports("sse4.2")) return MoodKernels::Isa::SSE42;
+#endif
+    return MoodKernels::Isa::SCALAR;
+}
+
+} // namespace
+
+MoodKernels::Isa MoodKernels::activeIsa() {
+    static const Isa detected = detectIsa();
+    int forced = forcedIsa.load(std::memory_order_relaxed);
+    if (forced != kUnset && forced <= static_cast<int>(detected)) {
+        return static_cast<Isa>(forced);
+    }
+    return detected;
+}
+
+const char* MoodKernels::isaName(Isa isa) {
+    switch (isa) {
+        case Isa::AVX2: return "avx2";
+        case Isa::SSE42: return "sse4.2";
+        default: return "scalar";
+    }
+}
+
+void MoodKernels::forceIsa(Isa isa) {
+    forcedIsa.store(static_cast<int>(isa), std::memory_order_relaxed);
+}
+
+MoodKernels::Histogram MoodKernels::histogram(const uint8_t* levels, size_t count) {
+#ifdef MOODOO_X86_KERNELS
+    switch (activeIsa()) {
+        case Isa::AVX2: return histogramAvx2(levels, count);
+        case Isa::SSE42: return histogramSse42(levels, count);
+        default: break;
+    }
+#endif
+    return histogramScalar(levels, count);
+}
+
+MoodKernels::WindowSum MoodKernels::windowSum(const int64_t* timestamps, const uint8_t* values, size_t count,
+                                              int64_t from, int64_t to) {
+#ifdef MOODOO_X86_KERNELS
+    switch (activeIsa()) {
+        case Isa::AVX2: return windowSumAvx2(timestamps, values, count, from, to);
+        case Isa::SSE42: return windowSumSse42(timestamps, values, count, from, to);
+        default: break;
+    }
+#endif
+    return windowSumScalar(timestamps, values, count, from, to);
+}
+
+MoodKernels::CompletionRatio MoodKernels::completionRatio(const int64_t* timestamps, const uint8_t* completed,
+                                                          size_t count, int64_t from, int64_t to) {
+    // Completion flags are 0/1, so a window sum over them is the completed count
+    WindowSum sum = windowSum(timestamps, completed, count, from, to);
+    return CompletionRatio{sum.sum, sum.count};
+}
@@ -0,0 +1,48 @@
+#ifndef MOOD_KERNELS_H
+#define MOOD_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Summary kernels over packed record columns (see RecordColumns.h).
+// Each call picks AVX2, SSE4.2 or a scalar loop at runtime.
+class MoodKernels {
+public:
+    enum class Isa {
+        SCALAR,
+        SSE42,
+        AVX2
+    };
+
+    // Counts of each level 0..7 (mood uses 1..5, difficulty/priority 1..3)
+    struct Histogram {
+        uint64_t counts[8];
+    };
+
+    // Sum and count of the values whose timestamp lies in [from, to)
+    struct WindowSum {
+        uint64_t sum;
+        uint64_t count;
+        double mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+    };
+
+    // Completed and total counts of the rows whose timestamp lies in [from, to)
+    struct CompletionRatio {
+        uint64_t completed;
+        uint64_t total;
+        double ratio() const { return total ? static_cast<double>(completed) / total : 0.0; }
+    };
+
+    static Isa activeIsa();
+    static const char* isaName(Isa isa);
+    // Pins the implementation, e.g. to compare paths in benchmarks
+    static void forceIsa(Isa isa);
+
+    static Histogram histogram(const uint8_t* levels, size_t count);
+    static WindowSum windowSum(const int64_t* timestamps, const uint8_t* values, size_t count,
+                               int64_t from, int64_t to);
+    static CompletionRatio completionRatio(const int64_t* timestamps, const uint8_t* completed, size_t count,
+                                           int64_t from, int64_t to);
+};
+
+#endif // MOOD_KERNELS_H
@@ -0,0 +1,133 @@
+#include "MoodTrendDetector.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double kFastWeight = 0.2;     // EWMA weight: roughly the last week or two of entries
+const double kSlowWeight = 0.05;    // Baseline weight: roughly the last couple of months
+const double kDriftAllowance = 0.5; // CUSUM slack, in deviations
+const double kShiftThreshold = 4.0; // CUSUM decision level, in deviations
+const uint64_t kWarmupSamples = 5;  // No shift alerts until the baseline means something
+
+} // namespace
+
+MoodTrendDetector::Series::Series(double minDeviation)
+    : mean(0.0), variance(0.0), baseline(0.0), cusumLow(0.0), cusumHigh(0.0),
+      minDeviation(minDeviation), samples(0) {}
+
+double MoodTrendDetector::Series::deviation() const {
+    return std::max(std::sqrt(variance), minDeviation);
+}
+
+int MoodTrendDetector::Series::update(double value) {
+    if (samples++ == 0) {
+        mean = baseline = value;
+        return 0;
+    }
+
+    double diff = value - mean;
+    double step = kFastWeight * diff;
+    mean += step;
+    variance = (1.0 - kFastWeight) * (variance + diff * step);
+
+    // Two-sided CUSUM against the slow baseline
+    double sigma = deviation();
+    cusumLow = std::max(0.0, cusumLow + (baseline - value) - kDriftAllowance * sigma);
+    cusumHigh = std::max(0.0, cusumHigh + (value - baseline) - kDriftAllowance * sigma);
+    baseline += kSlowWeight * (value - baseline);
+
+    if (samples <= kWarmupSamples) {
+        cusumLow = cusumHigh = 0.0;
+        return 0;
+    }
+
+    int shift = 0;
+    if (cusumLow > kShiftThreshold * sigma) shift = -1;
+    else if (cusumHigh > kShiftThreshold * sigma) shift = 1;
+    if (shift != 0) {
+        // Re-anchor at the new level so one shift is reported once
+        baseline = mean;
+        cusumLow = cusumHigh = 0.0;
+    }
+    return shift;
+}
+
+MoodTrendDetector::MoodTrendDetector()
+    : mood(0.5), sentiment(0.1),
+      currentDay(0), daySum(0), dayCount(0), completedLowDays(0), streakReported(false) {}
+
+void MoodTrendDetector::reset() {
+    mood = Series(0.5);
+    sentiment = Series(0.1);
+    currentDay = 0;
+    daySum = 0;
+    dayCount = 0;
+    completedLowDays = 0;
+    streakReported = false;
+}
+
+bool MoodTrendDetector::currentDayLow() const {
+    // A day is low when its average mood is LOW or worse
+    return dayCount > 0 && daySum <= static_cast<uint32_t>(MoodLevel::LOW) * dayCount;
+}
+
+int MoodTrendDetector::lowStreak() const {
+    return completedLowDays + (currentDayLow() ? 1 : 0);
+}
+
+unsigned MoodTrendDetector::update(const MoodEntry& entry) {
+    unsigned alerts = NONE;
+    int level = static_cast<int>(entry.mood);
+
+    int64_t day = localDays.dayOf(static_cast<int64_t>(entry.timestamp));
+    if (dayCount == 0 || day > currentDay) {
+        if (dayCount > 0) {
+            // Close the previous day; a day with no entries breaks the streak
+            int closed = currentDayLow() ? completedLowDays + 1 : 0;
+            completedLowDays = (day == currentDay + 1) ? closed : 0;
+        }
+        currentDay = day;
+        daySum = 0;
+        dayCount = 0;
+    }
+    // Late entries for days already closed only feed the series
+    if (day == currentDay) {
+        daySum += static_cast<uint32_t>(level);
+        dayCount++;
+    }
+
+    if (lowStreak() >= kLowStreakDays) {
+        if (!streakReported) {
+            alerts |= SUSTAINED_LOW;
+            streakReported = true;
+        }
+    } else {
+        streakReported = false;
+    }
+
+    int shift = mood.update(level);
+    if (shift < 0) alerts |= DOWNWARD_SHIFT;
+    if (shift > 0) alerts |= UPWARD_SHIFT;
+    if (sentiment.update(entry.sentimentScore) < 0) alerts |= SENTIMENT_DROP;
+
+    return alerts;
+}
+
+std::string MoodTrendDetector::describe(unsigned alerts) {
+    std::string text;
+    if (alerts & SUSTAINED_LOW) {
+        text += "💙 You've had " + std::to_string(kLowStreakDays) + " low days in a row. "
+                "That's really hard - consider reaching out to someone you trust, and keep today's plans gentle.\n";
+    }
+    if (alerts & DOWNWARD_SHIFT) {
+        text += "📉 Your mood has settled below its usual level lately. Be extra kind to yourself this week.\n";
+    }
+    if (alerts & UPWARD_SHIFT) {
+        text += "📈 Your mood has been lifting above its usual level - whatever you're doing, it's working!\n";
+    }
+    if (alerts & SENTIMENT_DROP) {
+        text += "📝 Your journal entries have sounded heavier than usual. It might help to talk it through with someone.\n";
+    }
+    return text;
+}
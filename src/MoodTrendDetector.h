@@ -0,0 +1,70 @@
+#ifndef MOOD_TREND_DETECTOR_H
+#define MOOD_TREND_DETECTOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "LocalTime.h"
+#include "Storage.h"
+
+// Online change detection over the mood series. Each update is O(1): the
+// detector keeps exponentially weighted statistics and CUSUM sums, never
+// the history itself.
+class MoodTrendDetector {
+public:
+    // Alerts raised by update(), combined as bit flags
+    enum Alert : unsigned {
+        NONE = 0,
+        SUSTAINED_LOW = 1 << 0,     // kLowStreakDays low days in a row
+        DOWNWARD_SHIFT = 1 << 1,    // Mood level settled clearly below its baseline
+        UPWARD_SHIFT = 1 << 2,      // Mood level settled clearly above its baseline
+        SENTIMENT_DROP = 1 << 3     // Journal tone turned clearly more negative
+    };
+
+    static const int kLowStreakDays = 5;
+
+    // EWMA, exponentially weighted variance and two-sided CUSUM for one signal
+    struct Series {
+        double mean;
+        double variance;
+        double baseline;        // Slow EWMA the CUSUM sums measure against
+        double cusumLow;
+        double cusumHigh;
+        double minDeviation;    // Floor so a flat history doesn't make every wobble a shift
+        uint64_t samples;
+
+        explicit Series(double minDeviation);
+        double deviation() const;
+        // Returns -1 for a downward shift, +1 for an upward one, 0 otherwise
+        int update(double value);
+    };
+
+    MoodTrendDetector();
+
+    // Feeds one entry, in time order. Returns the Alert flags it raised.
+    unsigned update(const MoodEntry& entry);
+    void reset();
+
+    const Series& moodSeries() const { return mood; }
+    const Series& sentimentSeries() const { return sentiment; }
+    int lowStreak() const;
+
+    // Supportive text for a set of alerts; empty when there is nothing to say
+    static std::string describe(unsigned alerts);
+
+private:
+    Series mood;
+    Series sentiment;
+    LocalTime::DayCache localDays;  // Local day boundaries, DST included
+
+    // Day-level state for the low-streak rule
+    int64_t currentDay;
+    uint32_t daySum;
+    uint32_t dayCount;
+    int completedLowDays;       // Low days in a row ending the day before currentDay
+    bool streakReported;
+
+    bool currentDayLow() const;
+};
+
+#endif // MOOD_TREND_DETECTOR_H
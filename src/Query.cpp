@@ -0,0 +1,341 @@
+#include "Query.h"
+#include "LocalTime.h"
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+namespace {
+
+const int64_t kLowest = std::numeric_limits<int64_t>::min();
+const int64_t kHighest = std::numeric_limits<int64_t>::max();
+
+struct FieldName {
+    const char* name;
+    Query::Field field;
+};
+
+const FieldName kFieldNames[] = {
+    {"priority", Query::PRIORITY},
+    {"difficulty", Query::DIFFICULTY},
+    {"done", Query::DONE},
+    {"created", Query::CREATED},
+    {"date", Query::CREATED},
+    {"completed", Query::COMPLETED},
+    {"mood", Query::MOOD},
+    {"sentiment", Query::SENTIMENT}
+};
+
+const char* const kPriorityNames[] = {"low", "medium", "high"};
+const char* const kDifficultyNames[] = {"easy", "medium", "hard"};
+const char* const kMoodNames[] = {"very_low", "low", "neutral", "good", "excellent"};
+
+std::string lower(std::string_view text) {
+    std::string result(text);
+    for (char& c : result) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return result;
+}
+
+bool parseInteger(std::string_view text, int64_t& value) {
+    if (text.empty() || text.size() > 18) return false;
+    size_t i = text[0] == '-' ? 1 : 0;
+    if (i == text.size()) return false;
+    value = 0;
+    for (; i < text.size(); ++i) {
+        if (!std::isdigit(static_cast<unsigned char>(text[i]))) return false;
+        value = value * 10 + (text[i] - '0');
+    }
+    if (text[0] == '-') value = -value;
+    return true;
+}
+
+// A name from names (1-based) or the number itself
+bool parseLevel(std::string_view text, const char* const* names, int count, int64_t& value) {
+    std::string name = lower(text);
+    for (int i = 0; i < count; ++i) {
+        if (name == names[i]) {
+            value = i + 1;
+            return true;
+        }
+    }
+    if (name == "verylow" && names == kMoodNames) {
+        value = 1;
+        return true;
+    }
+    return parseInteger(text, value) && value >= 1 && value <= count;
+}
+
+time_t startOfDay(int year, int month, int day) {
+    std::tm calendar{};
+    calendar.tm_year = year - 1900;
+    calendar.tm_mon = month - 1;
+    calendar.tm_mday = day;
+    calendar.tm_isdst = -1;
+    return std::mktime(&calendar);
+}
+
+// The local day a date names, as [first, last] second
+bool parseDay(std::string_view text, time_t now, int64_t& first, int64_t& last) {
+    std::string value = lower(text);
+    int year, month, day;
+    if (value == "today" || value == "yesterday" || (value.size() > 1 && value.back() == 'd')) {
+        int64_t daysAgo = 0;
+        if (value == "yesterday") daysAgo = 1;
+        else if (value != "today" && (!parseInteger(std::string_view(value).substr(0, value.size() - 1), daysAgo) ||
+                                      daysAgo < 0 || daysAgo > 100000)) {
+            return false;
+        }
+        std::tm today = LocalTime::local(now);
+        year = today.tm_year + 1900;
+        month = today.tm_mon + 1;
+        day = today.tm_mday - static_cast<int>(daysAgo);     // mktime normalises
+    } else {
+        char tail;
+        if (std::sscanf(value.c_str(), "%4d-%2d-%2d%c", &year, &month, &day, &tail) != 3 ||
+            month < 1 || month > 12 || day < 1 || day > 31) {
+            return false;
+        }
+    }
+    time_t start = startOfDay(year, month, day);
+    time_t next = startOfDay(year, month, day + 1);
+    if (start == static_cast<time_t>(-1) || next == static_cast<time_t>(-1)) return false;
+    first = start;
+    last = next - 1;
+    return true;
+}
+
+// One value of a field as the [first, last] keys it stands for
+bool parseValue(Query::Field field, std::string_view text, time_t now, int64_t& first, int64_t& last) {
+    int64_t value = 0;
+    switch (field) {
+        case Query::PRIORITY:
+            if (!parseLevel(text, kPriorityNames, 3, value)) return false;
+            break;
+        case Query::DIFFICULTY:
+            if (!parseLevel(text, kDifficultyNames, 3, value)) return false;
+            break;
+        case Query::MOOD:
+            if (!parseLevel(text, kMoodNames, 5, value)) return false;
+            break;
+        case Query::DONE: {
+            std::string name = lower(text);
+            if (name == "yes" || name == "true" || name == "1") value = 1;
+            else if (name == "no" || name == "false" || name == "0") value = 0;
+            else return false;
+            break;
+        }
+        case Query::CREATED:
+        case Query::COMPLETED:
+            return parseDay(text, now, first, last);
+        case Query::SENTIMENT: {
+            std::string number(text);
+            char* end = nullptr;
+            double parsed = std::strtod(number.c_str(), &end);
+            if (number.empty() || *end != '\0' || !(parsed >= -1.0 && parsed <= 1.0)) return false;
+            value = std::llround(parsed * 1000.0);
+            break;
+        }
+        default:
+            return false;
+    }
+    first = last = value;
+    return true;
+}
+
+std::string_view unquote(std::string_view text) {
+    if (text.size() >= 2 && text.front() == '"' && text.back() == '"') {
+        return text.substr(1, text.size() - 2);
+    }
+    return text;
+}
+
+bool parseCondition(Query::Field field, std::string_view value, time_t now, Query::Condition& condition,
+                    std::string& error) {
+    std::string_view operand = value;
+    int comparison = 0;     // -2 <, -1 <=, 1 >=, 2 >
+    if (operand.substr(0, 2) == ">=") comparison = 1, operand.remove_prefix(2);
+    else if (operand.substr(0, 2) == "<=") comparison = -1, operand.remove_prefix(2);
+    else if (!operand.empty() && operand[0] == '>') comparison = 2, operand.remove_prefix(1);
+    else if (!operand.empty() && operand[0] == '<') comparison = -2, operand.remove_prefix(1);
+
+    condition.field = field;
+    int64_t first, last;
+    size_t dots = operand.find("..");
+    if (comparison == 0 && dots != std::string_view::npos) {
+        int64_t ignored;
+        if (!parseValue(field, operand.substr(0, dots), now, condition.low, ignored) ||
+            !parseValue(field, operand.substr(dots + 2), now, ignored, condition.high)) {
+            error = "Invalid range '" + std::string(value) + "' for " + Query::fieldName(field);
+            return false;
+        }
+    } else if (!parseValue(field, operand, now, first, last)) {
+        error = "Invalid value '" + std::string(value) + "' for " + Query::fieldName(field);
+        return false;
+    } else {
+        switch (comparison) {
+            case -2: condition.low = kLowest; condition.high = first - 1; break;
+            case -1: condition.low = kLowest; condition.high = last; break;
+            case 1: condition.low = first; condition.high = kHighest; break;
+            case 2: condition.low = last + 1; condition.high = kHighest; break;
+            default: condition.low = first; condition.high = last; break;
+        }
+    }
+    // Open tasks have no completion time, not one in 1970
+    if (field == Query::COMPLETED && condition.low < 1) condition.low = 1;
+    return true;
+}
+
+} // namespace
+
+bool Query::parse(std::string_view source, Target target, Query& query, std::string& error, time_t now) {
+    query.target = target;
+    query.conditions.clear();
+    query.text.clear();
+    error.clear();
+
+    size_t position = 0;
+    while (position < source.size()) {
+        if (std::isspace(static_cast<unsigned char>(source[position]))) {
+            ++position;
+            continue;
+        }
+        // A term runs to the next space outside double quotes
+        size_t start = position;
+        bool quoted = false;
+        while (position < source.size() &&
+               (quoted || !std::isspace(static_cast<unsigned char>(source[position])))) {
+            if (source[position] == '"') quoted = !quoted;
+            ++position;
+        }
+        if (quoted) {
+            error = "Missing closing quote";
+            return false;
+        }
+        std::string_view term = source.substr(start, position - start);
+
+        size_t colon = term.find(':');
+        std::string name = colon == std::string_view::npos ? std::string() : lower(term.substr(0, colon));
+        bool named = !name.empty() && term[0] != '"';
+        for (char c : name) {
+            if (!std::isalpha(static_cast<unsigned char>(c))) named = false;
+        }
+        if (!named) {
+            // Plain words, "quoted phrases" and things like 10:30 are text
+            std::string_view words = unquote(term);
+            if (!words.empty()) {
+                if (!query.text.empty()) query.text += ' ';
+                query.text.append(words.data(), words.size());
+            }
+            continue;
+        }
+
+        std::string_view value = term.substr(colon + 1);
+        if (name == "text") {
+            std::string_view words = unquote(value);
+            if (words.empty()) {
+                error = "Missing value for text";
+                return false;
+            }
+            if (!query.text.empty()) query.text += ' ';
+            query.text.append(words.data(), words.size());
+            continue;
+        }
+        if (name == "is") {
+            std::string state = lower(value);
+            if (target != Target::TASKS || (state != "open" && state != "done")) {
+                error = "Unknown state 'is:" + std::string(value) + "'";
+                return false;
+            }
+            int64_t done = state == "done" ? 1 : 0;
+            query.conditions.push_back({DONE, done, done});
+            continue;
+        }
+
+        const FieldName* known = nullptr;
+        for (const auto& candidate : kFieldNames) {
+            if (name == candidate.name) known = &candidate;
+        }
+        if (!known) {
+            error = "Unknown field '" + name + "'";
+            return false;
+        }
+        if (!appliesTo(known->field, target)) {
+            error = "Field '" + name + "' doesn't apply to " + (target == Target::TASKS ? "tasks" : "journal entries");
+            return false;
+        }
+        if (value.empty()) {
+            error = "Missing value for " + name;
+            return false;
+        }
+        Condition condition;
+        if (!parseCondition(known->field, unquote(value), now, condition, error)) {
+            return false;
+        }
+        query.conditions.push_back(condition);
+    }
+    return true;
+}
+
+const char* Query::fieldName(Field field) {
+    switch (field) {
+        case PRIORITY: return "priority";
+        case DIFFICULTY: return "difficulty";
+        case DONE: return "done";
+        case CREATED: return "created";
+        case COMPLETED: return "completed";
+        case MOOD: return "mood";
+        case SENTIMENT: return "sentiment";
+        default: return "";
+    }
+}
+
+bool Query::appliesTo(Field field, Target target) {
+    switch (field) {
+        case PRIORITY:
+        case DIFFICULTY:
+        case DONE:
+        case COMPLETED:
+            return target == Target::TASKS;
+        case MOOD:
+        case SENTIMENT:
+            return target == Target::MOODS;
+        case CREATED:
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::string Query::describe(const Condition& condition) {
+    auto format = [&](int64_t value) -> std::string {
+        char buffer[32];
+        switch (condition.field) {
+            case PRIORITY:
+                return value >= 1 && value <= 3 ? kPriorityNames[value - 1] : std::to_string(value);
+            case DIFFICULTY:
+                return value >= 1 && value <= 3 ? kDifficultyNames[value - 1] : std::to_string(value);
+            case MOOD:
+                return value >= 1 && value <= 5 ? kMoodNames[value - 1] : std::to_string(value);
+            case DONE:
+                return value ? "yes" : "no";
+            case SENTIMENT:
+                std::snprintf(buffer, sizeof(buffer), "%.3f", value / 1000.0);
+                return buffer;
+            case CREATED:
+            case COMPLETED: {
+                std::tm local = LocalTime::local(static_cast<time_t>(value));
+                std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local);
+                return buffer;
+            }
+            default:
+                return std::to_string(value);
+        }
+    };
+
+    std::string result = std::string(fieldName(condition.field)) + ":";
+    if (condition.low == condition.high) return result + format(condition.low);
+    if (condition.low == kLowest) return result + "<=" + format(condition.high);
+    if (condition.high == kHighest) return result + ">=" + format(condition.low);
+    return result + format(condition.low) + ".." + format(condition.high);
+}
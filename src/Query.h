@@ -0,0 +1,70 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A filter over tasks or journal entries, written as space separated terms
+// that must all hold:
+//
+//   priority:high difficulty:easy created:>2026-09-01 text:"report"
+//
+// field:value matches the value, field:>v, >=, < and <= compare, and
+// field:a..b is an inclusive range. A date is YYYY-MM-DD, today, yesterday or
+// Nd (N days ago) and stands for that whole local day, so created:>2026-09-01
+// starts on the 2nd. Bare words and text:"..." are matched by the search
+// index, typos included.
+//
+//   Tasks:   priority (low|medium|high), difficulty (easy|medium|hard),
+//            done (yes|no), is:open, is:done, created, completed
+//   Journal: mood (very_low|low|neutral|good|excellent or 1..5),
+//            created (alias date), sentiment (-1..1)
+class Query {
+public:
+    enum class Target {
+        TASKS,
+        MOODS
+    };
+
+    // Every field is indexed as an integer key
+    enum Field : uint8_t {
+        PRIORITY,       // 1..3
+        DIFFICULTY,     // 1..3
+        DONE,           // 0 or 1
+        CREATED,        // Task creation or journal entry time
+        COMPLETED,      // Completion time; open tasks have none
+        MOOD,           // 1..5
+        SENTIMENT,      // Thousandths
+        FIELD_COUNT
+    };
+
+    // low <= value <= high
+    struct Condition {
+        Field field;
+        int64_t low;
+        int64_t high;
+    };
+
+    Target target;
+    std::vector<Condition> conditions;
+    std::string text;       // Text terms joined by spaces; empty when there are none
+
+    Query() : target(Target::TASKS) {}
+
+    // Nothing to filter on; callers list records directly instead of asking the engine
+    bool empty() const { return conditions.empty() && text.empty(); }
+
+    // False with a message in error when source doesn't parse; relative dates count from now
+    static bool parse(std::string_view source, Target target, Query& query, std::string& error,
+                      time_t now = time(nullptr));
+
+    static const char* fieldName(Field field);
+    static bool appliesTo(Field field, Target target);
+    // The same condition written back in query syntax
+    static std::string describe(const Condition& condition);
+};
+
+#endif // QUERY_H
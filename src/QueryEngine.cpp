@@ -0,0 +1,315 @@
+#include "QueryEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+
+namespace {
+
+// Narrowing step of a plan: one condition, or the text search when condition is null
+struct Step {
+    const Query::Condition* condition;
+    size_t rows;
+};
+
+std::string describeStep(const Step& step, const std::string& text) {
+    return step.condition ? Query::describe(*step.condition) : "text:\"" + text + "\"";
+}
+
+} // namespace
+
+QueryEngine::QueryEngine(const SearchIndex* searchIndex) : searchIndex(searchIndex) {
+    // Fields that don't apply to a table aren't indexed; queries can't name them
+    for (int field = 0; field < Query::FIELD_COUNT; ++field) {
+        tasks.indexed[field] = Query::appliesTo(static_cast<Query::Field>(field), Query::Target::TASKS);
+        moods.indexed[field] = Query::appliesTo(static_cast<Query::Field>(field), Query::Target::MOODS);
+    }
+}
+
+void QueryEngine::FieldIndex::insert(int64_t value, int32_t id) {
+    std::pair<int64_t, int32_t> entry(value, id);
+    entries.insert(std::lower_bound(entries.begin(), entries.end(), entry), entry);
+}
+
+void QueryEngine::FieldIndex::erase(int64_t value, int32_t id) {
+    std::pair<int64_t, int32_t> entry(value, id);
+    auto found = std::lower_bound(entries.begin(), entries.end(), entry);
+    if (found != entries.end() && *found == entry) {
+        entries.erase(found);
+    }
+}
+
+size_t QueryEngine::FieldIndex::count(int64_t low, int64_t high) const {
+    if (low > high) return 0;
+    auto first = std::lower_bound(entries.begin(), entries.end(), std::make_pair(low, INT32_MIN));
+    auto last = std::upper_bound(first, entries.end(), std::make_pair(high, INT32_MAX));
+    return static_cast<size_t>(last - first);
+}
+
+void QueryEngine::FieldIndex::collect(int64_t low, int64_t high, std::vector<int32_t>& ids) const {
+    ids.clear();
+    if (low > high) return;
+    auto first = std::lower_bound(entries.begin(), entries.end(), std::make_pair(low, INT32_MIN));
+    auto last = std::upper_bound(first, entries.end(), std::make_pair(high, INT32_MAX));
+    ids.reserve(last - first);
+    for (auto it = first; it != last; ++it) {
+        ids.push_back(it->second);
+    }
+    // Ids come out grouped by value; merging needs them in id order. Time
+    // ranges usually come out sorted already, since ids grow with time.
+    if (!std::is_sorted(ids.begin(), ids.end())) {
+        std::sort(ids.begin(), ids.end());
+    }
+}
+
+void QueryEngine::rowOf(const Task& task, Row& row) {
+    std::fill(row, row + Query::FIELD_COUNT, 0);
+    row[Query::PRIORITY] = static_cast<int64_t>(task.priority);
+    row[Query::DIFFICULTY] = static_cast<int64_t>(task.difficulty);
+    row[Query::DONE] = task.completed ? 1 : 0;
+    row[Query::CREATED] = static_cast<int64_t>(task.created);
+    row[Query::COMPLETED] = task.completed ? static_cast<int64_t>(task.completed_time) : 0;
+}
+
+void QueryEngine::rowOf(const MoodEntry& entry, Row& row) {
+    std::fill(row, row + Query::FIELD_COUNT, 0);
+    row[Query::CREATED] = static_cast<int64_t>(entry.timestamp);
+    row[Query::MOOD] = static_cast<int64_t>(entry.mood);
+    row[Query::SENTIMENT] = std::llround(entry.sentimentScore * 1000.0);
+}
+
+void QueryEngine::reset(Table& table) {
+    table.rows.clear();
+    table.values.clear();
+    table.freeSlots.clear();
+    for (auto& field : table.fields) {
+        field.entries.clear();
+    }
+}
+
+void QueryEngine::upsert(Table& table, int32_t id, const Row& row) {
+    auto found = table.rows.find(id);
+    size_t slot;
+    if (found != table.rows.end()) {
+        slot = found->second;
+        const int64_t* old = &table.values[slot * Query::FIELD_COUNT];
+        for (int field = 0; field < Query::FIELD_COUNT; ++field) {
+            if (table.indexed[field] && old[field] != row[field]) {
+                table.fields[field].erase(old[field], id);
+                table.fields[field].insert(row[field], id);
+            }
+        }
+    } else {
+        if (!table.freeSlots.empty()) {
+            slot = table.freeSlots.back();
+            table.freeSlots.pop_back();
+        } else {
+            slot = table.values.size() / Query::FIELD_COUNT;
+            table.values.resize(table.values.size() + Query::FIELD_COUNT);
+        }
+        table.rows.emplace(id, slot);
+        for (int field = 0; field < Query::FIELD_COUNT; ++field) {
+            if (table.indexed[field]) table.fields[field].insert(row[field], id);
+        }
+    }
+    std::copy(row, row + Query::FIELD_COUNT, &table.values[slot * Query::FIELD_COUNT]);
+}
+
+void QueryEngine::remove(Table& table, int32_t id) {
+    auto found = table.rows.find(id);
+    if (found == table.rows.end()) return;
+    const int64_t* old = &table.values[found->second * Query::FIELD_COUNT];
+    for (int field = 0; field < Query::FIELD_COUNT; ++field) {
+        if (table.indexed[field]) table.fields[field].erase(old[field], id);
+    }
+    table.freeSlots.push_back(found->second);
+    table.rows.erase(found);
+}
+
+void QueryEngine::tasksLoaded(const std::vector<Task>& loaded) {
+    // Bulk build: one sort per field instead of a sorted insert per task
+    reset(tasks);
+    tasks.values.resize(loaded.size() * Query::FIELD_COUNT);
+    for (int field = 0; field < Query::FIELD_COUNT; ++field) {
+        if (tasks.indexed[field]) tasks.fields[field].entries.reserve(loaded.size());
+    }
+    size_t slot = 0;
+    for (const auto& task : loaded) {
+        if (!tasks.rows.emplace(task.id, slot).second) continue;    // Storage renumbers repeated ids; never indexed twice
+        Row row;
+        rowOf(task, row);
+        std::copy(row, row + Query::FIELD_COUNT, &tasks.values[slot * Query::FIELD_COUNT]);
+        for (int field = 0; field < Query::FIELD_COUNT; ++field) {
+            if (tasks.indexed[field]) tasks.fields[field].entries.emplace_back(row[field], task.id);
+        }
+        ++slot;
+    }
+    tasks.values.resize(slot * Query::FIELD_COUNT);
+    for (auto& field : tasks.fields) {
+        std::sort(field.entries.begin(), field.entries.end());
+    }
+    tasks.loaded = true;
+}
+
+void QueryEngine::taskSaved(const Task& task) {
+    Row row;
+    rowOf(task, row);
+    upsert(tasks, task.id, row);
+}
+
+void QueryEngine::taskRemoved(int taskId) {
+    remove(tasks, taskId);
+}
+
+void QueryEngine::moodsLoaded(const std::vector<MoodEntry>& entries) {
+    reset(moods);
+    moods.values.resize(entries.size() * Query::FIELD_COUNT);
+    for (int field = 0; field < Query::FIELD_COUNT; ++field) {
+        if (moods.indexed[field]) moods.fields[field].entries.reserve(entries.size());
+    }
+    size_t slot = 0;
+    for (const auto& entry : entries) {
+        if (!moods.rows.emplace(entry.id, slot).second) continue;
+        Row row;
+        rowOf(entry, row);
+        std::copy(row, row + Query::FIELD_COUNT, &moods.values[slot * Query::FIELD_COUNT]);
+        for (int field = 0; field < Query::FIELD_COUNT; ++field) {
+            if (moods.indexed[field]) moods.fields[field].entries.emplace_back(row[field], entry.id);
+        }
+        ++slot;
+    }
+    moods.values.resize(slot * Query::FIELD_COUNT);
+    for (auto& field : moods.fields) {
+        std::sort(field.entries.begin(), field.entries.end());
+    }
+    moods.loaded = true;
+}
+
+void QueryEngine::moodSaved(const MoodEntry& entry) {
+    Row row;
+    rowOf(entry, row);
+    upsert(moods, entry.id, row);
+}
+
+void QueryEngine::moodUpdated(const MoodEntry& entry) {
+    moodSaved(entry);
+}
+
+void QueryEngine::moodRemoved(int entryId) {
+    remove(moods, entryId);
+}
+
+int64_t QueryEngine::valueOf(Query::Target target, int id, Query::Field field) const {
+    const Table& table = target == Query::Target::TASKS ? tasks : moods;
+    auto found = table.rows.find(id);
+    if (found == table.rows.end() || field >= Query::FIELD_COUNT) return 0;
+    return table.values[found->second * Query::FIELD_COUNT + field];
+}
+
+bool QueryEngine::execute(const Query& query, std::vector<int>& ids, std::vector<std::string>* plan) const {
+    const Table& table = query.target == Query::Target::TASKS ? tasks : moods;
+    ids.clear();
+
+    std::vector<Step> steps;
+    for (const auto& condition : query.conditions) {
+        steps.push_back({&condition, table.fields[condition.field].count(condition.low, condition.high)});
+    }
+
+    // The text search has no cheap estimate, so it runs up front and its exact size competes
+    std::vector<SearchIndex::Hit> hits;
+    std::vector<int32_t> textIds;
+    if (!query.text.empty()) {
+        if (!searchIndex) {
+            std::cerr << "Error: Text queries need a search index" << std::endl;
+            return false;
+        }
+        SearchIndex::Kind kind = query.target == Query::Target::TASKS ? SearchIndex::TASK : SearchIndex::MOOD;
+        hits = searchIndex->search(query.text, table.rows.size(), kind);
+        for (const auto& hit : hits) {
+            if (table.rows.count(hit.id)) textIds.push_back(hit.id);
+        }
+        std::sort(textIds.begin(), textIds.end());
+        steps.push_back({nullptr, textIds.size()});
+    }
+    std::stable_sort(steps.begin(), steps.end(), [](const Step& a, const Step& b) { return a.rows < b.rows; });
+
+    std::vector<int32_t> candidates;
+    if (steps.empty()) {
+        candidates.reserve(table.rows.size());
+        for (const auto& row : table.rows) {
+            candidates.push_back(row.first);
+        }
+        std::sort(candidates.begin(), candidates.end());
+        if (plan) plan->push_back("scan all " + std::to_string(candidates.size()) + " ids (no conditions)");
+    } else if (steps[0].condition) {
+        const Query::Condition& condition = *steps[0].condition;
+        table.fields[condition.field].collect(condition.low, condition.high, candidates);
+    } else {
+        candidates = textIds;
+    }
+    if (plan && !steps.empty()) {
+        plan->push_back("start from " + describeStep(steps[0], query.text) + ": " +
+                        std::to_string(candidates.size()) + " rows");
+    }
+
+    // Merge while a step has no more rows than there are candidates; after
+    // that every remaining step is checked in one pass over the candidates,
+    // reading each candidate's row once
+    std::vector<int32_t> matched;
+    std::vector<int32_t> narrowed;
+    size_t next = 1;
+    for (; next < steps.size() && !candidates.empty(); ++next) {
+        const Step& step = steps[next];
+        if (step.condition && step.rows > candidates.size()) break;
+        const std::vector<int32_t>* other = &textIds;
+        if (step.condition) {
+            table.fields[step.condition->field].collect(step.condition->low, step.condition->high, matched);
+            other = &matched;
+        }
+        size_t before = candidates.size();
+        narrowed.clear();
+        std::set_intersection(candidates.begin(), candidates.end(), other->begin(), other->end(),
+                              std::back_inserter(narrowed));
+        candidates.swap(narrowed);
+        if (plan) {
+            plan->push_back("merge " + describeStep(step, query.text) + " (" + std::to_string(step.rows) +
+                            " rows): " + std::to_string(before) + " -> " + std::to_string(candidates.size()));
+        }
+    }
+    if (next < steps.size() && !candidates.empty()) {
+        size_t before = candidates.size();
+        size_t kept = 0;
+        for (int32_t id : candidates) {
+            const int64_t* row = &table.values[table.rows.at(id) * Query::FIELD_COUNT];
+            bool keep = true;
+            for (size_t i = next; i < steps.size() && keep; ++i) {
+                const Query::Condition* condition = steps[i].condition;
+                keep = condition ? row[condition->field] >= condition->low && row[condition->field] <= condition->high
+                                 : std::binary_search(textIds.begin(), textIds.end(), id);
+            }
+            if (keep) candidates[kept++] = id;
+        }
+        candidates.resize(kept);
+        if (plan) {
+            std::string checked;
+            for (size_t i = next; i < steps.size(); ++i) {
+                checked += (i > next ? ", " : "") + describeStep(steps[i], query.text);
+            }
+            plan->push_back("probe " + checked + ": " + std::to_string(before) + " -> " +
+                            std::to_string(candidates.size()));
+        }
+    } else if (next < steps.size() && plan) {
+        plan->push_back("stop: no rows left");
+    }
+
+    if (query.text.empty()) {
+        ids.assign(candidates.begin(), candidates.end());
+    } else {
+        for (const auto& hit : hits) {
+            if (std::binary_search(candidates.begin(), candidates.end(), hit.id)) {
+                ids.push_back(hit.id);
+            }
+        }
+    }
+    return true;
+}
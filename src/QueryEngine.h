@@ -0,0 +1,82 @@
+#ifndef QUERY_ENGINE_H
+#define QUERY_ENGINE_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Query.h"
+#include "SearchIndex.h"
+#include "Storage.h"
+
+// Runs Query filters against secondary indexes kept current through
+// StorageListener, without loading or scanning records.
+//
+// Every field of every task and journal entry sits in a sorted (value, id)
+// index, so a condition's row count is two binary searches. The plan starts
+// from the condition (or text search) with the fewest rows and narrows the
+// candidates with each remaining condition in turn: small ones by merging
+// their sorted ids, large ones by probing each candidate's indexed values.
+// Only an empty query visits every id.
+//
+// Journal entries are indexed from full loads (loadMoodEntries) and writes,
+// like SearchIndex; text conditions need a SearchIndex.
+class QueryEngine : public StorageListener {
+public:
+    explicit QueryEngine(const SearchIndex* searchIndex = nullptr);
+
+    // Matching ids, best text match first when the query has text and in id
+    // (creation) order otherwise. Appends one line per plan step to plan when given.
+    bool execute(const Query& query, std::vector<int>& ids, std::vector<std::string>* plan = nullptr) const;
+
+    // False until a full load of that kind has been seen; until then results would be partial
+    bool covers(Query::Target target) const { return (target == Query::Target::TASKS ? tasks : moods).loaded; }
+    // Indexed value of one field of a task or entry; 0 when the id isn't indexed
+    int64_t valueOf(Query::Target target, int id, Query::Field field) const;
+    size_t taskCount() const { return tasks.rows.size(); }
+    size_t moodCount() const { return moods.rows.size(); }
+
+    // StorageListener
+    void tasksLoaded(const std::vector<Task>& loaded) override;
+    void taskSaved(const Task& task) override;
+    void taskRemoved(int taskId) override;
+    void moodsLoaded(const std::vector<MoodEntry>& entries) override;
+    void moodSaved(const MoodEntry& entry) override;
+    void moodUpdated(const MoodEntry& entry) override;
+    void moodRemoved(int entryId) override;
+
+private:
+    typedef int64_t Row[Query::FIELD_COUNT];
+
+    // Sorted (value, id) pairs of one field
+    struct FieldIndex {
+        std::vector<std::pair<int64_t, int32_t>> entries;
+
+        void insert(int64_t value, int32_t id);
+        void erase(int64_t value, int32_t id);
+        size_t count(int64_t low, int64_t high) const;
+        void collect(int64_t low, int64_t high, std::vector<int32_t>& ids) const;
+    };
+
+    struct Table {
+        std::unordered_map<int32_t, size_t> rows;   // id -> slot in values
+        std::vector<int64_t> values;                // FIELD_COUNT per slot
+        std::vector<int32_t> freeSlots;
+        FieldIndex fields[Query::FIELD_COUNT];
+        bool indexed[Query::FIELD_COUNT];
+        bool loaded = false;
+    };
+
+    const SearchIndex* searchIndex;
+    Table tasks;
+    Table moods;
+
+    static void rowOf(const Task& task, Row& row);
+    static void rowOf(const MoodEntry& entry, Row& row);
+    static void reset(Table& table);
+    static void upsert(Table& table, int32_t id, const Row& row);
+    static void remove(Table& table, int32_t id);
+};
+
+#endif // QUERY_ENGINE_H
@@ -0,0 +1,118 @@
+#include "RecommendationPanel.h"
+#include <QTimer>
+
+RecommendationPanel::RecommendationPanel(Storage* storage, const TaskRanker* ranker, const CompletionModel* model,
+                                         QWidget *parent)
+    : QWidget(parent), storage(storage), ranker(ranker), model(model), refreshPending(false)
+{
+    setupUI();
+    storage->addListener(this);
+}
+
+RecommendationPanel::~RecommendationPanel()
+{
+    storage->removeListener(this);
+}
+
+void RecommendationPanel::setupUI()
+{
+    mainLayout = new QVBoxLayout(this);
+    mainLayout->setContentsMargins(0, 0, 0, 0);
+    
+    // Title
+    titleLabel = new QLabel("🎯 Suggested for Right Now", this);
+    titleLabel->setStyleSheet(
+        "QLabel { "
+        "   font-size: 18px; "
+        "   font-weight: bold; "
+        "   color: #666; "
+        "   text-align: center;"
+        "}"
+    );
+    titleLabel->setAlignment(Qt::AlignCenter);
+    mainLayout->addWidget(titleLabel);
+    
+    // Ranked task list
+    recommendationList = new QListWidget(this);
+    recommendationList->setStyleSheet(
+        "QListWidget { "
+        "   border: 2px solid #e9ecef; "
+        "   border-radius: 8px; "
+        "   padding: 8px; "
+        "   background-color: #f8f9fa; "
+        "   color: #495057; "
+        "   font-size: 14px; "
+        "   max-height: 140px; "
+        "}"
+        "QListWidget::item { "
+        "   padding: 4px; "
+        "}"
+    );
+    mainLayout->addWidget(recommendationList);
+    
+    refreshRecommendations();
+}
+
+void RecommendationPanel::refreshRecommendations()
+{
+    refreshPending = false;
+    recommendationList->clear();
+    
+    // Reads straight from the maintained ranking; nothing is reloaded or copied
+    std::vector<std::pair<const RankedTask*, double>> best;
+    if (model->trained()) {
+        best = model->likeliest(*ranker, 5);
+    } else {
+        for (const RankedTask* task : ranker->top(5)) {
+            best.emplace_back(task, -1.0);
+        }
+    }
+    if (best.empty()) {
+        recommendationList->addItem("🎉 No pending tasks - enjoy the breathing room!");
+        return;
+    }
+    
+    for (const auto& pick : best) {
+        const RankedTask* task = pick.first;
+        QString difficulty;
+        switch (task->difficulty) {
+            case TaskDifficulty::EASY: difficulty = "Easy"; break;
+            case TaskDifficulty::HARD: difficulty = "Hard"; break;
+            default: difficulty = "Medium"; break;
+        }
+        QString text = QString("• %1 (%2)").arg(QString::fromStdString(task->title), difficulty);
+        if (pick.second >= 0.0) {
+            text += QString(" - %1% likely now").arg(static_cast<int>(pick.second * 100.0 + 0.5));
+        }
+        recommendationList->addItem(text);
+    }
+}
+
+void RecommendationPanel::scheduleRefresh()
+{
+    // Coalesce bursts of writes, and let the ranker see each write first
+    if (!refreshPending) {
+        refreshPending = true;
+        QTimer::singleShot(0, this, &RecommendationPanel::refreshRecommendations);
+    }
+}
+
+void RecommendationPanel::tasksLoaded(const std::vector<Task>&)
+{
+    scheduleRefresh();
+}
+
+void RecommendationPanel::taskSaved(const Task&)
+{
+    scheduleRefresh();
+}
+
+void RecommendationPanel::taskRemoved(int)
+{
+    scheduleRefresh();
+}
+
+void RecommendationPanel::moodSaved(const MoodEntry&)
+{
+    scheduleRefresh();
+}
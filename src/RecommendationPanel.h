@@ -0,0 +1,49 @@
+#ifndef RECOMMENDATIONPANEL_H
+#define RECOMMENDATIONPANEL_H
+
+#include <QWidget>
+#include <QVBoxLayout>
+#include <QLabel>
+#include <QListWidget>
+#include "Storage.h"
+#include "TaskRanker.h"
+#include "CompletionModel.h"
+
+// Shows the tasks the user is likeliest to finish now (the ranker's best few
+// until the completion model has enough history). Listens to Storage
+// so it stays current while other pages add or complete tasks.
+class RecommendationPanel : public QWidget, public StorageListener
+{
+    Q_OBJECT
+
+public:
+    RecommendationPanel(Storage* storage, const TaskRanker* ranker, const CompletionModel* model,
+                        QWidget *parent = nullptr);
+    ~RecommendationPanel();
+    
+    // StorageListener
+    void tasksLoaded(const std::vector<Task>& tasks) override;
+    void taskSaved(const Task& task) override;
+    void taskRemoved(int taskId) override;
+    void moodSaved(const MoodEntry& entry) override;
+
+public slots:
+    void refreshRecommendations();
+
+private:
+    void setupUI();
+    void scheduleRefresh();
+    
+    // UI elements
+    QVBoxLayout *mainLayout;
+    QLabel *titleLabel;
+    QListWidget *recommendationList;
+    
+    // Storage connection
+    Storage *storage;
+    const TaskRanker *ranker;
+    const CompletionModel *model;
+    bool refreshPending;
+};
+
+#endif // RECOMMENDATIONPANEL_H
@@ -0,0 +1,131 @@
+#include "RecordColumns.h"
+#include "Storage.h"
+
+void TaskColumns::clear() {
+    ids.clear();
+    created.clear();
+    completedTime.clear();
+    priority.clear();
+    difficulty.clear();
+    completed.clear();
+    edits.clear();
+    ++revision;
+    ++rewrites;
+}
+
+void TaskColumns::reserve(size_t count) {
+    ids.reserve(count);
+    created.reserve(count);
+    completedTime.reserve(count);
+    priority.reserve(count);
+    difficulty.reserve(count);
+    completed.reserve(count);
+}
+
+void TaskColumns::append(const Task& task) {
+    ids.push_back(task.id);
+    created.push_back(static_cast<int64_t>(task.created));
+    completedTime.push_back(static_cast<int64_t>(task.completed_time));
+    priority.push_back(static_cast<uint8_t>(task.priority));
+    difficulty.push_back(static_cast<uint8_t>(task.difficulty));
+    completed.push_back(task.completed ? 1 : 0);
+    ++revision;
+}
+
+void TaskColumns::set(size_t row, const Task& task) {
+    TaskRowEdit& edit = logEdit(row, false);
+    edit.newCompletedTime = static_cast<int64_t>(task.completed_time);
+    edit.newDifficulty = static_cast<uint8_t>(task.difficulty);
+    edit.newCompleted = task.completed ? 1 : 0;
+    ids[row] = task.id;
+    created[row] = static_cast<int64_t>(task.created);
+    completedTime[row] = static_cast<int64_t>(task.completed_time);
+    priority[row] = static_cast<uint8_t>(task.priority);
+    difficulty[row] = static_cast<uint8_t>(task.difficulty);
+    completed[row] = task.completed ? 1 : 0;
+    ++revision;
+    ++rewrites;
+}
+
+void TaskColumns::erase(size_t row) {
+    logEdit(row, true);
+    ids.erase(ids.begin() + row);
+    created.erase(created.begin() + row);
+    completedTime.erase(completedTime.begin() + row);
+    priority.erase(priority.begin() + row);
+    difficulty.erase(difficulty.begin() + row);
+    completed.erase(completed.begin() + row);
+    ++revision;
+    ++rewrites;
+}
+
+TaskRowEdit& TaskColumns::logEdit(size_t row, bool erased) {
+    if (edits.size() >= kEditLog) {
+        edits.erase(edits.begin());
+    }
+    TaskRowEdit edit{};
+    edit.rewrite = rewrites + 1;        // The caller bumps rewrites after this
+    edit.row = row;
+    edit.erased = erased;
+    edit.oldCompletedTime = completedTime[row];
+    edit.oldDifficulty = difficulty[row];
+    edit.oldCompleted = completed[row];
+    edits.push_back(edit);
+    return edits.back();
+}
+
+long TaskColumns::find(int id) const {
+    for (size_t row = 0; row < ids.size(); ++row) {
+        if (ids[row] == id) return static_cast<long>(row);
+    }
+    return -1;
+}
+
+void MoodColumns::clear() {
+    ids.clear();
+    timestamps.clear();
+    mood.clear();
+    sentiment.clear();
+    ++revision;
+    ++rewrites;
+}
+
+void MoodColumns::reserve(size_t count) {
+    ids.reserve(count);
+    timestamps.reserve(count);
+    mood.reserve(count);
+    sentiment.reserve(count);
+}
+
+void MoodColumns::append(const MoodEntry& entry) {
+    ids.push_back(entry.id);
+    timestamps.push_back(static_cast<int64_t>(entry.timestamp));
+    mood.push_back(static_cast<uint8_t>(entry.mood));
+    sentiment.push_back(static_cast<float>(entry.sentimentScore));
+    ++revision;
+}
+
+void MoodColumns::set(size_t row, const MoodEntry& entry) {
+    ids[row] = entry.id;
+    timestamps[row] = static_cast<int64_t>(entry.timestamp);
+    mood[row] = static_cast<uint8_t>(entry.mood);
+    sentiment[row] = static_cast<float>(entry.sentimentScore);
+    ++revision;
+    ++rewrites;
+}
+
+void MoodColumns::erase(size_t row) {
+    ids.erase(ids.begin() + row);
+    timestamps.erase(timestamps.begin() + row);
+    mood.erase(mood.begin() + row);
+    sentiment.erase(sentiment.begin() + row);
+    ++revision;
+    ++rewrites;
+}
+
+long MoodColumns::find(int id) const {
+    for (size_t row = 0; row < ids.size(); ++row) {
+        if (ids[row] == id) return static_cast<long>(row);
+    }
+    return -1;
+}
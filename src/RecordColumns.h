@@ -0,0 +1,71 @@
+#ifndef RECORD_COLUMNS_H
+#define RECORD_COLUMNS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct Task;
+struct MoodEntry;
+
+// One set() or erase() of an existing row, old and new values side by side, so
+// a reader that already folded the row in can undo it instead of rescanning
+struct TaskRowEdit {
+    uint64_t rewrite;                   // TaskColumns::rewrites right after the edit
+    size_t row;
+    bool erased;                        // erase(); the new values are unused
+    int64_t oldCompletedTime;
+    int64_t newCompletedTime;
+    uint8_t oldDifficulty;
+    uint8_t newDifficulty;
+    uint8_t oldCompleted;
+    uint8_t newCompleted;
+};
+
+// Structure-of-arrays mirror of the task list. Analytics only need a few
+// small fields per task, so scanning these columns touches a fraction of the
+// memory a std::vector<Task> scan would.
+struct TaskColumns {
+    std::vector<int32_t> ids;
+    std::vector<int64_t> created;
+    std::vector<int64_t> completedTime;
+    std::vector<uint8_t> priority;      // Priority as 1..3
+    std::vector<uint8_t> difficulty;    // TaskDifficulty as 1..3
+    std::vector<uint8_t> completed;     // 0 or 1
+    uint64_t revision = 0;              // Bumped on every change
+    uint64_t rewrites = 0;              // Bumped when existing rows change or move
+    std::vector<TaskRowEdit> edits;     // The last kEditLog set()/erase() calls, oldest first; clear() empties it
+
+    static const size_t kEditLog = 1024;
+
+    size_t size() const { return ids.size(); }
+    void clear();
+    void reserve(size_t count);
+    void append(const Task& task);
+    void set(size_t row, const Task& task);
+    void erase(size_t row);
+    long find(int id) const;            // First row with this id, or -1
+
+private:
+    TaskRowEdit& logEdit(size_t row, bool erased);
+};
+
+// Structure-of-arrays mirror of the mood history
+struct MoodColumns {
+    std::vector<int32_t> ids;
+    std::vector<int64_t> timestamps;
+    std::vector<uint8_t> mood;          // MoodLevel as 1..5
+    std::vector<float> sentiment;
+    uint64_t revision = 0;
+    uint64_t rewrites = 0;
+
+    size_t size() const { return ids.size(); }
+    void clear();
+    void reserve(size_t count);
+    void append(const MoodEntry& entry);
+    void set(size_t row, const MoodEntry& entry);
+    void erase(size_t row);
+    long find(int id) const;
+};
+
+#endif // RECORD_COLUMNS_H
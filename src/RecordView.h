@@ -0,0 +1,88 @@
+#ifndef RECORD_VIEW_H
+#define RECORD_VIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+// Read-only run of records owned elsewhere, e.g. Storage's resident store.
+// Stands in for std::span<const Record> until the tree moves past C++17.
+template <typename Record>
+class RecordSpan {
+private:
+    const Record* first;
+    size_t count;
+
+public:
+    RecordSpan() : first(nullptr), count(0) {}
+    RecordSpan(const Record* first, size_t count) : first(first), count(count) {}
+    RecordSpan(const std::vector<Record>& records) : first(records.data()), count(records.size()) {}
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const Record* data() const { return first; }
+    const Record& operator[](size_t i) const { return first[i]; }
+    const Record& front() const { return first[0]; }
+    const Record& back() const { return first[count - 1]; }
+    const Record* begin() const { return first; }
+    const Record* end() const { return first + count; }
+};
+
+// The records of a span that pass a filter, kept as positions instead of
+// copies. select() reuses the position buffer, so filtering the same view
+// again doesn't allocate. The source must outlive the view and not be
+// resized while the view is in use.
+template <typename Record>
+class RecordView {
+private:
+    const Record* records;
+    std::vector<uint32_t> positions;
+
+public:
+    class Iterator {
+    private:
+        const Record* records;
+        const uint32_t* position;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Record;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Record*;
+        using reference = const Record&;
+
+        Iterator(const Record* records, const uint32_t* position) : records(records), position(position) {}
+
+        const Record& operator*() const { return records[*position]; }
+        const Record* operator->() const { return &records[*position]; }
+        Iterator& operator++() { ++position; return *this; }
+        Iterator operator++(int) { Iterator before = *this; ++position; return before; }
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.position == b.position; }
+        friend bool operator!=(const Iterator& a, const Iterator& b) { return a.position != b.position; }
+    };
+
+    RecordView() : records(nullptr) {}
+
+    template <typename Predicate>
+    RecordView& select(RecordSpan<Record> source, Predicate predicate) {
+        records = source.data();
+        positions.clear();
+        for (size_t i = 0; i < source.size(); ++i) {
+            if (predicate(source[i])) positions.push_back(static_cast<uint32_t>(i));
+        }
+        return *this;
+    }
+
+    size_t size() const { return positions.size(); }
+    bool empty() const { return positions.empty(); }
+    const Record& operator[](size_t i) const { return records[positions[i]]; }
+    const Record& front() const { return records[positions.front()]; }
+    const Record& back() const { return records[positions.back()]; }
+    size_t position(size_t i) const { return positions[i]; }     // Index into the source
+
+    Iterator begin() const { return Iterator(records, positions.data()); }
+    Iterator end() const { return Iterator(records, positions.data() + positions.size()); }
+};
+
+#endif // RECORD_VIEW_H
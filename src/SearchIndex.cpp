@@ -0,0 +1,519 @@
+#include "SearchIndex.h"
+#include "Tokenizer.h"
+#include <algorithm>
+
+namespace {
+
+const char32_t kWordStart = 1;
+const char32_t kWordEnd = 2;
+// Exact matches score 1, a prefix of a longer word a bit less, each edit costs more
+const float kExactWeight = 1.0f;
+const float kPrefixWeight = 0.9f;
+const float kEditPenalty = 0.3f;
+const size_t kMinCompaction = 1024;
+
+// Three code points mixed into 32 bits; a collision only adds a candidate
+// that the edit distance check then rejects
+uint32_t gramKey(const char32_t* codePoints) {
+    uint64_t key = (static_cast<uint64_t>(codePoints[0]) << 42) | (static_cast<uint64_t>(codePoints[1]) << 21) |
+                   codePoints[2];
+    key *= 0x9E3779B97F4A7C15ULL;
+    return static_cast<uint32_t>(key >> 32);
+}
+
+// Trigrams of the word's code points padded with start and end markers. A
+// prefix leaves the end open, so its grams are a subset of those of any word
+// it starts. Code points rather than bytes, so one edit always touches at most
+// three grams whatever the script.
+void wordGrams(std::string_view word, bool prefix, std::vector<uint32_t>& grams) {
+    char32_t padded[SearchIndex::kMaxWordLength + 2];
+    padded[0] = kWordStart;
+    size_t length = 1 + Tokenizer::codePoints(word, padded + 1, SearchIndex::kMaxWordLength);
+    if (!prefix) padded[length++] = kWordEnd;
+
+    grams.clear();
+    for (size_t i = 0; i + 3 <= length; ++i) {
+        grams.push_back(gramKey(padded + i));
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+}
+
+bool startsWith(std::string_view text, std::string_view prefix) {
+    return text.size() >= prefix.size() && text.compare(0, prefix.size(), prefix) == 0;
+}
+
+} // namespace
+
+SearchIndex::SearchIndex() : deadDocuments(0), generation(0) {}
+
+uint64_t SearchIndex::keyOf(Kind kind, int id) {
+    return (static_cast<uint64_t>(kind) << 32) | static_cast<uint32_t>(id);
+}
+
+uint64_t SearchIndex::hashText(std::string_view first, std::string_view second) {
+    // FNV-1a over both fields, separated so moving text between them changes the hash
+    uint64_t hash = 1469598103934665603ULL;
+    for (char c : first) hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    hash = (hash ^ 0x1F) * 1099511628211ULL;
+    for (char c : second) hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    return hash;
+}
+
+int SearchIndex::allowedDistance(size_t codePoints) {
+    if (codePoints <= 3) return 0;
+    if (codePoints <= 7) return 1;
+    return kMaxDistance;
+}
+
+void SearchIndex::align(const char32_t* a, size_t aLength, const char32_t* b, size_t bLength, int bound,
+                        int& full, int& prefix) {
+    const int kFar = bound + 1;
+    full = kFar;
+    prefix = kFar;
+    if (aLength > kMaxWordLength) aLength = kMaxWordLength;
+    if (bLength > kMaxWordLength) bLength = kMaxWordLength;
+    // Columns past aLength + bound can't be within bound of the whole of a
+    size_t columns = std::min(bLength, aLength + bound);
+    if (columns + bound < aLength) return;
+
+    // Three rows of the DP (two back is needed for transpositions), each only
+    // computed within `bound` of the diagonal; the cells just outside the band
+    // hold kFar so the band edges read a sensible value
+    int rows[3][kMaxWordLength + 2];
+    int* previous2 = rows[0];
+    int* previous = rows[1];
+    int* current = rows[2];
+    for (size_t j = 0; j <= columns; ++j) previous[j] = j <= static_cast<size_t>(bound) ? static_cast<int>(j) : kFar;
+    previous[columns + 1] = kFar;
+
+    for (size_t i = 1; i <= aLength; ++i) {
+        size_t low = i > static_cast<size_t>(bound) ? i - bound : 1;
+        size_t high = std::min(columns, i + bound);
+        current[low - 1] = low == 1 ? static_cast<int>(i) : kFar;
+        int rowMinimum = current[low - 1];
+        for (size_t j = low; j <= high; ++j) {
+            int cost = a[i - 1] == b[j - 1] ? 0 : 1;
+            int best = std::min(std::min(previous[j] + 1, current[j - 1] + 1), previous[j - 1] + cost);
+            if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1]) {
+                best = std::min(best, previous2[j - 2] + 1);
+            }
+            current[j] = std::min(best, kFar);
+            rowMinimum = std::min(rowMinimum, current[j]);
+        }
+        if (high + 1 <= columns + 1) current[high + 1] = kFar;
+        if (rowMinimum > bound) return;
+        std::swap(previous2, previous);
+        std::swap(previous, current);
+    }
+
+    // previous is now the last row: a against every prefix of b in the band
+    size_t low = aLength > static_cast<size_t>(bound) ? aLength - bound : 0;
+    for (size_t j = low; j <= std::min(columns, aLength + bound); ++j) {
+        prefix = std::min(prefix, previous[j]);
+    }
+    if (bLength == columns) full = previous[bLength];
+}
+
+int SearchIndex::editDistance(const char32_t* a, size_t aLength, const char32_t* b, size_t bLength, int bound) {
+    int full, prefix;
+    align(a, aLength, b, bLength, bound, full, prefix);
+    return full;
+}
+
+uint32_t SearchIndex::internTerm(std::string_view term) {
+    // Reused key buffer: most words are already known, so don't build a node for them
+    termKey.assign(term.data(), term.size());
+    auto known = termIds.find(termKey);
+    if (known != termIds.end()) return known->second;
+
+    uint32_t id = static_cast<uint32_t>(terms.size());
+    auto inserted = termIds.emplace(termKey, id).first;
+    terms.push_back(&inserted->first);
+    postings.emplace_back();
+
+    std::vector<uint32_t> grams;
+    wordGrams(term, false, grams);
+    for (uint32_t gram : grams) {
+        gramTerms[gram].push_back(id);   // Ids only grow, so the lists stay sorted
+    }
+
+    char32_t codePoints[kMaxWordLength];
+    size_t length = Tokenizer::codePoints(term, codePoints, kMaxWordLength);
+    if (termsByLength.size() <= length) termsByLength.resize(length + 1);
+    termsByLength[length].push_back(id);
+    return id;
+}
+
+void SearchIndex::addDocument(uint64_t key, uint64_t textHash, std::string_view first, std::string_view second) {
+    uint32_t documentId = static_cast<uint32_t>(documents.size());
+    uint32_t termsBegin = static_cast<uint32_t>(documentTerms.size());
+
+    std::string folded;
+    for (std::string_view field : {first, second}) {
+        Tokenizer::foldCase(field, folded);
+        Tokenizer::forEachToken(folded, [&](const Tokenizer::Span& token) {
+            documentTerms.push_back(internTerm(token.in(folded)));
+        });
+    }
+
+    // Each term once per document
+    auto begin = documentTerms.begin() + termsBegin;
+    std::sort(begin, documentTerms.end());
+    documentTerms.erase(std::unique(begin, documentTerms.end()), documentTerms.end());
+    for (size_t i = termsBegin; i < documentTerms.size(); ++i) {
+        postings[documentTerms[i]].push_back(documentId);
+    }
+
+    documents.push_back(Document{key, textHash, termsBegin, static_cast<uint32_t>(documentTerms.size()),
+                                 generation, true});
+    documentByKey[key] = documentId;
+}
+
+void SearchIndex::upsert(Kind kind, int id, std::string_view first, std::string_view second) {
+    uint64_t key = keyOf(kind, id);
+    uint64_t textHash = hashText(first, second);
+
+    auto it = documentByKey.find(key);
+    if (it != documentByKey.end()) {
+        Document& document = documents[it->second];
+        if (document.textHash == textHash) {
+            document.generation = generation;
+            return;
+        }
+        document.alive = false;
+        deadDocuments++;
+        documentByKey.erase(it);
+    }
+    addDocument(key, textHash, first, second);
+    compactIfNeeded();
+}
+
+void SearchIndex::upsertTask(const Task& task) {
+    upsert(TASK, task.id, task.title, task.description);
+}
+
+void SearchIndex::upsertMood(const MoodEntry& entry) {
+    upsert(MOOD, entry.id, entry.content, std::string_view());
+}
+
+void SearchIndex::remove(Kind kind, int id) {
+    auto it = documentByKey.find(keyOf(kind, id));
+    if (it == documentByKey.end()) return;
+    documents[it->second].alive = false;
+    deadDocuments++;
+    documentByKey.erase(it);
+    compactIfNeeded();
+}
+
+void SearchIndex::sweep(Kind kind) {
+    for (Document& document : documents) {
+        if (document.alive && (document.key >> 32) == kind && document.generation != generation) {
+            document.alive = false;
+            deadDocuments++;
+            documentByKey.erase(document.key);
+        }
+    }
+    compactIfNeeded();
+}
+
+void SearchIndex::syncTasks(const std::vector<Task>& tasks) {
+    ++generation;
+    for (const auto& task : tasks) upsertTask(task);
+    sweep(TASK);
+}
+
+void SearchIndex::syncMoods(const std::vector<MoodEntry>& entries) {
+    ++generation;
+    for (const auto& entry : entries) upsertMood(entry);
+    sweep(MOOD);
+}
+
+void SearchIndex::compactIfNeeded() {
+    if (deadDocuments < kMinCompaction || deadDocuments * 4 < documents.size()) return;
+
+    // Renumbering keeps order, so the posting lists stay sorted
+    const uint32_t kGone = UINT32_MAX;
+    std::vector<uint32_t> renumbered(documents.size(), kGone);
+    std::vector<Document> liveDocuments;
+    std::vector<uint32_t> liveTerms;
+    liveDocuments.reserve(documents.size() - deadDocuments);
+    for (size_t i = 0; i < documents.size(); ++i) {
+        const Document& document = documents[i];
+        if (!document.alive) continue;
+        renumbered[i] = static_cast<uint32_t>(liveDocuments.size());
+        Document moved = document;
+        moved.termsBegin = static_cast<uint32_t>(liveTerms.size());
+        liveTerms.insert(liveTerms.end(), documentTerms.begin() + document.termsBegin,
+                         documentTerms.begin() + document.termsEnd);
+        moved.termsEnd = static_cast<uint32_t>(liveTerms.size());
+        documentByKey[document.key] = renumbered[i];
+        liveDocuments.push_back(moved);
+    }
+    for (auto& list : postings) {
+        size_t kept = 0;
+        for (uint32_t document : list) {
+            if (renumbered[document] != kGone) list[kept++] = renumbered[document];
+        }
+        list.resize(kept);
+    }
+    documents.swap(liveDocuments);
+    documentTerms.swap(liveTerms);
+    deadDocuments = 0;
+}
+
+std::vector<SearchIndex::TermMatch> SearchIndex::matchTerms(std::string_view word, bool prefix) const {
+    std::vector<TermMatch> matches;
+    char32_t query[kMaxWordLength];
+    size_t queryLength = Tokenizer::codePoints(word, query, kMaxWordLength);
+    int bound = allowedDistance(queryLength);
+
+    std::vector<uint32_t> grams;
+    wordGrams(word, prefix, grams);
+    if (grams.empty()) {
+        // A one-byte prefix has no trigram: walk the vocabulary
+        for (uint32_t term = 0; term < terms.size(); ++term) {
+            const std::string& text = *terms[term];
+            if (text == word) matches.push_back(TermMatch{term, kExactWeight, 0});
+            else if (prefix && startsWith(text, word)) matches.push_back(TermMatch{term, kPrefixWeight, 0});
+        }
+        return matches;
+    }
+
+    // Count shared trigrams per term. An edit touches at most three grams and a
+    // transposition four, so anything sharing fewer cannot be within bound.
+    std::vector<uint16_t> shared(terms.size(), 0);
+    std::vector<uint32_t> touched;
+    for (uint32_t gram : grams) {
+        auto it = gramTerms.find(gram);
+        if (it == gramTerms.end()) continue;
+        for (uint32_t term : it->second) {
+            if (shared[term]++ == 0) touched.push_back(term);
+        }
+    }
+    long needed = static_cast<long>(grams.size()) - 4L * bound;
+    if (needed < 1) {
+        // Short word: a typo can wipe out every gram, so whole-word typos are
+        // found by checking the terms of nearby lengths instead
+        size_t shortest = queryLength > static_cast<size_t>(bound) ? queryLength - bound : 0;
+        for (size_t length = shortest; length <= queryLength + bound && length < termsByLength.size(); ++length) {
+            for (uint32_t term : termsByLength[length]) {
+                if (shared[term]++ == 0) touched.push_back(term);
+            }
+        }
+        needed = 1;
+    }
+
+    char32_t candidate[kMaxWordLength];
+    for (uint32_t term : touched) {
+        if (shared[term] < needed) continue;
+        const std::string& text = *terms[term];
+        if (text == word) {
+            matches.push_back(TermMatch{term, kExactWeight, 0});
+            continue;
+        }
+        if (prefix && startsWith(text, word)) {
+            matches.push_back(TermMatch{term, kPrefixWeight, 0});
+            continue;
+        }
+        if (bound == 0) continue;
+
+        size_t candidateLength = Tokenizer::codePoints(text, candidate, kMaxWordLength);
+        int distance, prefixDistance;
+        align(query, queryLength, candidate, candidateLength, bound, distance, prefixDistance);
+        float weight = 0.0f;
+        if (distance <= bound) {
+            weight = kExactWeight - kEditPenalty * distance;
+        }
+        // Typo in a word still being typed: compare with the term's start
+        if (prefix && prefixDistance <= bound && kPrefixWeight - kEditPenalty * prefixDistance > weight) {
+            weight = kPrefixWeight - kEditPenalty * prefixDistance;
+            distance = prefixDistance;
+        }
+        if (weight > 0.0f) {
+            matches.push_back(TermMatch{term, weight, static_cast<uint8_t>(distance)});
+        }
+    }
+    return matches;
+}
+
+SearchIndex::WordHits SearchIndex::collectDocuments(const std::vector<TermMatch>& matches, unsigned kinds) const {
+    WordHits hits;
+    size_t total = 0;
+    for (const TermMatch& match : matches) total += postings[match.term].size();
+    if (total == 0) return hits;
+
+    auto wanted = [&](uint32_t document) {
+        const Document& entry = documents[document];
+        return entry.alive && (kinds & static_cast<unsigned>(entry.key >> 32)) != 0;
+    };
+
+    if (matches.size() == 1) {
+        const TermMatch& match = matches.front();
+        for (uint32_t document : postings[match.term]) {
+            if (!wanted(document)) continue;
+            hits.documents.push_back(document);
+            hits.weights.push_back(match.weight);
+            hits.distances.push_back(match.distance);
+        }
+        return hits;
+    }
+
+    if (total * 8 > documents.size()) {
+        // Broad words (short prefixes): a dense pass beats sorting millions of pairs
+        std::vector<float> best(documents.size(), 0.0f);
+        std::vector<uint8_t> bestDistance(documents.size(), 0);
+        for (const TermMatch& match : matches) {
+            for (uint32_t document : postings[match.term]) {
+                if (match.weight > best[document]) {
+                    best[document] = match.weight;
+                    bestDistance[document] = match.distance;
+                }
+            }
+        }
+        for (uint32_t document = 0; document < documents.size(); ++document) {
+            if (best[document] > 0.0f && wanted(document)) {
+                hits.documents.push_back(document);
+                hits.weights.push_back(best[document]);
+                hits.distances.push_back(bestDistance[document]);
+            }
+        }
+        return hits;
+    }
+
+    struct Posting {
+        uint32_t document;
+        float weight;
+        uint8_t distance;
+    };
+    std::vector<Posting> merged;
+    merged.reserve(total);
+    for (const TermMatch& match : matches) {
+        for (uint32_t document : postings[match.term]) {
+            if (wanted(document)) merged.push_back(Posting{document, match.weight, match.distance});
+        }
+    }
+    std::sort(merged.begin(), merged.end(), [](const Posting& a, const Posting& b) {
+        return a.document != b.document ? a.document < b.document : a.weight > b.weight;
+    });
+    for (size_t i = 0; i < merged.size(); ++i) {
+        if (i > 0 && merged[i].document == merged[i - 1].document) continue;
+        hits.documents.push_back(merged[i].document);
+        hits.weights.push_back(merged[i].weight);
+        hits.distances.push_back(merged[i].distance);
+    }
+    return hits;
+}
+
+std::vector<SearchIndex::Hit> SearchIndex::search(std::string_view query, size_t limit, unsigned kinds) const {
+    std::vector<Hit> results;
+    std::string folded = Tokenizer::foldCase(query);
+    std::vector<Tokenizer::Span> words;
+    Tokenizer::tokenize(folded, words);
+    if (words.empty() || limit == 0) return results;
+
+    // A word is still being typed unless the query ends after it
+    const Tokenizer::Span& last = words.back();
+    bool lastIsPrefix = last.offset + last.length == folded.size();
+
+    std::vector<std::vector<TermMatch>> perWord;
+    perWord.reserve(words.size());
+    size_t smallest = 0;
+    size_t smallestPostings = SIZE_MAX;
+    for (size_t i = 0; i < words.size(); ++i) {
+        bool prefix = lastIsPrefix && i + 1 == words.size();
+        perWord.push_back(matchTerms(words[i].in(folded), prefix));
+        if (perWord.back().empty()) return results;
+
+        size_t postingCount = 0;
+        for (const TermMatch& match : perWord.back()) postingCount += postings[match.term].size();
+        if (postingCount < smallestPostings) {
+            smallest = i;
+            smallestPostings = postingCount;
+        }
+    }
+
+    // Only the rarest word's documents are gathered; every other word is
+    // checked against each candidate's own short term list
+    WordHits combined = collectDocuments(perWord[smallest], kinds);
+    std::vector<int> distances(combined.distances.begin(), combined.distances.end());
+    std::vector<float> termWeight;
+    std::vector<uint8_t> termDistance;
+    for (size_t w = 0; w < perWord.size() && !combined.documents.empty(); ++w) {
+        if (w == smallest) continue;
+        termWeight.assign(terms.size(), 0.0f);
+        termDistance.assign(terms.size(), 0);
+        for (const TermMatch& match : perWord[w]) {
+            termWeight[match.term] = match.weight;
+            termDistance[match.term] = match.distance;
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < combined.documents.size(); ++i) {
+            const Document& document = documents[combined.documents[i]];
+            float best = 0.0f;
+            uint8_t bestDistance = 0;
+            for (uint32_t t = document.termsBegin; t < document.termsEnd; ++t) {
+                uint32_t term = documentTerms[t];
+                if (termWeight[term] > best) {
+                    best = termWeight[term];
+                    bestDistance = termDistance[term];
+                }
+            }
+            if (best == 0.0f) continue;
+            combined.documents[kept] = combined.documents[i];
+            combined.weights[kept] = combined.weights[i] + best;
+            distances[kept] = distances[i] + bestDistance;
+            ++kept;
+        }
+        combined.documents.resize(kept);
+        combined.weights.resize(kept);
+        distances.resize(kept);
+    }
+
+    // Best score first; among equals the newer document
+    std::vector<uint32_t> order(combined.documents.size());
+    for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+    size_t count = std::min(limit, order.size());
+    std::partial_sort(order.begin(), order.begin() + count, order.end(), [&](uint32_t a, uint32_t b) {
+        if (combined.weights[a] != combined.weights[b]) return combined.weights[a] > combined.weights[b];
+        return combined.documents[a] > combined.documents[b];
+    });
+
+    results.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t slot = order[i];
+        const Document& document = documents[combined.documents[slot]];
+        results.push_back(Hit{static_cast<Kind>(document.key >> 32), static_cast<int>(static_cast<uint32_t>(document.key)),
+                              combined.weights[slot], distances[slot]});
+    }
+    return results;
+}
+
+void SearchIndex::tasksLoaded(const std::vector<Task>& tasks) {
+    syncTasks(tasks);
+}
+
+void SearchIndex::taskSaved(const Task& task) {
+    upsertTask(task);
+}
+
+void SearchIndex::taskRemoved(int taskId) {
+    remove(TASK, taskId);
+}
+
+void SearchIndex::moodsLoaded(const std::vector<MoodEntry>& entries) {
+    syncMoods(entries);
+}
+
+void SearchIndex::moodSaved(const MoodEntry& entry) {
+    upsertMood(entry);
+}
+
+void SearchIndex::moodUpdated(const MoodEntry& entry) {
+    upsertMood(entry);
+}
+
+void SearchIndex::moodRemoved(int entryId) {
+    remove(MOOD, entryId);
+}
@@ -0,0 +1,122 @@
+#ifndef SEARCH_INDEX_H
+#define SEARCH_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Storage.h"
+
+// Typo-tolerant word search over task titles, descriptions and journal text.
+//
+// Every distinct folded word is a term; each term has a posting list of the
+// documents containing it, and each trigram of a term points back at the
+// terms containing it. A query word collects the terms that share enough
+// trigrams with it (for short words, the terms of similar length), keeps
+// those within a bounded edit distance (adjacent
+// transpositions count as one edit, so "groceires" finds "groceries") and
+// merges their postings. The last query word also matches as a prefix so
+// results follow the user while they type. Every query word has to match.
+//
+// Kept current through StorageListener. Removals only mark the document dead;
+// postings are compacted once a quarter of the documents are dead.
+class SearchIndex : public StorageListener {
+public:
+    enum Kind : uint8_t {
+        TASK = 1,
+        MOOD = 2
+    };
+
+    struct Hit {
+        Kind kind;
+        int id;
+        double score;       // Higher is better; about 1 per query word for exact matches
+        int distance;       // Total edits across the query words
+    };
+
+    static const int kMaxDistance = 2;
+    // Words longer than this are compared on their first kMaxWordLength code points
+    static const size_t kMaxWordLength = 48;
+
+    SearchIndex();
+
+    void upsertTask(const Task& task);
+    void upsertMood(const MoodEntry& entry);
+    void remove(Kind kind, int id);
+    // Replaces every document of one kind, reindexing only those whose text changed
+    void syncTasks(const std::vector<Task>& tasks);
+    void syncMoods(const std::vector<MoodEntry>& entries);
+
+    // kinds is a mask of Kind values
+    std::vector<Hit> search(std::string_view query, size_t limit, unsigned kinds = TASK | MOOD) const;
+
+    size_t documentCount() const { return documents.size() - deadDocuments; }
+    size_t termCount() const { return terms.size(); }
+
+    // Edits allowed for a query word of this many code points
+    static int allowedDistance(size_t codePoints);
+    // Optimal string alignment distance, or bound + 1 once it exceeds bound
+    static int editDistance(const char32_t* a, size_t aLength, const char32_t* b, size_t bLength, int bound);
+
+    // StorageListener
+    void tasksLoaded(const std::vector<Task>& tasks) override;
+    void taskSaved(const Task& task) override;
+    void taskRemoved(int taskId) override;
+    void moodsLoaded(const std::vector<MoodEntry>& entries) override;
+    void moodSaved(const MoodEntry& entry) override;
+    void moodUpdated(const MoodEntry& entry) override;
+    void moodRemoved(int entryId) override;
+
+private:
+    struct Document {
+        uint64_t key;
+        uint64_t textHash;
+        uint32_t termsBegin;    // Range in documentTerms
+        uint32_t termsEnd;
+        uint32_t generation;    // Last sync that saw this document
+        bool alive;
+    };
+
+    struct TermMatch {
+        uint32_t term;
+        float weight;
+        uint8_t distance;
+    };
+
+    struct WordHits {
+        std::vector<uint32_t> documents;
+        std::vector<float> weights;
+        std::vector<uint8_t> distances;
+    };
+
+    std::vector<Document> documents;
+    std::vector<uint32_t> documentTerms;
+    std::unordered_map<uint64_t, uint32_t> documentByKey;
+    size_t deadDocuments;
+    uint32_t generation;
+
+    std::unordered_map<std::string, uint32_t> termIds;
+    std::vector<const std::string*> terms;              // Points at termIds keys
+    std::vector<std::vector<uint32_t>> postings;        // Term -> ascending documents
+    std::unordered_map<uint32_t, std::vector<uint32_t>> gramTerms;   // Trigram -> ascending terms
+    std::vector<std::vector<uint32_t>> termsByLength;   // Code points -> terms, for short query words
+    std::string termKey;
+
+    static uint64_t keyOf(Kind kind, int id);
+    // Banded OSA distance of a to all of b and to b's closest prefix; bound + 1 when further
+    static void align(const char32_t* a, size_t aLength, const char32_t* b, size_t bLength, int bound,
+                      int& full, int& prefix);
+    static uint64_t hashText(std::string_view first, std::string_view second);
+
+    void upsert(Kind kind, int id, std::string_view first, std::string_view second);
+    void addDocument(uint64_t key, uint64_t textHash, std::string_view first, std::string_view second);
+    uint32_t internTerm(std::string_view term);
+    void sweep(Kind kind);
+    void compactIfNeeded();
+
+    std::vector<TermMatch> matchTerms(std::string_view word, bool prefix) const;
+    WordHits collectDocuments(const std::vector<TermMatch>& matches, unsigned kinds) const;
+};
+
+#endif // SEARCH_INDEX_H
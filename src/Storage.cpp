@@ -1,12 +1,86 @@
 #include "Storage.h"
 #include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <stdexcept>
 #include <filesystem>
+#include <limits>
+#include <map>
+#include <set>
+#include <unordered_set>
+#include "Metrics.h"
+#include "Trace.h"
+#include "ThreadPool.h"
+#include "WarmSnapshot.h"
+#include <iterator>
+#include "DaemonClient.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
 
 Storage::Storage(const std::string& tasksFile, const std::string& journalFile) 
-    : tasksFile(tasksFile), journalFile(journalFile), nextTaskId(1), nextMoodId(1) {
+    : tasksFile(tasksFile), journalFile(journalFile),
+      backupDir("data/backup"), catalogFile("data/backup/catalog.txt"),
+      segmentDir("data/journal_segments"), segmentIndexFile("data/journal_segments/index.txt"),
+      summaryFile("data/stats_summary.txt"),
+      tasksSnapshotFile("data/tasks.snap"), moodsSnapshotFile("data/journal.snap"),
+      lockFile("data/moodood.lock"),
+      nextTaskId(1), nextMoodId(1), taskColsLoaded(false), moodColsLoaded(false),
+      resident(false), residentTasksLoaded(false), residentMoodsLoaded(false),
+      writerLockFd(-1), writeDepth(0) {
     initializeFiles();
 }
 
+Storage::~Storage() {
+#ifndef _WIN32
+    if (writerLockFd >= 0) close(writerLockFd); // Releases the lock
+#endif
+}
+
+// Writers take an exclusive flock on the lock file: moodood for as long as it
+// runs, anyone else just around each write, so a write can't land in the middle
+// of another's rewrite. Not having it to hand means moodood holds the data.
+class Storage::WriteAccess {
+public:
+    explicit WriteAccess(Storage& storage) : storage(storage), fd(-1), held(true), counted(false) {
+        if (storage.writerLockFd >= 0) return; // The writer itself
+        counted = true;
+        if (storage.writeDepth++ > 0) return;  // A write within a write
+#ifndef _WIN32
+        fd = open(storage.lockFile.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd >= 0 && flock(fd, LOCK_EX | LOCK_NB) != 0) {
+            held = errno != EWOULDBLOCK; // Any other failure: carry on unlocked
+            close(fd);
+            fd = -1;
+        }
+        if (!held) {
+            --storage.writeDepth;
+            counted = false;
+        }
+#endif
+    }
+    ~WriteAccess() {
+        if (counted) --storage.writeDepth;
+#ifndef _WIN32
+        if (fd >= 0) close(fd);
+#endif
+    }
+    WriteAccess(const WriteAccess&) = delete;
+    WriteAccess& operator=(const WriteAccess&) = delete;
+
+    bool elsewhere() const { return !held; }
+
+private:
+    Storage& storage;
+    int fd;
+    bool held;
+    bool counted;
+};
+
 void Storage::initializeFiles() {
     // Create data directory if it doesn't exist
     std::filesystem::create_directories("data");
@@ -29,7 +103,7 @@ std::string Storage::priorityToString(Priority priority) {
     }
 }
 
-Priority Storage::stringToPriority(const std::string& str) {
+Priority Storage::stringToPriority(std::string_view str) {
     if (str == "1") return Priority::LOW;
     if (str == "3") return Priority::HIGH;
     return Priority::MEDIUM; // default
@@ -44,7 +118,7 @@ std::string Storage::difficultyToString(TaskDifficulty difficulty) {
     }
 }
 
-TaskDifficulty Storage::stringToDifficulty(const std::string& str) {
+TaskDifficulty Storage::stringToDifficulty(std::string_view str) {
     if (str == "1") return TaskDifficulty::EASY;
     if (str == "3") return TaskDifficulty::HARD;
     return TaskDifficulty::MEDIUM; // default
@@ -61,7 +135,7 @@ std::string Storage::moodToString(MoodLevel mood) {
     }
 }
 
-MoodLevel Storage::stringToMood(const std::string& str) {
+MoodLevel Storage::stringToMood(std::string_view str) {
     if (str == "1") return MoodLevel::VERY_LOW;
     if (str == "2") return MoodLevel::LOW;
     if (str == "4") return MoodLevel::GOOD;
@@ -73,77 +147,389 @@ std::string Storage::timeToString(time_t time) {
     return std::to_string(time);
 }
 
-time_t Storage::stringToTime(const std::string& str) {
-    try {
-        return std::stol(str);
-    } catch (...) {
+time_t Storage::stringToTime(std::string_view str) {
+    long long value = 0;
+    auto result = std::from_chars(str.data(), str.data() + str.size(), value);
+    if (result.ec != std::errc() || result.ptr == str.data()) {
         return time(nullptr);
     }
+    return static_cast<time_t>(value);
+}
+
+// Loader helpers
+
+bool Storage::readFile(const std::string& path, std::string& contents) {
+    MOODOO_TRACE_SCOPE("storage", "readFile");
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    file.seekg(0, std::ios::end);
+    std::streamoff size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    contents.resize(size > 0 ? static_cast<size_t>(size) : 0);
+    if (!contents.empty()) {
+        file.read(&contents[0], static_cast<std::streamsize>(contents.size()));
+        contents.resize(static_cast<size_t>(file.gcount()));
+    }
+    Metrics::add(Metrics::BYTES_READ, contents.size());
+    return true;
+}
+
+std::vector<std::pair<size_t, size_t>> Storage::splitLines(const std::string& text, size_t maxChunks,
+                                                           size_t from) {
+    // Small files are not worth the hand-off to other threads
+    const size_t minChunkBytes = 256 * 1024;
+    size_t length = text.size() - from;
+    size_t chunkCount = std::max<size_t>(1, std::min(maxChunks, length / minChunkBytes));
+    size_t target = length / chunkCount;
+    
+    std::vector<std::pair<size_t, size_t>> chunks;
+    size_t begin = from;
+    for (size_t i = 1; i < chunkCount && begin < text.size(); ++i) {
+        size_t end = text.find('\n', std::max(begin, from + i * target));
+        if (end == std::string::npos) break;
+        chunks.emplace_back(begin, end + 1);
+        begin = end + 1;
+    }
+    chunks.emplace_back(begin, text.size());
+    return chunks;
+}
+
+void Storage::forEachLine(const std::string& text, std::pair<size_t, size_t> range,
+                          const std::function<void(std::string_view)>& visit) {
+    // Lines are handed out as views into text; nothing is copied
+    std::string_view all(text);
+    size_t pos = range.first;
+    while (pos < range.second) {
+        size_t end = all.find('\n', pos);
+        if (end == std::string_view::npos || end > range.second) end = range.second;
+        std::string_view line = all.substr(pos, end - pos);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        visit(line);
+        pos = end + 1;
+    }
+}
+
+bool Storage::nextField(std::string_view& rest, std::string_view& field, char delimiter) {
+    if (rest.empty()) {
+        return false; // Nothing after the last delimiter, same as getline
+    }
+    
+    size_t end = rest.find(delimiter);
+    if (end == std::string_view::npos) {
+        field = rest;
+        rest.remove_prefix(rest.size());
+    } else {
+        field = rest.substr(0, end);
+        rest.remove_prefix(end + 1);
+    }
+    return true;
+}
+
+namespace {
+
+int parseId(std::string_view field) {
+    int value = 0;
+    auto result = std::from_chars(field.data(), field.data() + field.size(), value);
+    if (result.ec != std::errc() || result.ptr == field.data()) {
+        throw std::invalid_argument("Invalid record id");
+    }
+    return value;
+}
+
+double parseScore(std::string_view field) {
+    // strtod needs a terminator; scores are short
+    char buffer[64];
+    if (field.empty() || field.size() >= sizeof(buffer)) return 0.0;
+    field.copy(buffer, field.size());
+    buffer[field.size()] = '\0';
+    char* end = nullptr;
+    double value = std::strtod(buffer, &end);
+    return end == buffer ? 0.0 : value;
+}
+
+// The resident store is kept in id order; a record whose id is there replaces it
+template <typename Record, typename Value>
+Record& keepInIdOrder(std::vector<Record>& records, Value&& record) {
+    auto at = std::lower_bound(records.begin(), records.end(), record.id,
+                               [](const Record& existing, int id) { return existing.id < id; });
+    if (at != records.end() && at->id == record.id) {
+        *at = std::forward<Value>(record);
+        return *at;
+    }
+    return *records.insert(at, std::forward<Value>(record));
+}
+
+template <typename Record>
+bool eraseById(std::vector<Record>& records, int id) {
+    auto at = std::lower_bound(records.begin(), records.end(), id,
+                               [](const Record& existing, int key) { return existing.id < key; });
+    if (at == records.end() || at->id != id) return false;
+    records.erase(at);
+    return true;
+}
+
+// Ids are normally ascending, so the common case is one pass with no allocation
+template <typename Record>
+bool hasRepeatedIds(const std::vector<Record>& records) {
+    bool ascending = true;
+    for (size_t i = 1; i < records.size() && ascending; ++i) {
+        ascending = records[i - 1].id < records[i].id;
+    }
+    if (ascending) return false;
+    std::vector<int> ids;
+    ids.reserve(records.size());
+    for (const auto& record : records) ids.push_back(record.id);
+    std::sort(ids.begin(), ids.end());
+    return std::adjacent_find(ids.begin(), ids.end()) != ids.end();
+}
+
+// The first record with an id keeps it; later ones get fresh ids and move to
+// the end, as if just added, so the ids stay ascending. Returns how many moved.
+template <typename Record>
+size_t renumberRepeatedIds(std::vector<Record>& records, int& nextId) {
+    std::unordered_set<int> seen;
+    seen.reserve(records.size());
+    std::vector<Record> renumbered;
+    size_t kept = 0;
+    for (auto& record : records) {
+        if (seen.insert(record.id).second) {
+            if (&records[kept] != &record) records[kept] = std::move(record);
+            ++kept;
+        } else {
+            record.id = nextId++;
+            renumbered.push_back(std::move(record));
+        }
+    }
+    std::move(renumbered.begin(), renumbered.end(), records.begin() + static_cast<std::ptrdiff_t>(kept));
+    return renumbered.size();
+}
+
+bool taskById(const Task& a, const Task& b) {
+    return a.id < b.id;
+}
+
+bool moodById(const MoodEntry& a, const MoodEntry& b) {
+    return a.id < b.id;
 }
 
+} // namespace
+
 // Task operations
 bool Storage::saveTask(const Task& task) {
+    WriteAccess access(*this);
+    if (access.elsewhere()) return forwardTask(Task(task));
+    if (!appendTask(task)) return false;
+    if (residentTasksLoaded) keepInIdOrder(residentTasks, task);
+    return true;
+}
+
+bool Storage::saveTask(Task&& task) {
+    WriteAccess access(*this);
+    if (access.elsewhere()) return forwardTask(std::move(task));
+    if (!appendTask(task)) return false;
+    if (residentTasksLoaded) keepInIdOrder(residentTasks, std::move(task));
+    return true;
+}
+
+// moodood numbers the task itself; the rest is kept in step as appendTask() would
+bool Storage::forwardTask(Task task) {
+    long long id;
+    if (!forward({"add-task", "--title", task.title, "--description", task.description,
+                  "--priority", std::to_string(static_cast<int>(task.priority)),
+                  "--difficulty", std::to_string(static_cast<int>(task.difficulty))}, &id)) {
+        return false;
+    }
+    task.id = static_cast<int>(id);
+    nextTaskId = std::max(nextTaskId, task.id + 1);
+    taskCols.append(task);
+    for (auto* listener : listeners) listener->taskSaved(task);
+    if (residentTasksLoaded) keepInIdOrder(residentTasks, std::move(task));
+    return true;
+}
+
+bool Storage::appendTask(const Task& task) {
+    MetricsTimer timer(Metrics::SAVE_TASK);
     std::ofstream file(tasksFile, std::ios::app);
     if (!file.is_open()) {
         std::cerr << "Error: Could not open tasks file for writing" << std::endl;
         return false;
     }
     
-    file << task.id << "|"
+    std::ostringstream line;
+    line << task.id << "|"
          << task.title << "|"
          << task.description << "|"
          << priorityToString(task.priority) << "|"
          << difficultyToString(task.difficulty) << "|"
          << (task.completed ? "1" : "0") << "|"
          << timeToString(task.created) << "|"
-         << timeToString(task.completed_time) << std::endl;
+         << timeToString(task.completed_time) << "\n";
+    std::string text = line.str();
+    file << text << std::flush;
+    Metrics::add(Metrics::BYTES_WRITTEN, text.size());
     
     file.close();
     nextTaskId = std::max(nextTaskId, task.id + 1);
+    taskCols.append(task);
+    for (auto* listener : listeners) listener->taskSaved(task);
     return true;
 }
 
-bool Storage::loadTasks(std::vector<Task>& tasks) {
-    tasks.clear();
-    std::ifstream file(tasksFile);
-    if (!file.is_open()) {
-        return true; // File doesn't exist yet, that's okay
+bool Storage::parseTaskEntry(std::string_view line, Task& task) {
+    if (line.empty()) return false;
+    
+    std::string_view rest = line;
+    std::string_view field;
+    
+    // task may be recycled from an earlier load, so fields missing from the line are reset
+    task.title.clear();
+    task.description.clear();
+    task.priority = Priority::MEDIUM;
+    task.difficulty = TaskDifficulty::MEDIUM;
+    task.completed = false;
+    task.completed_time = 0;
+    
+    // Parse: id|title|description|priority|difficulty|completed|created|completed_time
+    if (nextField(rest, field)) task.id = parseId(field);
+    if (nextField(rest, field)) task.title.assign(field.data(), field.size());
+    if (nextField(rest, field)) task.description.assign(field.data(), field.size());
+    if (nextField(rest, field)) task.priority = stringToPriority(field);
+    if (nextField(rest, field)) task.difficulty = stringToDifficulty(field);
+    if (nextField(rest, field)) task.completed = (field == "1");
+    if (nextField(rest, field)) task.created = stringToTime(field);
+    else task.created = time(nullptr);
+    if (nextField(rest, field)) task.completed_time = stringToTime(field);
+    return true;
+}
+
+template <typename Record, typename Parse>
+size_t Storage::parseLines(const std::string& text, size_t from, std::vector<Record>& records, size_t used,
+                           int& nextId, const char* spanName, Parse parse) {
+    // Parse newline-aligned chunks concurrently. A chunk yields at most one record
+    // per line, so each chunk fills its own run of slots; the runs are closed up after.
+    std::vector<std::pair<size_t, size_t>> chunks = splitLines(text, ThreadPool::shared().size(), from);
+    std::vector<size_t> starts(chunks.size() + 1, used);
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        const char* begin = text.data() + chunks[c].first;
+        const char* end = text.data() + chunks[c].second;
+        size_t lines = static_cast<size_t>(std::count(begin, end, '\n'));
+        if (begin != end && end[-1] != '\n') ++lines;
+        starts[c + 1] = starts[c] + lines;
+    }
+    reserveFor(records, starts.back());
+    while (records.size() < starts.back()) {
+        records.emplace_back(NoTimestamp());
     }
     
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        
-        std::stringstream ss(line);
-        std::string token;
-        Task task;
-        
-        // Parse: id|title|description|priority|difficulty|completed|created|completed_time
-        if (std::getline(ss, token, '|')) task.id = std::stoi(token);
-        if (std::getline(ss, task.title, '|')) {}
-        if (std::getline(ss, task.description, '|')) {}
-        if (std::getline(ss, token, '|')) task.priority = stringToPriority(token);
-        if (std::getline(ss, token, '|')) task.difficulty = stringToDifficulty(token);
-        if (std::getline(ss, token, '|')) task.completed = (token == "1");
-        if (std::getline(ss, token, '|')) task.created = stringToTime(token);
-        if (std::getline(ss, token, '|')) task.completed_time = stringToTime(token);
-        
-        tasks.push_back(task);
-        nextTaskId = std::max(nextTaskId, task.id + 1);
+    std::vector<size_t> produced(chunks.size(), 0);
+    std::vector<int> maxIds(chunks.size(), 0);
+    (void)spanName;     // Only trace builds use it
+    ThreadPool::shared().parallelFor(chunks.size(), [&](size_t c) {
+        MOODOO_TRACE_SCOPE("storage", spanName);
+        forEachLine(text, chunks[c], [&](std::string_view line) {
+            Record& record = records[starts[c] + produced[c]];
+            if (parse(line, record)) {
+                maxIds[c] = std::max(maxIds[c], record.id);
+                ++produced[c];
+            }
+        });
+    });
+    
+    // Without blank lines the runs already touch and nothing moves
+    size_t filled = used;
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        for (size_t i = starts[c]; i < starts[c] + produced[c]; ++i, ++filled) {
+            if (i != filled) std::swap(records[filled], records[i]);
+        }
+        nextId = std::max(nextId, maxIds[c] + 1);
+    }
+    return filled;
+}
+
+size_t Storage::parseTasks(const std::string& text, size_t from, std::vector<Task>& tasks, size_t used) {
+    size_t filled = parseLines(text, from, tasks, used, nextTaskId, "parseTaskChunk",
+                               [this](std::string_view line, Task& task) { return parseTaskEntry(line, task); });
+    Metrics::add(Metrics::TASKS_PARSED, filled - used);
+    return filled;
+}
+
+bool Storage::loadTaskRecords(std::vector<Task>& tasks, size_t refreshAfter) {
+    // Records the snapshot holds are copied out of it; only text appended since is parsed
+    WarmSnapshot snapshot;
+    std::string contents;
+    size_t skip = 0;            // Leading bytes of contents the snapshot already covers
+    SourceStamp stamp;
+    bool stamped = false;
+    bool rehashed = false;
+    size_t used = 0;
+    bool warm = snapshot.open(tasksSnapshotFile, WarmSnapshot::Kind::TASKS) &&
+                readSince(tasksFile, snapshot.source(), contents, skip, stamp, stamped, rehashed);
+    if (warm) {
+        used = snapshot.readTasks(tasks, used);
+        nextTaskId = std::max(nextTaskId, snapshot.nextId());
+    } else {
+        skip = 0;
+        int64_t checkedAt = time(nullptr);
+        int64_t mtime = WarmSnapshot::modifiedTime(tasksFile);
+        if (!readFile(tasksFile, contents)) {
+            tasks.clear();
+            return false;
+        }
+        stamped = WarmSnapshot::stamp(contents, 0, mtime, checkedAt, SourceStamp(), stamp);
     }
+    used = parseTasks(contents, skip, tasks, used);
+    tasks.erase(tasks.begin() + static_cast<std::ptrdiff_t>(used), tasks.end());
     
-    file.close();
+    // Everything downstream (indexes, the resident store, edits) goes by id,
+    // so a repeated id is renumbered and written back once
+    if (hasRepeatedIds(tasks)) {
+        size_t renumbered = renumberRepeatedIds(tasks, nextTaskId);
+        std::cerr << "Warning: Renumbered " << renumbered << " repeated task id(s)" << std::endl;
+        WriteAccess access(*this); // Else the writer fixes the file when it loads it
+        if (!access.elsewhere() && !rewriteTaskFile(tasks)) {
+            std::cerr << "Error: Could not write renumbered tasks" << std::endl;
+        }
+        stamped = false; // The snapshot would describe the old text
+    }
+    
+    // Rewritten after a cold load, once enough has been appended to be worth
+    // it, and when a rehash can move checkedAt past the file's last change
+    size_t parsed = contents.size() - skip;
+    if (stamped && (!warm || rehashed || (parsed > 0 && parsed >= refreshAfter))) {
+        WriteAccess access(*this);
+        if (!access.elsewhere()) WarmSnapshot::writeTasks(tasksSnapshotFile, stamp, nextTaskId, tasks);
+    }
     return true;
 }
 
-// Journal operations
-bool Storage::saveMoodEntry(const MoodEntry& entry) {
-    std::ofstream file(journalFile, std::ios::app);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open journal file for writing" << std::endl;
-        return false;
+bool Storage::loadTasks(std::vector<Task>& tasks) {
+    MetricsTimer timer(Metrics::LOAD_TASKS);
+    if (!loadTaskRecords(tasks, kSnapshotRefreshBytes)) {
+        return true; // File doesn't exist yet, that's okay
     }
     
+    taskCols.clear();
+    taskCols.reserve(tasks.size());
+    for (const auto& task : tasks) {
+        taskCols.append(task);
+    }
+    taskColsLoaded = true;
+    MOODOO_TRACE_SCOPE("storage", "notifyTasksLoaded");
+    for (auto* listener : listeners) listener->tasksLoaded(tasks);
+    return true;
+}
+
+// Journal operations
+//
+// The journal is a hot text file plus a set of sealed cold segments. Each segment
+// holds entries from one kSegmentSpan-wide window, in the same line format as the
+// hot file, compressed as a single block and described by a line in the index:
+//   file|firstTimestamp|lastTimestamp|firstId|lastId|entryCount|rawBytes|storedBytes|codec
+
+void Storage::writeMoodEntry(std::ostream& out, const MoodEntry& entry) {
     // Convert keywords vector to comma-separated string
     std::string keywordsStr;
     for (size_t i = 0; i < entry.keywords.size(); ++i) {
@@ -151,292 +537,1540 @@ bool Storage::saveMoodEntry(const MoodEntry& entry) {
         keywordsStr += entry.keywords[i];
     }
     
-    file << entry.id << "|"
-         << entry.content << "|"
-         << moodToString(entry.mood) << "|"
-         << timeToString(entry.timestamp) << "|"
-         << keywordsStr << "|"
-         << entry.sentimentScore << std::endl;
-    
-    file.close();
-    nextMoodId = std::max(nextMoodId, entry.id + 1);
-    return true;
+    out << entry.id << "|"
+        << entry.content << "|"
+        << moodToString(entry.mood) << "|"
+        << timeToString(entry.timestamp) << "|"
+        << keywordsStr << "|"
+        << entry.sentimentScore << "\n";
 }
 
-bool Storage::loadMoodEntries(std::vector<MoodEntry>& entries) {
-    entries.clear();
-    std::ifstream file(journalFile);
-    if (!file.is_open()) {
-        return true; // File doesn't exist yet, that's okay
-    }
+bool Storage::parseMoodEntry(std::string_view line, MoodEntry& entry) {
+    if (line.empty()) return false;
     
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        
-        std::stringstream ss(line);
-        std::string token;
-        MoodEntry entry;
-        
-        // Parse: id|content|mood|timestamp|keywords|sentimentScore
-        if (std::getline(ss, token, '|')) entry.id = std::stoi(token);
-        if (std::getline(ss, entry.content, '|')) {}
-        if (std::getline(ss, token, '|')) entry.mood = stringToMood(token);
-        if (std::getline(ss, token, '|')) entry.timestamp = stringToTime(token);
-        if (std::getline(ss, token, '|')) {
-            // Parse keywords
-            std::stringstream keywordStream(token);
-            std::string keyword;
-            while (std::getline(keywordStream, keyword, ',')) {
-                if (!keyword.empty()) {
-                    entry.keywords.push_back(keyword);
-                }
-            }
-        }
-        if (std::getline(ss, token, '|')) {
-            try {
-                entry.sentimentScore = std::stod(token);
-            } catch (...) {
-                entry.sentimentScore = 0.0;
+    std::string_view rest = line;
+    std::string_view field;
+    
+    // entry may be recycled from an earlier load, so fields missing from the line are reset
+    entry.content.clear();
+    entry.mood = MoodLevel::NEUTRAL;
+    entry.keywords.clear();
+    entry.extractedKeywords.clear();
+    entry.sentimentScore = 0.0;
+    
+    // Parse: id|content|mood|timestamp|keywords|sentimentScore
+    if (nextField(rest, field)) entry.id = parseId(field);
+    if (nextField(rest, field)) entry.content.assign(field.data(), field.size());
+    if (nextField(rest, field)) entry.mood = stringToMood(field);
+    if (nextField(rest, field)) entry.timestamp = stringToTime(field);
+    else entry.timestamp = time(nullptr);
+    if (nextField(rest, field)) {
+        // Keywords are interned straight from the line, no temporary strings
+        std::string_view keywordField;
+        while (nextField(field, keywordField, ',')) {
+            if (!keywordField.empty()) {
+                entry.keywords.emplace_back(keywordField);
             }
         }
-        
-        entries.push_back(entry);
-        nextMoodId = std::max(nextMoodId, entry.id + 1);
     }
-    
-    file.close();
+    if (nextField(rest, field)) entry.sentimentScore = parseScore(field);
     return true;
 }
 
-// Utility methods
-int Storage::getNextTaskId() {
-    return nextTaskId++;
+bool Storage::saveMoodEntry(const MoodEntry& entry) {
+    WriteAccess access(*this);
+    if (access.elsewhere()) return forwardMoodEntry(MoodEntry(entry));
+    if (!appendMoodEntry(entry)) return false;
+    if (residentMoodsLoaded) keepInIdOrder(residentMoods, entry);
+    return true;
 }
 
-int Storage::getNextMoodId() {
-    return nextMoodId++;
+bool Storage::saveMoodEntry(MoodEntry&& entry) {
+    WriteAccess access(*this);
+    if (access.elsewhere()) return forwardMoodEntry(std::move(entry));
+    if (!appendMoodEntry(entry)) return false;
+    if (residentMoodsLoaded) keepInIdOrder(residentMoods, std::move(entry));
+    return true;
 }
 
-// Placeholder implementations for future features
-bool Storage::updateTask(const Task& updatedTask) {
-    // Load all tasks
-    std::vector<Task> tasks;
-    if (!loadTasks(tasks)) {
+// As forwardTask(); moodood analyses the text again on its side
+bool Storage::forwardMoodEntry(MoodEntry entry) {
+    long long id;
+    if (!forward({"log-mood", std::to_string(static_cast<int>(entry.mood)), "--text", entry.content}, &id)) {
         return false;
     }
-    
-    // Find and update the specific task
-    for (auto& task : tasks) {
-        if (task.id == updatedTask.id) {
-            task = updatedTask;
-            break;
-        }
-    }
-    
-    // Rewrite the entire file with updated data
-    std::ofstream file(tasksFile, std::ios::trunc); // Truncate file
+    entry.id = static_cast<int>(id);
+    nextMoodId = std::max(nextMoodId, entry.id + 1);
+    moodCols.append(entry);
+    for (auto* listener : listeners) listener->moodSaved(entry);
+    if (residentMoodsLoaded) keepInIdOrder(residentMoods, std::move(entry));
+    return true;
+}
+
+bool Storage::appendMoodEntry(const MoodEntry& entry) {
+    MetricsTimer timer(Metrics::SAVE_MOOD);
+    std::ofstream file(journalFile, std::ios::app);
     if (!file.is_open()) {
-        std::cerr << "Error: Could not open tasks file for updating" << std::endl;
+        std::cerr << "Error: Could not open journal file for writing" << std::endl;
         return false;
     }
     
-    for (const auto& task : tasks) {
-        file << task.id << "|"
-             << task.title << "|"
-             << task.description << "|"
-             << priorityToString(task.priority) << "|"
-             << difficultyToString(task.difficulty) << "|"
-             << (task.completed ? "1" : "0") << "|"
-             << timeToString(task.created) << "|"
-             << timeToString(task.completed_time) << std::endl;
-    }
+    std::ostringstream line;
+    writeMoodEntry(line, entry);
+    std::string text = line.str();
+    file << text;
+    Metrics::add(Metrics::BYTES_WRITTEN, text.size());
     
     file.close();
+    nextMoodId = std::max(nextMoodId, entry.id + 1);
+    moodCols.append(entry);
+    for (auto* listener : listeners) listener->moodSaved(entry);
     return true;
 }
 
-bool Storage::deleteTask(int taskId) {
-    // Load all tasks
-    std::vector<Task> tasks;
-    if (!loadTasks(tasks)) {
-        return false;
-    }
-    
-    // Find and remove the task
-    auto it = std::find_if(tasks.begin(), tasks.end(), 
-                          [taskId](const Task& task) { return task.id == taskId; });
-    
-    if (it == tasks.end()) {
-        return false; // Task not found
+bool Storage::loadHotMoodEntries(std::vector<MoodEntry>& entries) {
+    std::string contents;
+    if (!readFile(journalFile, contents)) {
+        entries.clear();
+        return true; // File doesn't exist yet, that's okay
     }
-    
-    tasks.erase(it);
-    
-    // Rewrite file without the deleted task
-    std::ofstream file(tasksFile, std::ios::trunc);
+    size_t used = parseMoods(contents, 0, entries, 0);
+    entries.erase(entries.begin() + static_cast<std::ptrdiff_t>(used), entries.end());
+    return true;
+}
+
+size_t Storage::parseMoods(const std::string& text, size_t from, std::vector<MoodEntry>& entries, size_t used) {
+    size_t filled = parseLines(text, from, entries, used, nextMoodId, "parseMoodChunk",
+                               [this](std::string_view line, MoodEntry& entry) { return parseMoodEntry(line, entry); });
+    Metrics::add(Metrics::MOODS_PARSED, filled - used);
+    return filled;
+}
+
+bool Storage::rewriteHotJournal(const std::vector<MoodEntry>& entries) {
+    // An edit that keeps the length would pass the snapshot's end checks once
+    // something is appended, so the snapshot goes first
+    std::error_code ec;
+    std::filesystem::remove(moodsSnapshotFile, ec);
+    std::ofstream file(journalFile, std::ios::trunc);
     if (!file.is_open()) {
         return false;
     }
     
-    for (const auto& task : tasks) {
-        file << task.id << "|"
-             << task.title << "|"
-             << task.description << "|"
-             << priorityToString(task.priority) << "|"
-             << difficultyToString(task.difficulty) << "|"
-             << (task.completed ? "1" : "0") << "|"
-             << timeToString(task.created) << "|"
-             << timeToString(task.completed_time) << std::endl;
+    for (const auto& entry : entries) {
+        writeMoodEntry(file, entry);
     }
     
+    Metrics::add(Metrics::JOURNAL_REWRITES, 1);
+    Metrics::add(Metrics::BYTES_WRITTEN, static_cast<uint64_t>(file.tellp()));
     file.close();
     return true;
 }
 
-bool Storage::updateMoodEntry(const MoodEntry& entry) {
-    // Load all mood entries
-    std::vector<MoodEntry> entries;
-    if (!loadMoodEntries(entries)) {
+bool Storage::loadMoodEntries(std::vector<MoodEntry>& entries) {
+    MetricsTimer timer(Metrics::LOAD_MOODS);
+    if (!loadRecentMoodEntries(std::numeric_limits<time_t>::min(), entries)) {
         return false;
     }
     
-    // Find and update the entry
-    for (auto& moodEntry : entries) {
-        if (moodEntry.id == entry.id) {
-            moodEntry = entry;
-            break;
-        }
+    // Only a full-history load refreshes the columns
+    moodCols.clear();
+    moodCols.reserve(entries.size());
+    for (const auto& entry : entries) {
+        moodCols.append(entry);
     }
-    
-    // Rewrite file with updated data
-    std::ofstream file(journalFile, std::ios::trunc);
-    if (!file.is_open()) {
+    moodColsLoaded = true;
+    MOODOO_TRACE_SCOPE("storage", "notifyMoodsLoaded");
+    for (auto* listener : listeners) listener->moodsLoaded(entries);
+    return true;
+}
+
+bool Storage::loadRecentMoodEntries(time_t since, std::vector<MoodEntry>& entries) {
+    MetricsTimer timer(Metrics::LOAD_RECENT_MOODS);
+    return loadMoodRecords(since, entries, kSnapshotRefreshBytes);
+}
+
+bool Storage::loadMoodRecords(time_t since, std::vector<MoodEntry>& entries, size_t refreshAfter) {
+    std::vector<JournalSegment> segments;
+    SourceStamp indexStamp;
+    if (!loadSegmentIndex(segments)) {
         return false;
     }
+    segmentIndexStamp(indexStamp);
+    for (const auto& segment : segments) {
+        nextMoodId = std::max(nextMoodId, segment.lastId + 1);
+    }
     
-    for (const auto& moodEntry : entries) {
-        // Convert keywords to comma-separated string
-        std::string keywordsStr;
-        for (size_t i = 0; i < moodEntry.keywords.size(); ++i) {
-            if (i > 0) keywordsStr += ",";
-            keywordsStr += moodEntry.keywords[i];
+    // The snapshot holds cold and hot entries alike, so it only stands while no segment has changed
+    WarmSnapshot snapshot;
+    std::string hotText;
+    size_t skip = 0;
+    SourceStamp hotStamp;
+    bool stamped = false;
+    bool rehashed = false;
+    size_t used = 0;
+    bool warm = snapshot.open(moodsSnapshotFile, WarmSnapshot::Kind::MOODS) && snapshot.index() == indexStamp &&
+                readSince(journalFile, snapshot.source(), hotText, skip, hotStamp, stamped, rehashed);
+    if (warm) {
+        used = snapshot.readMoods(since, entries, used);
+        nextMoodId = std::max(nextMoodId, snapshot.nextId());
+    } else {
+        // Only segments that reach into the requested range are decompressed
+        std::vector<const JournalSegment*> wanted;
+        for (const auto& segment : segments) {
+            if (segment.lastTimestamp >= since) {
+                wanted.push_back(&segment);
+            }
         }
         
-        file << moodEntry.id << "|"
-             << moodEntry.content << "|"
-             << moodToString(moodEntry.mood) << "|"
-             << timeToString(moodEntry.timestamp) << "|"
-             << keywordsStr << "|"
-             << moodEntry.sentimentScore << std::endl;
+        std::vector<std::vector<MoodEntry>> parts(wanted.size());
+        std::vector<char> loaded(wanted.size(), 0);
+        ThreadPool::shared().parallelFor(wanted.size(), [&](size_t i) {
+            loaded[i] = loadSegment(*wanted[i], parts[i]);
+        });
+        if (std::find(loaded.begin(), loaded.end(), 0) != loaded.end()) {
+            return false;
+        }
+        
+        // Cold segments first (index order is time order), then the hot file
+        for (auto& part : parts) {
+            for (auto& entry : part) {
+                if (entry.timestamp >= since) {
+                    recycle(entries, used++) = std::move(entry);
+                }
+            }
+        }
+        skip = 0;
+        int64_t checkedAt = time(nullptr);
+        int64_t mtime = WarmSnapshot::modifiedTime(journalFile);
+        if (readFile(journalFile, hotText)) {
+            stamped = WarmSnapshot::stamp(hotText, 0, mtime, checkedAt, SourceStamp(), hotStamp);
+        }
     }
     
-    file.close();
-    return true;
-}
-
-bool Storage::deleteMoodEntry(int entryId) {
-    // Load all mood entries
-    std::vector<MoodEntry> entries;
-    if (!loadMoodEntries(entries)) {
-        return false;
+    // Hot entries are parsed in place, then the ones before since are dropped
+    size_t hotStart = used;
+    used = parseMoods(hotText, skip, entries, used);
+    size_t kept = hotStart;
+    for (size_t i = hotStart; i < used; ++i) {
+        if (entries[i].timestamp >= since) {
+            if (i != kept) std::swap(entries[kept], entries[i]);
+            ++kept;
+        }
     }
+    entries.erase(entries.begin() + static_cast<std::ptrdiff_t>(kept), entries.end());
     
-    // Find and remove the entry
-    auto it = std::find_if(entries.begin(), entries.end(), 
-                          [entryId](const MoodEntry& entry) { return entry.id == entryId; });
-    
-    if (it == entries.end()) {
-        return false; // Entry not found
+    // As with tasks; only a full-history load sees every id. Repeats within
+    // the hot file are fixed there, anything left is renumbered in memory.
+    if (since == std::numeric_limits<time_t>::min() && hasRepeatedIds(entries)) {
+        bool repaired;
+        {
+            WriteAccess access(*this);
+            repaired = !access.elsewhere() && repairJournalIds(segments);
+        }
+        if (repaired) {
+            return loadMoodRecords(since, entries, refreshAfter);
+        }
+        size_t renumbered = renumberRepeatedIds(entries, nextMoodId);
+        std::cerr << "Warning: Renumbered " << renumbered << " repeated journal id(s)" << std::endl;
+        stamped = false;
     }
     
-    entries.erase(it);
-    
-    // Rewrite file without the deleted entry
-    std::ofstream file(journalFile, std::ios::trunc);
+    // Only a full-history load has everything the snapshot needs
+    size_t parsed = hotText.size() - skip;
+    if (since == std::numeric_limits<time_t>::min() && stamped &&
+        (!warm || rehashed || (parsed > 0 && parsed >= refreshAfter))) {
+        WriteAccess access(*this);
+        if (!access.elsewhere()) WarmSnapshot::writeMoods(moodsSnapshotFile, hotStamp, indexStamp, nextMoodId, entries);
+    }
+    return true;
+}
+
+bool Storage::loadSegmentIndex(std::vector<JournalSegment>& segments) {
+    return readSegmentIndex(segmentIndexFile, segments);
+}
+
+bool Storage::readSegmentIndex(const std::string& path, std::vector<JournalSegment>& segments) {
+    segments.clear();
+    std::ifstream file(path);
     if (!file.is_open()) {
-        return false;
+        return true; // Nothing sealed yet
     }
     
-    for (const auto& entry : entries) {
-        // Convert keywords to comma-separated string
-        std::string keywordsStr;
-        for (size_t i = 0; i < entry.keywords.size(); ++i) {
-            if (i > 0) keywordsStr += ",";
-            keywordsStr += entry.keywords[i];
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+        
+        std::stringstream ss(line);
+        std::string token;
+        JournalSegment segment;
+        
+        try {
+            if (std::getline(ss, segment.file, '|')) {}
+            if (std::getline(ss, token, '|')) segment.firstTimestamp = stringToTime(token);
+            if (std::getline(ss, token, '|')) segment.lastTimestamp = stringToTime(token);
+            if (std::getline(ss, token, '|')) segment.firstId = std::stoi(token);
+            if (std::getline(ss, token, '|')) segment.lastId = std::stoi(token);
+            if (std::getline(ss, token, '|')) segment.entryCount = std::stoull(token);
+            if (std::getline(ss, token, '|')) segment.rawBytes = std::stoull(token);
+            if (std::getline(ss, token, '|')) segment.storedBytes = std::stoull(token);
+            if (std::getline(ss, token, '|')) segment.codec = BlockCodec::stringToCodec(token);
+        } catch (...) {
+            std::cerr << "Error: Damaged journal segment index" << std::endl;
+            return false;
         }
         
-        file << entry.id << "|"
-             << entry.content << "|"
-             << moodToString(entry.mood) << "|"
-             << timeToString(entry.timestamp) << "|"
-             << keywordsStr << "|"
-             << entry.sentimentScore << std::endl;
+        segments.push_back(segment);
     }
     
     file.close();
     return true;
 }
 
-bool Storage::backupData() {
-    // Create backup directory
-    std::filesystem::create_directories("data/backup");
-    
-    // Get current timestamp for backup filename
-    time_t now = time(nullptr);
-    std::string timestamp = std::to_string(now);
-    
-    // Backup tasks file
-    std::string tasksBackup = "data/backup/tasks_" + timestamp + ".txt";
-    if (!std::filesystem::copy_file(tasksFile, tasksBackup)) {
+bool Storage::saveSegmentIndex(const std::vector<JournalSegment>& segments) {
+    // Write aside and rename so readers never see a half-written index
+    std::string tempFile = segmentIndexFile + ".tmp";
+    std::ofstream file(tempFile, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open journal segment index for writing" << std::endl;
         return false;
     }
     
-    // Backup journal file
-    std::string journalBackup = "data/backup/journal_" + timestamp + ".txt";
-    if (!std::filesystem::copy_file(journalFile, journalBackup)) {
+    for (const auto& segment : segments) {
+        file << segment.file << "|"
+             << timeToString(segment.firstTimestamp) << "|"
+             << timeToString(segment.lastTimestamp) << "|"
+             << segment.firstId << "|"
+             << segment.lastId << "|"
+             << segment.entryCount << "|"
+             << segment.rawBytes << "|"
+             << segment.storedBytes << "|"
+             << BlockCodec::codecToString(segment.codec) << "\n";
+    }
+    file.close();
+    
+    std::error_code ec;
+    std::filesystem::rename(tempFile, segmentIndexFile, ec);
+    return !ec;
+}
+
+// Warm-start snapshots
+//
+// A snapshot stands for a text file as long as the file is byte-for-byte what
+// it was built from, or that plus appended lines. Storage appends new records
+// and rewrites the whole file (dropping the snapshot) for anything else.
+// Equal size and mtime only prove the file unchanged when it was last changed
+// strictly before the snapshot read it (git's racy-clean rule): a same-length
+// rewrite within one timestamp tick, or a sync tool putting the mtime back,
+// keeps both. Otherwise the whole file is hashed against the range hash.
+
+bool Storage::readSince(const std::string& path, const SourceStamp& covered, std::string& contents,
+                        size_t& skip, SourceStamp& current, bool& stamped, bool& rehashed) {
+    int64_t checkedAt = time(nullptr);
+    int64_t mtime = WarmSnapshot::modifiedTime(path);
+    std::error_code ec;
+    uintmax_t size = std::filesystem::file_size(path, ec);
+    if (ec) {
         return false;
     }
+    contents.clear();
+    skip = 0;
+    if (size == covered.bytes && mtime == covered.mtime) {
+        int64_t changed = WarmSnapshot::changedTime(path);
+        if (changed >= 0 && changed < covered.checkedAt) {
+            current = covered;
+            stamped = true;
+            return true;
+        }
+        if (!readFile(path, contents) ||
+            !WarmSnapshot::stamp(contents, 0, mtime, checkedAt, SourceStamp(), current) || !(current == covered)) {
+            return false;
+        }
+        skip = contents.size();
+        stamped = true;
+        rehashed = changed < checkedAt;
+        return true;
+    }
+    if (size <= covered.bytes) {
+        return false; // Rewritten, not appended to
+    }
     
+    // Appended to: the covered bytes must be unchanged at both ends. The tail
+    // window is read along with the new text, so the new stamp can be taken.
+    const size_t window = static_cast<size_t>(std::min<uint64_t>(WarmSnapshot::kStampWindow, covered.bytes));
+    const uint64_t offset = covered.bytes - window;
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    if (offset > 0) {
+        std::string head(WarmSnapshot::kStampWindow, '\0');
+        file.read(&head[0], static_cast<std::streamsize>(head.size()));
+        if (static_cast<size_t>(file.gcount()) != head.size() ||
+            WarmSnapshot::hash(head.data(), head.size()) != covered.headHash) {
+            return false;
+        }
+        Metrics::add(Metrics::BYTES_READ, head.size());
+        file.seekg(static_cast<std::streamoff>(offset));
+    }
+    contents.resize(static_cast<size_t>(size - offset));
+    file.read(&contents[0], static_cast<std::streamsize>(contents.size()));
+    contents.resize(static_cast<size_t>(file.gcount()));
+    Metrics::add(Metrics::BYTES_READ, contents.size());
+    if (contents.size() < window || WarmSnapshot::hash(contents.data(), window) != covered.tailHash) {
+        return false;
+    }
+    
+    skip = window;
+    stamped = WarmSnapshot::stamp(contents, offset, mtime, checkedAt, covered, current);
     return true;
 }
 
-bool Storage::restoreData() {
-    // List available backups
-    std::cout << "Available backups:" << std::endl;
-    std::vector<std::string> backups;
+void Storage::segmentIndexStamp(SourceStamp& stamp) {
+    // The index is small, so it is hashed whole; mtime stays 0
+    std::string contents;
+    readFile(segmentIndexFile, contents);
+    stamp = SourceStamp();
+    stamp.bytes = contents.size();
+    stamp.headHash = WarmSnapshot::hash(contents.data(), contents.size());
+}
+
+bool Storage::saveSnapshots() {
+    WriteAccess access(*this);
+    if (access.elsewhere()) return true;
+    // Cheap when nothing changed: a snapshot that matches its file's size and
+    // mtime, and was taken after the file last changed, is left alone
+    auto matches = [](const SourceStamp& stamp, const std::string& path) {
+        std::error_code ec;
+        uintmax_t size = std::filesystem::file_size(path, ec);
+        int64_t changed = WarmSnapshot::changedTime(path);
+        return !ec && stamp.bytes == size && stamp.mtime == WarmSnapshot::modifiedTime(path) && changed >= 0 &&
+               changed < stamp.checkedAt;
+    };
+    
+    // A refresh threshold of one byte rewrites a snapshot for any appended text
+    bool saved = true;
+    WarmSnapshot tasksSnapshot;
+    if (!tasksSnapshot.open(tasksSnapshotFile, WarmSnapshot::Kind::TASKS) ||
+        !matches(tasksSnapshot.source(), tasksFile)) {
+        std::vector<Task> tasks;
+        saved = loadTaskRecords(tasks, 1) && saved;
+    }
+    WarmSnapshot moodsSnapshot;
+    SourceStamp indexStamp;
+    segmentIndexStamp(indexStamp);
+    if (!moodsSnapshot.open(moodsSnapshotFile, WarmSnapshot::Kind::MOODS) || moodsSnapshot.index() != indexStamp ||
+        !matches(moodsSnapshot.source(), journalFile)) {
+        std::vector<MoodEntry> entries;
+        saved = loadMoodRecords(std::numeric_limits<time_t>::min(), entries, 1) && saved;
+    }
+    return saved;
+}
+
+bool Storage::loadStatsSummary(StatsSummary& summary) {
+    std::ifstream file(summaryFile);
+    std::string line;
+    if (!file.is_open() || !std::getline(file, line)) {
+        return false;
+    }
+    
+    std::stringstream ss(line);
+    std::string token;
+    StatsSummary loaded;
+    try {
+        if (!std::getline(ss, token, '|')) return false;
+        loaded.totalTasks = std::stoi(token);
+        if (!std::getline(ss, token, '|')) return false;
+        loaded.completedTasks = std::stoi(token);
+        if (!std::getline(ss, token, '|')) return false;
+        loaded.totalMoods = std::stoi(token);
+        if (!std::getline(ss, token, '|')) return false;
+        loaded.hasCorrelation = token == "1";
+        if (!std::getline(ss, token, '|')) return false;
+        loaded.moodTaskCorrelation = std::stod(token);
+        if (!std::getline(ss, token, '|')) return false;
+        loaded.updated = stringToTime(token);
+    } catch (...) {
+        std::cerr << "Error: Damaged stats summary" << std::endl;
+        return false;
+    }
+    summary = loaded;
+    return true;
+}
+
+bool Storage::saveStatsSummary(const StatsSummary& summary) {
+    WriteAccess access(*this);
+    if (access.elsewhere()) return true;
+    // Write aside and rename, like the segment index
+    std::string tempFile = summaryFile + ".tmp";
+    std::ofstream file(tempFile, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open stats summary for writing" << std::endl;
+        return false;
+    }
+    file << summary.totalTasks << "|"
+         << summary.completedTasks << "|"
+         << summary.totalMoods << "|"
+         << (summary.hasCorrelation ? "1" : "0") << "|"
+         << summary.moodTaskCorrelation << "|"
+         << timeToString(summary.updated) << "\n";
+    file.close();
+    
+    std::error_code ec;
+    std::filesystem::rename(tempFile, summaryFile, ec);
+    return !ec;
+}
+
+bool Storage::loadSegment(const JournalSegment& segment, std::vector<MoodEntry>& entries) {
+    MOODOO_TRACE_SCOPE("storage", "loadSegment");
+    std::ifstream file(segmentDir + "/" + segment.file, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Missing journal segment " << segment.file << std::endl;
+        return false;
+    }
+    
+    std::string stored((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::string raw;
+    if (!BlockCodec::decompress(segment.codec, stored, segment.rawBytes, raw)) {
+        std::cerr << "Error: Could not decompress journal segment " << segment.file << std::endl;
+        return false;
+    }
+    
+    // Replaces entries, recycling its records like the other loaders
+    size_t used = 0;
+    reserveFor(entries, segment.entryCount);
+    forEachLine(raw, std::make_pair(size_t(0), raw.size()), [&](std::string_view line) {
+        if (parseMoodEntry(line, recycle(entries, used))) {
+            ++used;
+        }
+    });
+    entries.erase(entries.begin() + static_cast<std::ptrdiff_t>(used), entries.end());
+    Metrics::add(Metrics::SEGMENTS_READ, 1);
+    Metrics::add(Metrics::BYTES_READ, stored.size());
+    Metrics::add(Metrics::MOODS_PARSED, used);
+    return true;
+}
+
+bool Storage::writeSegment(const std::vector<MoodEntry>& entries, JournalSegment& segment) {
+    std::ostringstream raw;
+    for (const auto& entry : entries) {
+        writeMoodEntry(raw, entry);
+    }
+    std::string rawText = raw.str();
+    
+    std::string stored;
+    segment.codec = BlockCodec::preferred();
+    if (!BlockCodec::compress(segment.codec, rawText, stored)) {
+        return false;
+    }
+    
+    segment.firstTimestamp = std::numeric_limits<time_t>::max();
+    segment.lastTimestamp = std::numeric_limits<time_t>::min();
+    segment.firstId = std::numeric_limits<int>::max();
+    segment.lastId = std::numeric_limits<int>::min();
+    for (const auto& entry : entries) {
+        segment.firstTimestamp = std::min(segment.firstTimestamp, entry.timestamp);
+        segment.lastTimestamp = std::max(segment.lastTimestamp, entry.timestamp);
+        segment.firstId = std::min(segment.firstId, entry.id);
+        segment.lastId = std::max(segment.lastId, entry.id);
+    }
+    segment.entryCount = entries.size();
+    segment.rawBytes = rawText.size();
+    segment.storedBytes = stored.size();
+    
+    std::string tempFile = segmentDir + "/" + segment.file + ".tmp";
+    std::ofstream file(tempFile, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(stored.data(), static_cast<std::streamsize>(stored.size()));
+    file.close();
+    if (!file) {
+        return false;
+    }
+    Metrics::add(Metrics::SEGMENTS_WRITTEN, 1);
+    Metrics::add(Metrics::BYTES_WRITTEN, stored.size());
+    
+    std::error_code ec;
+    std::filesystem::rename(tempFile, segmentDir + "/" + segment.file, ec);
+    return !ec;
+}
+
+bool Storage::sealedIdsAmong(const std::vector<MoodEntry>& hot, const std::vector<JournalSegment>& segments,
+                             std::set<int>& sealedIds) {
+    // A crash between saving the index and rewriting the hot file leaves
+    // entries in both; the sealed copy wins. Normally no hot id falls inside
+    // a segment's id range and no segment is read.
+    std::vector<int> hotIds;
+    for (const auto& entry : hot) hotIds.push_back(entry.id);
+    std::sort(hotIds.begin(), hotIds.end());
+    for (const auto& segment : segments) {
+        auto it = std::lower_bound(hotIds.begin(), hotIds.end(), segment.firstId);
+        if (it == hotIds.end() || *it > segment.lastId) continue;
+        std::vector<MoodEntry> sealed;
+        if (!loadSegment(segment, sealed)) {
+            return false;
+        }
+        for (const auto& entry : sealed) sealedIds.insert(entry.id);
+    }
+    return true;
+}
+
+bool Storage::repairJournalIds(const std::vector<JournalSegment>& segments) {
+    std::vector<MoodEntry> hot;
+    std::set<int> sealedIds;
+    if (!loadHotMoodEntries(hot) || !sealedIdsAmong(hot, segments, sealedIds)) {
+        return false;
+    }
+    
+    std::vector<MoodEntry> keep;
+    for (auto& entry : hot) {
+        if (!sealedIds.count(entry.id)) keep.push_back(std::move(entry));
+    }
+    size_t renumbered = renumberRepeatedIds(keep, nextMoodId);
+    if (keep.size() == hot.size() && renumbered == 0) {
+        return false; // The repeats are between segments; nothing to fix here
+    }
+    std::cerr << "Warning: Renumbered " << renumbered << " repeated journal id(s)" << std::endl;
+    return rewriteHotJournal(keep);
+}
+
+bool Storage::sealJournalSegments(time_t olderThan) {
+    WriteAccess access(*this);
+    if (access.elsewhere()) return true; // The writer seals
+    MetricsTimer timer(Metrics::SEAL_SEGMENTS);
+    std::vector<MoodEntry> hot;
+    if (!loadHotMoodEntries(hot)) {
+        return false;
+    }
+    
+    std::vector<JournalSegment> segments;
+    if (!loadSegmentIndex(segments)) {
+        return false;
+    }
+    
+    std::set<int> sealedIds;
+    if (!sealedIdsAmong(hot, segments, sealedIds)) {
+        return false;
+    }
+    
+    // Group old entries by segment window; everything else stays hot
+    std::map<time_t, std::vector<MoodEntry>> windows;
+    std::vector<MoodEntry> keep;
+    for (auto& entry : hot) {
+        if (sealedIds.count(entry.id)) continue;
+        if (entry.timestamp < olderThan) {
+            time_t window = entry.timestamp - (entry.timestamp % kSegmentSpan);
+            windows[window].push_back(std::move(entry));
+        } else {
+            keep.push_back(std::move(entry));
+        }
+    }
+    
+    if (windows.empty()) {
+        // Nothing old enough to seal, but still drop what a segment already holds
+        return keep.size() == hot.size() || rewriteHotJournal(keep);
+    }
+    
+    std::error_code ec;
+    std::filesystem::create_directories(segmentDir, ec);
+    if (ec) {
+        return false;
+    }
+    
+    // Sequence numbers only grow: removing an emptied segment must not let a
+    // later seal reuse its neighbour's name and rename over a live file
+    int sequence = 0;
+    for (const auto& segment : segments) {
+        size_t dot = segment.file.rfind('.');
+        size_t underscore = segment.file.rfind('_', dot);
+        if (dot == std::string::npos || underscore == std::string::npos) continue;
+        int number = 0;
+        const char* first = segment.file.data() + underscore + 1;
+        if (std::from_chars(first, segment.file.data() + dot, number).ec == std::errc()) {
+            sequence = std::max(sequence, number);
+        }
+    }
+    
+    for (const auto& window : windows) {
+        JournalSegment segment;
+        do {
+            segment.file = "segment_" + timeToString(window.first) + "_" + std::to_string(++sequence) +
+                           "." + BlockCodec::codecToString(BlockCodec::preferred());
+        } while (std::filesystem::exists(segmentDir + "/" + segment.file, ec));
+        if (!writeSegment(window.second, segment)) {
+            std::cerr << "Error: Could not write journal segment " << segment.file << std::endl;
+            return false;
+        }
+        segments.push_back(segment);
+    }
+    
+    std::stable_sort(segments.begin(), segments.end(),
+                     [](const JournalSegment& a, const JournalSegment& b) { return a.firstTimestamp < b.firstTimestamp; });
+    
+    // Segments are durable before the hot file drops the entries they now hold
+    if (!saveSegmentIndex(segments)) {
+        return false;
+    }
+    return rewriteHotJournal(keep);
+}
+
+bool Storage::rewriteSegmentEntry(int entryId, const MoodEntry* replacement) {
+    std::vector<JournalSegment> segments;
+    if (!loadSegmentIndex(segments)) {
+        return false;
+    }
+    
+    for (auto& segment : segments) {
+        if (entryId < segment.firstId || entryId > segment.lastId) continue;
+        
+        std::vector<MoodEntry> entries;
+        if (!loadSegment(segment, entries)) {
+            return false;
+        }
+        
+        auto it = std::find_if(entries.begin(), entries.end(),
+                               [entryId](const MoodEntry& entry) { return entry.id == entryId; });
+        if (it == entries.end()) continue;
+        
+        if (replacement) {
+            *it = *replacement;
+        } else {
+            entries.erase(it);
+        }
+        
+        if (entries.empty()) {
+            std::error_code ec;
+            std::filesystem::remove(segmentDir + "/" + segment.file, ec);
+            segments.erase(std::find_if(segments.begin(), segments.end(),
+                                        [&segment](const JournalSegment& s) { return s.file == segment.file; }));
+            return saveSegmentIndex(segments);
+        }
+        
+        if (!writeSegment(entries, segment)) {
+            return false;
+        }
+        return saveSegmentIndex(segments);
+    }
+    
+    return false; // Entry not found
+}
+
+// Utility methods
+int Storage::getNextTaskId() {
+    return nextTaskId++;
+}
+
+int Storage::getNextMoodId() {
+    return nextMoodId++;
+}
+
+void Storage::addListener(StorageListener* listener) {
+    if (std::find(listeners.begin(), listeners.end(), listener) == listeners.end()) {
+        listeners.push_back(listener);
+    }
+}
+
+void Storage::removeListener(StorageListener* listener) {
+    listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+}
+
+bool Storage::loadColumns() {
+    // Saves keep loaded columns current, so each side is read from disk at most once
+    // The records land in the store, where the next reload recycles them
+    if (!taskColsLoaded) {
+        RecordSpan<Task> tasks;
+        if (!taskSpan(tasks)) {
+            return false;
+        }
+    }
+    if (!moodColsLoaded) {
+        RecordSpan<MoodEntry> entries;
+        if (!moodSpan(std::numeric_limits<time_t>::min(), entries)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Storage::setResident() {
+    resident = true;
+}
+
+bool Storage::lockWriter() {
+#ifndef _WIN32
+    if (writerLockFd >= 0) return true;
+    int fd = open(lockFile.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Could not open " << lockFile << std::endl;
+        return false;
+    }
+    // A front end's write holds the lock briefly; wait that out, not a writer
+    for (int attempt = 0; flock(fd, LOCK_EX | LOCK_NB) != 0; ++attempt) {
+        if (errno != EWOULDBLOCK || attempt == 100) {
+            std::cerr << "Error: " << lockFile << " is held; is moodood already running?" << std::endl;
+            close(fd);
+            return false;
+        }
+        usleep(10000);
+    }
+    writerLockFd = fd;
+#endif
+    return true;
+}
+
+bool Storage::forward(const std::vector<std::string>& args, long long* id) {
+    std::string status;
+    if (!DaemonClient::call(DaemonClient::defaultSocketPath(), args, status)) {
+        std::cerr << "Error: moodood holds the data but isn't answering" << std::endl;
+        return false;
+    }
+    if (!DaemonClient::succeeded(status) || (id && !DaemonClient::numberField(status, "id", *id))) {
+        std::cerr << "Error: moodood refused the change: " << status << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Storage::writeRefused() const {
+    std::cerr << "Error: moodood holds the data; stop it to make this change" << std::endl;
+    return false;
+}
+
+bool Storage::taskSpan(RecordSpan<Task>& tasks) {
+    if (!residentTasksLoaded) {
+        if (!loadTasks(residentTasks)) {
+            return false;
+        }
+        if (resident) {
+            std::stable_sort(residentTasks.begin(), residentTasks.end(), taskById);
+            residentTasksLoaded = true;
+        }
+    }
+    tasks = RecordSpan<Task>(residentTasks);
+    return true;
+}
+
+bool Storage::moodSpan(time_t since, RecordSpan<MoodEntry>& entries) {
+    if (!residentMoodsLoaded) {
+        // The resident store has to hold the whole journal to follow writes
+        bool full = resident || since == std::numeric_limits<time_t>::min();
+        if (full ? !loadMoodEntries(residentMoods) : !loadRecentMoodEntries(since, residentMoods)) {
+            return false;
+        }
+        if (resident) {
+            std::stable_sort(residentMoods.begin(), residentMoods.end(), moodById);
+            residentMoodsLoaded = true;
+        }
+    }
+    entries = RecordSpan<MoodEntry>(residentMoods);
+    return true;
+}
+
+bool Storage::scanTextLines(const std::string& path, const std::function<void(std::string_view)>& visit) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    // One line buffer for the whole file; its capacity settles on the longest line
+    std::string line;
+    uint64_t bytes = 0;
+    while (std::getline(file, line)) {
+        bytes += line.size() + 1;
+        std::string_view view(line);
+        if (!view.empty() && view.back() == '\r') view.remove_suffix(1);
+        visit(view);
+    }
+    Metrics::add(Metrics::BYTES_READ, bytes);
+    return true;
+}
+
+bool Storage::forEachTask(const std::function<void(const Task&)>& visit) {
+    if (residentTasksLoaded) {
+        for (const auto& task : residentTasks) visit(task);
+        return true;
+    }
+    
+    Task task{NoTimestamp()};
+    size_t parsed = 0;
+    // A missing file has no tasks, same as loadTasks()
+    scanTextLines(tasksFile, [&](std::string_view line) {
+        if (parseTaskEntry(line, task)) {
+            nextTaskId = std::max(nextTaskId, task.id + 1);
+            ++parsed;
+            visit(task);
+        }
+    });
+    Metrics::add(Metrics::TASKS_PARSED, parsed);
+    return true;
+}
+
+bool Storage::scanMoods(time_t from, time_t until, const std::function<void(const MoodEntry&)>& visit) {
+    auto inRange = [&](const MoodEntry& entry) { return entry.timestamp >= from && entry.timestamp < until; };
+    if (residentMoodsLoaded) {
+        for (const auto& entry : residentMoods) {
+            if (inRange(entry)) visit(entry);
+        }
+        return true;
+    }
+    
+    std::vector<JournalSegment> segments;
+    if (!loadSegmentIndex(segments)) {
+        return false;
+    }
+    // One segment in memory at a time, each recycling the last one's records
+    std::vector<MoodEntry> part;
+    for (const auto& segment : segments) {
+        nextMoodId = std::max(nextMoodId, segment.lastId + 1);
+        if (segment.lastTimestamp < from || segment.firstTimestamp >= until) continue;
+        if (!loadSegment(segment, part)) {
+            return false;
+        }
+        for (const auto& entry : part) {
+            if (inRange(entry)) visit(entry);
+        }
+    }
+    
+    MoodEntry entry{NoTimestamp()};
+    size_t parsed = 0;
+    scanTextLines(journalFile, [&](std::string_view line) {
+        if (parseMoodEntry(line, entry)) {
+            nextMoodId = std::max(nextMoodId, entry.id + 1);
+            ++parsed;
+            if (inRange(entry)) visit(entry);
+        }
+    });
+    Metrics::add(Metrics::MOODS_PARSED, parsed);
+    return true;
+}
+
+// Updates and deletes rewrite the whole task file. Once the resident store is
+// loaded it already holds every task, so it is changed first and written out;
+// otherwise the file is read back without loadTasks(), so listeners only hear
+// about the one task that changed instead of a full tasksLoaded.
+bool Storage::updateTask(const Task& task) {
+    WriteAccess access(*this);
+    if (access.elsewhere()) return forwardTaskUpdate(task);
+    if (!residentTasksLoaded) return rewriteTask(task);
+    return rewriteTask(keepInIdOrder(residentTasks, task));
+}
+
+bool Storage::updateTask(Task&& task) {
+    WriteAccess access(*this);
+    if (access.elsewhere()) return forwardTaskUpdate(task);
+    if (!residentTasksLoaded) return rewriteTask(task);
+    return rewriteTask(keepInIdOrder(residentTasks, std::move(task)));
+}
+
+bool Storage::forwardTaskUpdate(const Task& task) {
+    if (!forward({"edit-task", std::to_string(task.id), "--title", task.title, "--description", task.description,
+                  "--priority", std::to_string(static_cast<int>(task.priority)),
+                  "--difficulty", std::to_string(static_cast<int>(task.difficulty)),
+                  task.completed ? "--done" : "--open"}, nullptr)) {
+        return false;
+    }
+    long row = taskCols.find(task.id);
+    if (row >= 0) taskCols.set(static_cast<size_t>(row), task);
+    for (auto* listener : listeners) listener->taskSaved(task);
+    if (residentTasksLoaded) keepInIdOrder(residentTasks, task);
+    return true;
+}
+
+bool Storage::rewriteTask(const Task& updatedTask) {
+    MetricsTimer timer(Metrics::UPDATE_TASK);
+    std::vector<Task> loaded;
+    if (!residentTasksLoaded) {
+        loadTaskRecords(loaded, kSnapshotRefreshBytes); // A missing file reads as empty
+        for (auto& task : loaded) {
+            if (task.id == updatedTask.id) {
+                task = updatedTask;
+                break;
+            }
+        }
+    }
+    
+    if (!rewriteTaskFile(residentTasksLoaded ? residentTasks : loaded)) {
+        std::cerr << "Error: Could not open tasks file for updating" << std::endl;
+        residentTasksLoaded = false; // Out of step with the file; reload on next use
+        return false;
+    }
     
-    for (const auto& entry : std::filesystem::directory_iterator("data/backup")) {
-        if (entry.is_regular_file()) {
-            backups.push_back(entry.path().filename().string());
-            std::cout << "  " << entry.path().filename().string() << std::endl;
+    long row = taskCols.find(updatedTask.id);
+    if (row >= 0) taskCols.set(static_cast<size_t>(row), updatedTask);
+    for (auto* listener : listeners) listener->taskSaved(updatedTask);
+    return true;
+}
+
+bool Storage::deleteTask(int taskId) {
+    WriteAccess access(*this);
+    MetricsTimer timer(Metrics::DELETE_TASK);
+    std::vector<Task> loaded;
+    if (access.elsewhere()) {
+        if (!forward({"delete-task", std::to_string(taskId)}, nullptr)) return false;
+        if (residentTasksLoaded) eraseById(residentTasks, taskId);
+    } else if (residentTasksLoaded) {
+        if (!eraseById(residentTasks, taskId)) {
+            return false; // Task not found
+        }
+    } else {
+        loadTaskRecords(loaded, kSnapshotRefreshBytes);
+        auto it = std::find_if(loaded.begin(), loaded.end(),
+                               [taskId](const Task& task) { return task.id == taskId; });
+        if (it == loaded.end()) {
+            return false; // Task not found
         }
+        loaded.erase(it);
     }
     
-    if (backups.empty()) {
-        std::cout << "No backups found." << std::endl;
+    // Rewrite file without the deleted task
+    if (!access.elsewhere() && !rewriteTaskFile(residentTasksLoaded ? residentTasks : loaded)) {
+        residentTasksLoaded = false;
         return false;
     }
     
-    // For now, restore the most recent backup
-    // In a real app, you'd ask user which backup to restore
-    std::string latestBackup = backups.back();
+    long row = taskCols.find(taskId);
+    if (row >= 0) taskCols.erase(static_cast<size_t>(row));
+    for (auto* listener : listeners) listener->taskRemoved(taskId);
+    return true;
+}
+
+bool Storage::rewriteTaskFile(const std::vector<Task>& tasks) {
+    // As in rewriteHotJournal(), the snapshot can't vouch for a rewrite
+    std::error_code ec;
+    std::filesystem::remove(tasksSnapshotFile, ec);
+    std::ofstream file(tasksFile, std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    for (const auto& task : tasks) {
+        file << task.id << "|"
+             << task.title << "|"
+             << task.description << "|"
+             << priorityToString(task.priority) << "|"
+             << difficultyToString(task.difficulty) << "|"
+             << (task.completed ? "1" : "0") << "|"
+             << timeToString(task.created) << "|"
+             << timeToString(task.completed_time) << "\n";
+    }
+    
+    Metrics::add(Metrics::TASK_FILE_REWRITES, 1);
+    Metrics::add(Metrics::BYTES_WRITTEN, static_cast<uint64_t>(file.tellp()));
+    file.close();
+    return true;
+}
+
+bool Storage::updateMoodEntry(const MoodEntry& entry) {
+    WriteAccess access(*this);
+    if (access.elsewhere()) return writeRefused();
+    if (!rewriteMoodEntry(entry)) return false;
+    if (residentMoodsLoaded) keepInIdOrder(residentMoods, entry);
+    return true;
+}
+
+bool Storage::updateMoodEntry(MoodEntry&& entry) {
+    WriteAccess access(*this);
+    if (access.elsewhere()) return writeRefused();
+    if (!rewriteMoodEntry(entry)) return false;
+    if (residentMoodsLoaded) keepInIdOrder(residentMoods, std::move(entry));
+    return true;
+}
+
+bool Storage::rewriteMoodEntry(const MoodEntry& entry) {
+    MetricsTimer timer(Metrics::UPDATE_MOOD);
+    // Load the hot journal; sealed history is only touched if the entry lives there
+    std::vector<MoodEntry> entries;
+    if (!loadHotMoodEntries(entries)) {
+        return false;
+    }
     
-    // Restore tasks
-    std::string tasksBackup = "data/backup/" + latestBackup;
-    if (latestBackup.find("tasks_") == 0) {
-        if (!std::filesystem::copy_file(tasksBackup, tasksFile, std::filesystem::copy_options::overwrite_existing)) {
+    // Find and update the entry
+    auto it = std::find_if(entries.begin(), entries.end(),
+                           [&entry](const MoodEntry& moodEntry) { return moodEntry.id == entry.id; });
+    if (it == entries.end()) {
+        if (!rewriteSegmentEntry(entry.id, &entry)) {
             return false;
         }
+        long row = moodCols.find(entry.id);
+        if (row >= 0) moodCols.set(static_cast<size_t>(row), entry);
+        for (auto* listener : listeners) listener->moodUpdated(entry);
+        return true;
+    }
+    
+    *it = entry;
+    
+    // Rewrite file with updated data
+    if (!rewriteHotJournal(entries)) {
+        return false;
     }
     
-    // Restore journal
-    std::string journalBackup = "data/backup/" + latestBackup;
-    if (latestBackup.find("journal_") == 0) {
-        if (!std::filesystem::copy_file(journalBackup, journalFile, std::filesystem::copy_options::overwrite_existing)) {
+    long row = moodCols.find(entry.id);
+    if (row >= 0) moodCols.set(static_cast<size_t>(row), entry);
+    for (auto* listener : listeners) listener->moodUpdated(entry);
+    return true;
+}
+
+bool Storage::deleteMoodEntry(int entryId) {
+    WriteAccess access(*this);
+    if (access.elsewhere()) return writeRefused();
+    MetricsTimer timer(Metrics::DELETE_MOOD);
+    // Load the hot journal; sealed history is only touched if the entry lives there
+    std::vector<MoodEntry> entries;
+    if (!loadHotMoodEntries(entries)) {
+        return false;
+    }
+    
+    // Find and remove the entry
+    auto it = std::find_if(entries.begin(), entries.end(), 
+                          [entryId](const MoodEntry& entry) { return entry.id == entryId; });
+    
+    if (it == entries.end()) {
+        if (!rewriteSegmentEntry(entryId, nullptr)) {
+            return false;
+        }
+    } else {
+        entries.erase(it);
+        
+        // Rewrite file without the deleted entry
+        if (!rewriteHotJournal(entries)) {
             return false;
         }
     }
     
+    long row = moodCols.find(entryId);
+    if (row >= 0) moodCols.erase(static_cast<size_t>(row));
+    for (auto* listener : listeners) listener->moodRemoved(entryId);
+    if (residentMoodsLoaded) eraseById(residentMoods, entryId);
     return true;
 }
+
+// Backup and restore
+//
+// Every backup is a task/journal copy, a copy of the segment directory (its
+// index plus the segments it lists) and one line in the catalog:
+//   id|timestamp|tasksFile|journalFile|tasksBytes|tasksChecksum|journalBytes|journalChecksum|
+//   segmentsDir|segmentsBytes|segmentsChecksum
+// The catalog line is written last, so a snapshot only exists once every copy
+// does. Lines from before segments were backed up end after journalChecksum.
+
+bool Storage::hashFile(const std::string& path, uint64_t& hash, uintmax_t& bytes) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    // FNV-1a 64, continued from whatever hash already holds
+    char buffer[64 * 1024];
+    while (file) {
+        file.read(buffer, sizeof(buffer));
+        std::streamsize count = file.gcount();
+        for (std::streamsize i = 0; i < count; ++i) {
+            hash ^= static_cast<unsigned char>(buffer[i]);
+            hash *= 1099511628211ULL;
+        }
+        bytes += static_cast<uintmax_t>(count);
+    }
+    return true;
+}
+
+bool Storage::fileChecksum(const std::string& path, uint64_t& checksum, uintmax_t& bytes) {
+    uint64_t hash = 14695981039346656037ULL;
+    uintmax_t total = 0;
+    if (!hashFile(path, hash, total)) {
+        return false;
+    }
+    checksum = hash;
+    bytes = total;
+    return true;
+}
+
+bool Storage::segmentsChecksum(const std::string& dir, uint64_t& checksum, uintmax_t& bytes) {
+    uint64_t hash = 14695981039346656037ULL;
+    uintmax_t total = 0;
+    std::string index = dir + "/" + std::filesystem::path(segmentIndexFile).filename().string();
+    
+    // No index means nothing sealed, which checksums as an empty run
+    std::error_code ec;
+    if (std::filesystem::exists(index, ec)) {
+        std::vector<JournalSegment> segments;
+        if (!readSegmentIndex(index, segments) || !hashFile(index, hash, total)) {
+            return false;
+        }
+        for (const auto& segment : segments) {
+            if (!hashFile(dir + "/" + segment.file, hash, total)) {
+                return false;
+            }
+        }
+    }
+    
+    checksum = hash;
+    bytes = total;
+    return true;
+}
+
+bool Storage::copySegments(const std::string& from, const std::string& to) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::create_directories(to, ec);
+    if (ec) {
+        return false;
+    }
+    
+    // Only what the index lists; leftover .tmp files stay behind
+    std::string indexName = fs::path(segmentIndexFile).filename().string();
+    if (!fs::exists(from + "/" + indexName, ec)) {
+        return true;
+    }
+    std::vector<JournalSegment> segments;
+    if (!readSegmentIndex(from + "/" + indexName, segments)) {
+        return false;
+    }
+    if (!fs::copy_file(from + "/" + indexName, to + "/" + indexName, ec) || ec) {
+        return false;
+    }
+    for (const auto& segment : segments) {
+        if (!fs::copy_file(from + "/" + segment.file, to + "/" + segment.file, ec) || ec) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Storage::appendCatalogEntry(const BackupSnapshot& snapshot) {
+    std::ofstream file(catalogFile, std::ios::app);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open backup catalog for writing" << std::endl;
+        return false;
+    }
+    
+    file << snapshot.id << "|"
+         << timeToString(snapshot.timestamp) << "|"
+         << snapshot.tasksFile << "|"
+         << snapshot.journalFile << "|"
+         << snapshot.tasksBytes << "|"
+         << std::hex << snapshot.tasksChecksum << std::dec << "|"
+         << snapshot.journalBytes << "|"
+         << std::hex << snapshot.journalChecksum << std::dec;
+    if (!snapshot.segmentsDir.empty()) {
+        file << "|" << snapshot.segmentsDir << "|"
+             << snapshot.segmentsBytes << "|"
+             << std::hex << snapshot.segmentsChecksum << std::dec;
+    }
+    file << std::endl;
+    
+    file.close();
+    return true;
+}
+
+bool Storage::listBackups(std::vector<BackupSnapshot>& snapshots) {
+    snapshots.clear();
+    std::ifstream file(catalogFile);
+    if (!file.is_open()) {
+        return true; // No backups taken yet
+    }
+    
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+        
+        std::stringstream ss(line);
+        std::string token;
+        BackupSnapshot snapshot;
+        
+        try {
+            if (std::getline(ss, token, '|')) snapshot.id = std::stoi(token);
+            if (std::getline(ss, token, '|')) snapshot.timestamp = stringToTime(token);
+            if (std::getline(ss, snapshot.tasksFile, '|')) {}
+            if (std::getline(ss, snapshot.journalFile, '|')) {}
+            if (std::getline(ss, token, '|')) snapshot.tasksBytes = std::stoull(token);
+            if (std::getline(ss, token, '|')) snapshot.tasksChecksum = std::stoull(token, nullptr, 16);
+            if (std::getline(ss, token, '|')) snapshot.journalBytes = std::stoull(token);
+            if (std::getline(ss, token, '|')) snapshot.journalChecksum = std::stoull(token, nullptr, 16);
+            if (std::getline(ss, snapshot.segmentsDir, '|')) {}
+            if (std::getline(ss, token, '|')) snapshot.segmentsBytes = std::stoull(token);
+            if (std::getline(ss, token, '|')) snapshot.segmentsChecksum = std::stoull(token, nullptr, 16);
+        } catch (...) {
+            continue; // Skip damaged catalog lines
+        }
+        
+        snapshots.push_back(snapshot);
+    }
+    
+    // Catalog is appended in time order, but imported entries may not be
+    std::stable_sort(snapshots.begin(), snapshots.end(),
+                     [](const BackupSnapshot& a, const BackupSnapshot& b) { return a.timestamp < b.timestamp; });
+    
+    file.close();
+    return true;
+}
+
+bool Storage::backupData() {
+    WriteAccess access(*this); // Also keeps rewrites out of the copies
+    if (access.elsewhere()) return writeRefused();
+    MetricsTimer timer(Metrics::BACKUP);
+    std::error_code ec;
+    std::filesystem::create_directories(backupDir, ec);
+    if (ec) {
+        return false;
+    }
+    
+    std::vector<BackupSnapshot> snapshots;
+    if (!listBackups(snapshots)) {
+        return false;
+    }
+    
+    BackupSnapshot snapshot;
+    for (const auto& existing : snapshots) {
+        snapshot.id = std::max(snapshot.id, existing.id);
+    }
+    snapshot.id++;
+    snapshot.timestamp = time(nullptr);
+    
+    // The id keeps names unique when several backups happen within one second
+    std::string suffix = timeToString(snapshot.timestamp) + "_" + std::to_string(snapshot.id);
+    snapshot.tasksFile = "tasks_" + suffix + ".txt";
+    snapshot.journalFile = "journal_" + suffix + ".txt";
+    snapshot.segmentsDir = "segments_" + suffix;
+    
+    std::string tasksBackup = backupDir + "/" + snapshot.tasksFile;
+    std::string journalBackup = backupDir + "/" + snapshot.journalFile;
+    std::string segmentsBackup = backupDir + "/" + snapshot.segmentsDir;
+    
+    if (!std::filesystem::copy_file(tasksFile, tasksBackup, ec) || ec) {
+        return false;
+    }
+    if (!std::filesystem::copy_file(journalFile, journalBackup, ec) || ec) {
+        std::filesystem::remove(tasksBackup, ec);
+        return false;
+    }
+    // The hot journal only means something next to the segments sealed out of it
+    if (!copySegments(segmentDir, segmentsBackup)) {
+        std::cerr << "Error: Could not back up journal segments" << std::endl;
+        std::filesystem::remove(tasksBackup, ec);
+        std::filesystem::remove(journalBackup, ec);
+        std::filesystem::remove_all(segmentsBackup, ec);
+        return false;
+    }
+    
+    // Checksum the copies, not the live files, so the catalog describes what is on disk
+    if (!fileChecksum(tasksBackup, snapshot.tasksChecksum, snapshot.tasksBytes) ||
+        !fileChecksum(journalBackup, snapshot.journalChecksum, snapshot.journalBytes) ||
+        !segmentsChecksum(segmentsBackup, snapshot.segmentsChecksum, snapshot.segmentsBytes)) {
+        return false;
+    }
+    
+    return appendCatalogEntry(snapshot);
+}
+
+bool Storage::rebuildBackupCatalog() {
+    WriteAccess access(*this);
+    if (access.elsewhere()) return writeRefused();
+    std::error_code ec;
+    if (!std::filesystem::exists(backupDir, ec)) {
+        return true;
+    }
+    
+    std::vector<BackupSnapshot> snapshots;
+    if (!listBackups(snapshots)) {
+        return false;
+    }
+    
+    std::set<std::string> known;
+    int lastId = 0;
+    for (const auto& snapshot : snapshots) {
+        known.insert(snapshot.tasksFile);
+        lastId = std::max(lastId, snapshot.id);
+    }
+    
+    // Pair up legacy tasks_<timestamp>.txt / journal_<timestamp>.txt files
+    std::map<std::string, std::pair<std::string, std::string>> pairs;
+    for (const auto& entry : std::filesystem::directory_iterator(backupDir, ec)) {
+        if (!entry.is_regular_file()) continue;
+        
+        std::string name = entry.path().filename().string();
+        if (name.size() < 4 || name.compare(name.size() - 4, 4, ".txt") != 0) continue;
+        
+        if (name.find("tasks_") == 0) {
+            pairs[name.substr(6)].first = name;
+        } else if (name.find("journal_") == 0) {
+            pairs[name.substr(8)].second = name;
+        }
+    }
+    
+    for (const auto& pair : pairs) {
+        const std::string& tasksName = pair.second.first;
+        const std::string& journalName = pair.second.second;
+        if (tasksName.empty() || journalName.empty()) continue;
+        if (known.count(tasksName)) continue;
+        
+        BackupSnapshot snapshot;
+        snapshot.id = ++lastId;
+        snapshot.timestamp = stringToTime(pair.first.substr(0, pair.first.find_first_of("_.")));
+        snapshot.tasksFile = tasksName;
+        snapshot.journalFile = journalName;
+        
+        if (!fileChecksum(backupDir + "/" + tasksName, snapshot.tasksChecksum, snapshot.tasksBytes) ||
+            !fileChecksum(backupDir + "/" + journalName, snapshot.journalChecksum, snapshot.journalBytes)) {
+            continue;
+        }
+        
+        // A segments_ copy taken alongside the pair shares its suffix
+        std::string segmentsName = "segments_" + pair.first.substr(0, pair.first.size() - 4);
+        if (std::filesystem::is_directory(backupDir + "/" + segmentsName, ec) &&
+            segmentsChecksum(backupDir + "/" + segmentsName, snapshot.segmentsChecksum, snapshot.segmentsBytes)) {
+            snapshot.segmentsDir = segmentsName;
+        }
+        
+        if (!appendCatalogEntry(snapshot)) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+bool Storage::restoreSnapshot(const BackupSnapshot& snapshot) {
+    WriteAccess access(*this);
+    if (access.elsewhere()) return writeRefused();
+    MetricsTimer timer(Metrics::RESTORE);
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    
+    // Stage everything next to the backups (same filesystem, so the swap is a rename)
+    std::string stagingDir = backupDir + "/staging";
+    fs::remove_all(stagingDir, ec);
+    fs::create_directories(stagingDir, ec);
+    if (ec) {
+        return false;
+    }
+    
+    std::string stagedTasks = stagingDir + "/tasks.txt";
+    std::string stagedJournal = stagingDir + "/journal.txt";
+    std::string stagedSegments = stagingDir + "/segments";
+    bool withSegments = !snapshot.segmentsDir.empty();
+    
+    if (!fs::copy_file(backupDir + "/" + snapshot.tasksFile, stagedTasks, ec) || ec ||
+        !fs::copy_file(backupDir + "/" + snapshot.journalFile, stagedJournal, ec) || ec ||
+        (withSegments && !copySegments(backupDir + "/" + snapshot.segmentsDir, stagedSegments))) {
+        std::cerr << "Error: Backup " << snapshot.id << " is missing files" << std::endl;
+        fs::remove_all(stagingDir, ec);
+        return false;
+    }
+    
+    // Fast reject on size, then verify contents against the catalog
+    if (fs::file_size(stagedTasks, ec) != snapshot.tasksBytes ||
+        fs::file_size(stagedJournal, ec) != snapshot.journalBytes) {
+        std::cerr << "Error: Backup " << snapshot.id << " has the wrong size" << std::endl;
+        fs::remove_all(stagingDir, ec);
+        return false;
+    }
+    
+    uint64_t tasksChecksum = 0, journalChecksum = 0, stagedSegmentsChecksum = 0;
+    uintmax_t tasksBytes = 0, journalBytes = 0, segmentsBytes = 0;
+    if (!fileChecksum(stagedTasks, tasksChecksum, tasksBytes) ||
+        !fileChecksum(stagedJournal, journalChecksum, journalBytes) ||
+        tasksChecksum != snapshot.tasksChecksum ||
+        journalChecksum != snapshot.journalChecksum ||
+        (withSegments && (!segmentsChecksum(stagedSegments, stagedSegmentsChecksum, segmentsBytes) ||
+                          segmentsBytes != snapshot.segmentsBytes ||
+                          stagedSegmentsChecksum != snapshot.segmentsChecksum))) {
+        std::cerr << "Error: Backup " << snapshot.id << " failed its integrity check" << std::endl;
+        fs::remove_all(stagingDir, ec);
+        return false;
+    }
+    if (!withSegments) {
+        std::cerr << "Warning: Backup " << snapshot.id
+                  << " predates segment backups; sealed journal segments are left as they are" << std::endl;
+    }
+    
+    // Keep the live set until every staged piece is in place. Without those
+    // copies a failed swap below couldn't be rolled back, so stop here instead.
+    std::string previousTasks = stagingDir + "/tasks.prev";
+    std::string previousJournal = stagingDir + "/journal.prev";
+    std::string previousSegments = stagingDir + "/segments.prev";
+    auto setAside = [&](const std::string& live, const std::string& previous) {
+        bool present = fs::exists(live, ec);
+        if (ec) return false;
+        return !present || (fs::copy_file(live, previous, ec) && !ec);
+    };
+    if (!setAside(tasksFile, previousTasks) || !setAside(journalFile, previousJournal)) {
+        std::cerr << "Error: Could not set the current data aside (" << ec.message()
+                  << "); nothing was restored" << std::endl;
+        fs::remove_all(stagingDir, ec);
+        return false;
+    }
+    
+    bool hadSegments = fs::exists(segmentDir, ec);
+    auto rollBackSegments = [&]() {
+        if (!withSegments) return;
+        fs::remove_all(segmentDir, ec);
+        if (hadSegments) fs::rename(previousSegments, segmentDir, ec);
+    };
+    
+    if (withSegments) {
+        if (hadSegments) {
+            fs::rename(segmentDir, previousSegments, ec);
+            if (ec) {
+                fs::remove_all(stagingDir, ec);
+                return false;
+            }
+        }
+        fs::rename(stagedSegments, segmentDir, ec);
+        if (ec) {
+            rollBackSegments();
+            fs::remove_all(stagingDir, ec);
+            return false;
+        }
+    }
+    fs::rename(stagedTasks, tasksFile, ec);
+    if (ec) {
+        rollBackSegments();
+        fs::remove_all(stagingDir, ec);
+        return false;
+    }
+    fs::rename(stagedJournal, journalFile, ec);
+    if (ec) {
+        // Roll the other pieces back so the set stays consistent
+        fs::rename(previousTasks, tasksFile, ec);
+        rollBackSegments();
+        fs::remove_all(stagingDir, ec);
+        return false;
+    }
+    
+    fs::remove_all(stagingDir, ec);
+    
+    // The stats summary and the snapshots describe the data that was replaced
+    fs::remove(summaryFile, ec);
+    fs::remove(tasksSnapshotFile, ec);
+    fs::remove(moodsSnapshotFile, ec);
+    
+    // Ids must be recomputed from the restored data, and the store reloaded
+    nextTaskId = 1;
+    nextMoodId = 1;
+    residentTasksLoaded = false;
+    residentMoodsLoaded = false;
+    RecordSpan<Task> tasks;
+    RecordSpan<MoodEntry> entries;
+    taskSpan(tasks);
+    moodSpan(std::numeric_limits<time_t>::min(), entries);
+    return true;
+}
+
+bool Storage::restoreToTime(time_t pointInTime) {
+    std::vector<BackupSnapshot> snapshots;
+    if (!listBackups(snapshots)) {
+        return false;
+    }
+    
+    // Snapshots are sorted by time; walk back to the newest one not after pointInTime
+    for (auto it = snapshots.rbegin(); it != snapshots.rend(); ++it) {
+        if (it->timestamp <= pointInTime) {
+            return restoreSnapshot(*it);
+        }
+    }
+    
+    return false; // No backup old enough
+}
+
+bool Storage::restoreData() {
+    return restoreToTime(std::numeric_limits<time_t>::max());
+}
@@ -7,6 +7,15 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <cstdint>
+#include <string_view>
+#include <functional>
+#include <set>
+#include <utility>
+#include "BlockCodec.h"
+#include "Keyword.h"
+#include "RecordColumns.h"
+#include "RecordView.h"
 
 // Data structures
 enum class Priority {
@@ -29,6 +38,9 @@ enum class MoodLevel {
     EXCELLENT = 5
 };
 
+// Tag for records a loader is about to fill in; skips the time() call in the default constructors
+struct NoTimestamp {};
+
 struct Task {
     int id;
     std::string title;
@@ -41,6 +53,8 @@ struct Task {
     
     Task() : id(0), priority(Priority::MEDIUM), difficulty(TaskDifficulty::MEDIUM), 
              completed(false), created(time(nullptr)), completed_time(0) {}
+    explicit Task(NoTimestamp) : id(0), priority(Priority::MEDIUM), difficulty(TaskDifficulty::MEDIUM),
+                                 completed(false), created(0), completed_time(0) {}
 };
 
 struct MoodEntry {
@@ -48,52 +62,285 @@ struct MoodEntry {
     std::string content;
     MoodLevel mood;
     time_t timestamp;
-    std::vector<std::string> keywords;
-    std::vector<std::string> extractedKeywords;  // NEW: Auto-extracted keywords
+    std::vector<Keyword> keywords;               // Interned, see Keyword.h
+    std::vector<Keyword> extractedKeywords;      // NEW: Auto-extracted keywords
     double sentimentScore;                       // NEW: Basic sentiment score (-1.0 to 1.0)
     
     MoodEntry() : id(0), mood(MoodLevel::NEUTRAL), timestamp(time(nullptr)), sentimentScore(0.0) {}
+    explicit MoodEntry(NoTimestamp) : id(0), mood(MoodLevel::NEUTRAL), timestamp(0), sentimentScore(0.0) {}
+};
+
+// One catalogued backup: the task file, the hot journal and the sealed
+// journal segments captured together
+struct BackupSnapshot {
+    int id;
+    time_t timestamp;
+    std::string tasksFile;        // File name inside the backup directory
+    std::string journalFile;
+    std::string segmentsDir;      // Copy of the segment directory; empty for backups that predate it
+    uintmax_t tasksBytes;
+    uintmax_t journalBytes;
+    uintmax_t segmentsBytes;      // Index plus segment files
+    uint64_t tasksChecksum;       // FNV-1a 64 over the file contents
+    uint64_t journalChecksum;
+    uint64_t segmentsChecksum;    // Chained over the index, then each segment in index order
+    
+    BackupSnapshot() : id(0), timestamp(0), tasksBytes(0), journalBytes(0), segmentsBytes(0),
+                       tasksChecksum(0), journalChecksum(0), segmentsChecksum(0) {}
+};
+
+// Index entry for one sealed, compressed slice of journal history
+struct JournalSegment {
+    std::string file;             // File name inside the segment directory
+    time_t firstTimestamp;
+    time_t lastTimestamp;
+    int firstId;
+    int lastId;
+    size_t entryCount;
+    uintmax_t rawBytes;
+    uintmax_t storedBytes;
+    BlockCodec::Codec codec;
+    
+    JournalSegment() : firstTimestamp(0), lastTimestamp(0), firstId(0), lastId(0), entryCount(0),
+                       rawBytes(0), storedBytes(0), codec(BlockCodec::Codec::NONE) {}
 };
 
+// Headline numbers from the last statistics pass, saved so the GUI can show
+// them at startup before anything has been loaded
+struct StatsSummary {
+    int totalTasks;
+    int completedTasks;
+    int totalMoods;
+    bool hasCorrelation;          // Enough paired days for moodTaskCorrelation to mean something
+    double moodTaskCorrelation;   // Pearson r, mood vs. completed tasks over 90 days
+    time_t updated;
+    
+    StatsSummary() : totalTasks(0), completedTasks(0), totalMoods(0), hasCorrelation(false),
+                     moodTaskCorrelation(0.0), updated(0) {}
+};
+
+// Told about successful writes and full loads, so derived views (rankers,
+// indexes) can update incrementally instead of rescanning. Callbacks run
+// synchronously on the thread that called into Storage.
+class StorageListener {
+public:
+    virtual ~StorageListener() = default;
+    virtual void tasksLoaded(const std::vector<Task>& tasks) { (void)tasks; }
+    virtual void taskSaved(const Task& task) { (void)task; }       // New or updated
+    virtual void taskRemoved(int taskId) { (void)taskId; }
+    virtual void moodSaved(const MoodEntry& entry) { (void)entry; }         // New entries only
+    virtual void moodsLoaded(const std::vector<MoodEntry>& entries) { (void)entries; }   // Full history
+    virtual void moodUpdated(const MoodEntry& entry) { (void)entry; }
+    virtual void moodRemoved(int entryId) { (void)entryId; }
+};
+
+struct SourceStamp;
+
 class Storage {
 private:
     std::string tasksFile;
     std::string journalFile;
+    std::string backupDir;
+    std::string catalogFile;
+    std::string segmentDir;
+    std::string segmentIndexFile;
+    std::string summaryFile;
+    std::string tasksSnapshotFile;
+    std::string moodsSnapshotFile;
+    std::string lockFile;
     int nextTaskId;
     int nextMoodId;
     
+    // Columnar mirrors of the last full load, kept in step with writes
+    TaskColumns taskCols;
+    MoodColumns moodCols;
+    bool taskColsLoaded;
+    bool moodColsLoaded;
+    
+    // Resident store (see setResident()); without it, reused by each span load
+    std::vector<Task> residentTasks;            // Id order once loaded
+    std::vector<MoodEntry> residentMoods;
+    bool resident;
+    bool residentTasksLoaded;
+    bool residentMoodsLoaded;
+    
+    // The data's writer lock (see lockWriter()): held for good by moodood,
+    // otherwise taken per write by WriteAccess
+    int writerLockFd;
+    int writeDepth;
+    
+    std::vector<StorageListener*> listeners;
+    
     // Helper methods
     std::string priorityToString(Priority priority);
-    Priority stringToPriority(const std::string& str);
+    Priority stringToPriority(std::string_view str);
     std::string difficultyToString(TaskDifficulty difficulty);
-    TaskDifficulty stringToDifficulty(const std::string& str);
+    TaskDifficulty stringToDifficulty(std::string_view str);
     std::string moodToString(MoodLevel mood);
-    MoodLevel stringToMood(const std::string& str);
+    MoodLevel stringToMood(std::string_view str);
     std::string timeToString(time_t time);
-    time_t stringToTime(const std::string& str);
+    time_t stringToTime(std::string_view str);
+    
+    // Loader helpers
+    static bool readFile(const std::string& path, std::string& contents);
+    static std::vector<std::pair<size_t, size_t>> splitLines(const std::string& text, size_t maxChunks,
+                                                             size_t from = 0);
+    static void forEachLine(const std::string& text, std::pair<size_t, size_t> range,
+                            const std::function<void(std::string_view)>& visit);
+    static bool nextField(std::string_view& rest, std::string_view& field, char delimiter = '|');
+    bool parseTaskEntry(std::string_view line, Task& task);
+    bool appendTask(const Task& task);
+    bool rewriteTask(const Task& updatedTask);
+    bool rewriteTaskFile(const std::vector<Task>& tasks);
+    template <typename Record, typename Parse>
+    size_t parseLines(const std::string& text, size_t from, std::vector<Record>& records, size_t used,
+                      int& nextId, const char* spanName, Parse parse);
+    // Fill records from slot used on; return the new used count (see recycle())
+    size_t parseTasks(const std::string& text, size_t from, std::vector<Task>& tasks, size_t used);
+    
+    // Warm-start snapshots (see WarmSnapshot.h)
+    // rehashed: the file had to be hashed to be trusted, and a new stamp would spare the next load that
+    static bool readSince(const std::string& path, const SourceStamp& covered, std::string& contents,
+                          size_t& skip, SourceStamp& current, bool& stamped, bool& rehashed);
+    void segmentIndexStamp(SourceStamp& stamp);
+    bool loadTaskRecords(std::vector<Task>& tasks, size_t refreshAfter);
+    bool loadMoodRecords(time_t since, std::vector<MoodEntry>& entries, size_t refreshAfter);
+    
+    // Backup helpers
+    bool appendCatalogEntry(const BackupSnapshot& snapshot);
+    bool restoreSnapshot(const BackupSnapshot& snapshot);
+    static bool fileChecksum(const std::string& path, uint64_t& checksum, uintmax_t& bytes);
+    static bool hashFile(const std::string& path, uint64_t& hash, uintmax_t& bytes);
+    bool segmentsChecksum(const std::string& dir, uint64_t& checksum, uintmax_t& bytes);
+    bool copySegments(const std::string& from, const std::string& to);
+    
+    // Held for the length of one write. elsewhere() when moodood holds the
+    // data: task and mood writes are then sent to it (forward()), edits it has
+    // no command for are refused (writeRefused()) and background writes skipped.
+    class WriteAccess;
+    bool forward(const std::vector<std::string>& args, long long* id);
+    bool forwardTask(Task task);
+    bool forwardTaskUpdate(const Task& task);
+    bool forwardMoodEntry(MoodEntry entry);
+    bool writeRefused() const;                  // Prints why; always false
+    
+    // Journal helpers
+    void writeMoodEntry(std::ostream& out, const MoodEntry& entry);
+    bool parseMoodEntry(std::string_view line, MoodEntry& entry);
+    bool appendMoodEntry(const MoodEntry& entry);
+    bool rewriteMoodEntry(const MoodEntry& entry);
+    static bool scanTextLines(const std::string& path, const std::function<void(std::string_view)>& visit);
+    size_t parseMoods(const std::string& text, size_t from, std::vector<MoodEntry>& entries, size_t used);
+    bool loadHotMoodEntries(std::vector<MoodEntry>& entries);
+    bool rewriteHotJournal(const std::vector<MoodEntry>& entries);
+    bool loadSegment(const JournalSegment& segment, std::vector<MoodEntry>& entries);
+    bool writeSegment(const std::vector<MoodEntry>& entries, JournalSegment& segment);
+    bool saveSegmentIndex(const std::vector<JournalSegment>& segments);
+    bool readSegmentIndex(const std::string& path, std::vector<JournalSegment>& segments);
+    bool rewriteSegmentEntry(int entryId, const MoodEntry* replacement);
+    bool sealedIdsAmong(const std::vector<MoodEntry>& hot, const std::vector<JournalSegment>& segments,
+                        std::set<int>& sealedIds);
+    // Drops hot entries a segment already holds and renumbers repeated hot
+    // ids; true when the hot file was rewritten
+    bool repairJournalIds(const std::vector<JournalSegment>& segments);
 
 public:
+    // Journal entries older than this are sealed into cold segments
+    static const time_t kHotJournalAge = 8 * 7 * 24 * 60 * 60;
+    // Width of the time window covered by one cold segment
+    static const time_t kSegmentSpan = 4 * 7 * 24 * 60 * 60;
+    // Text appended past a snapshot before a load rewrites it
+    static const size_t kSnapshotRefreshBytes = 1024 * 1024;
+    
+    // Loaders recycle the records already in the caller's vector: slot i is
+    // overwritten in place, keeping its strings' capacity, and the vector is
+    // trimmed afterwards. Keep the vector across reloads and they stop allocating.
+    template <typename Record>
+    static Record& recycle(std::vector<Record>& records, size_t slot) {
+        if (slot < records.size()) return records[slot];
+        records.emplace_back(NoTimestamp());
+        return records.back();
+    }
+    // Leaves 1/8 headroom, so a few appends between reloads don't reallocate
+    template <typename Record>
+    static void reserveFor(std::vector<Record>& records, size_t count) {
+        if (records.capacity() < count) records.reserve(count + count / 8);
+    }
+    
     Storage(const std::string& tasksFile = "data/tasks.txt", 
             const std::string& journalFile = "data/journal.txt");
+    ~Storage();
+    Storage(const Storage&) = delete;
+    Storage& operator=(const Storage&) = delete;
     
-    // Task operations
+    // Task operations; the rvalue forms move the task into the resident store
     bool saveTask(const Task& task);
-    bool loadTasks(std::vector<Task>& tasks);
+    bool saveTask(Task&& task);
+    bool loadTasks(std::vector<Task>& tasks);   // Replaces tasks, recycling its records
     bool updateTask(const Task& task);
+    bool updateTask(Task&& task);
     bool deleteTask(int taskId);
     
     // Journal operations
     bool saveMoodEntry(const MoodEntry& entry);
-    bool loadMoodEntries(std::vector<MoodEntry>& entries);
+    bool saveMoodEntry(MoodEntry&& entry);
+    bool loadMoodEntries(std::vector<MoodEntry>& entries);        // Full history, cold segments included
+    bool loadRecentMoodEntries(time_t since, std::vector<MoodEntry>& entries);  // Skips cold segments older than since
     bool updateMoodEntry(const MoodEntry& entry);
+    bool updateMoodEntry(MoodEntry&& entry);
     bool deleteMoodEntry(int entryId);
     
+    // Streaming readers: each record is handed to visit and then overwritten by
+    // the next, so nothing the size of the files is built. Journal entries come
+    // in load order, cold segments first, and only segments overlapping
+    // [from, until) are read. Both walk the resident store instead once it's loaded.
+    bool forEachTask(const std::function<void(const Task&)>& visit);
+    bool scanMoods(time_t from, time_t until, const std::function<void(const MoodEntry&)>& visit);
+    
+    // Keeps tasks and the whole journal in memory, in id order, from their
+    // first span load on, and follows every write instead of reloading. Only
+    // safe in the files' single writer (moodood).
+    void setResident();
+    // Spans over the store, valid until the next call that writes or loads.
+    // Not resident, each call reloads into the same records (see recycle()),
+    // and moodSpan stops at since like loadRecentMoodEntries().
+    bool taskSpan(RecordSpan<Task>& tasks);
+    bool moodSpan(time_t since, RecordSpan<MoodEntry>& entries);
+    
+    // Makes this the data's only writer until it is destroyed (moodood does
+    // this at startup). Every other Storage then sends its writes to the
+    // daemon. False, with a message, while someone else holds the data.
+    bool lockWriter();
+    
     // Utility methods
     int getNextTaskId();
     int getNextMoodId();
     void initializeFiles();
     bool backupData();
-    bool restoreData();
+    bool restoreData();                         // Restores the most recent snapshot
+    bool restoreToTime(time_t pointInTime);     // Restores the newest snapshot taken at or before pointInTime
+    bool listBackups(std::vector<BackupSnapshot>& snapshots);
+    bool rebuildBackupCatalog();                // Imports uncatalogued tasks_/journal_ pairs (and segments_ copies)
+    
+    // Cold journal segments
+    bool loadSegmentIndex(std::vector<JournalSegment>& segments);
+    bool sealJournalSegments(time_t olderThan);
+    
+    // Startup stats summary; false when none has been saved yet
+    bool loadStatsSummary(StatsSummary& summary);
+    bool saveStatsSummary(const StatsSummary& summary);
+    
+    // Rewrites whichever warm-start snapshot the files have moved past; for clean shutdown
+    bool saveSnapshots();
+    
+    // Columnar views for analytics; valid after loadTasks()/loadMoodEntries() or loadColumns()
+    bool loadColumns();                         // Full loads for whichever view hasn't had one yet
+    const TaskColumns& taskColumns() const { return taskCols; }
+    const MoodColumns& moodColumns() const { return moodCols; }
+    
+    // Listeners are not owned and must outlive their registration
+    void addListener(StorageListener* listener);
+    void removeListener(StorageListener* listener);
     
     // Getter methods for file paths
     std::string getTasksFile() const { return tasksFile; }
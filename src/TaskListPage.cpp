@@ -1,8 +1,10 @@
 #include "TaskListPage.h"
 #include <QMessageBox>
+#include <unordered_map>
+#include "Trace.h"
 
-TaskListPage::TaskListPage(Storage* storage, QWidget *parent)
-    : QWidget(parent), storage(storage)
+TaskListPage::TaskListPage(Storage* storage, const QueryEngine* queryEngine, QWidget *parent)
+    : QWidget(parent), storage(storage), queryEngine(queryEngine)
 {
     setWindowTitle("📋 All Your Tasks - MooDoo");
     setWindowFlags(Qt::Window);
@@ -42,7 +44,7 @@ void TaskListPage::setupUI()
     
     QLineEdit *searchBox = new QLineEdit(this);
     searchBox->setObjectName("searchBox");
-    searchBox->setPlaceholderText("Type to search tasks...");
+    searchBox->setPlaceholderText("Search, or filter like priority:high created:>7d is:open report");
     searchBox->setStyleSheet(
         "QLineEdit { "
         "   padding: 8px; "
@@ -170,45 +172,44 @@ void TaskListPage::setupUI()
 
 void TaskListPage::refreshTaskList()
 {
+    MOODOO_TRACE_SCOPE("ui", "refreshTaskList");
     taskListWidget->clear();
     
-    std::vector<Task> tasks;
-    if (storage->loadTasks(tasks)) {
-        if (tasks.empty()) {
-            taskListWidget->addItem("No tasks found. Add some tasks to get started!");
-            return;
+    // Items are added as the file is read; the list needs no copy of the tasks
+    bool any = false;
+    bool loaded = storage->forEachTask([&](const Task& task) {
+        QString taskText;
+        
+        // Add priority indicator
+        switch(task.priority) {
+            case Priority::LOW: taskText += "🟢 "; break;
+            case Priority::HIGH: taskText += "🔴 "; break;
+            default: taskText += "🟡 "; break;
         }
         
-        for (const auto& task : tasks) {
-            QString taskText;
-            
-            // Add priority indicator
-            switch(task.priority) {
-                case Priority::LOW: taskText += "🟢 "; break;
-                case Priority::HIGH: taskText += "🔴 "; break;
-                default: taskText += "🟡 "; break;
-            }
-            
-            // Add difficulty indicator
-            switch(task.difficulty) {
-                case TaskDifficulty::EASY: taskText += "📚 "; break;
-                case TaskDifficulty::HARD: taskText += "💪 "; break;
-                default: taskText += "📝 "; break;
-            }
-            
-            // Add task title
-            taskText += QString::fromStdString(task.title);
-            
-            // Add description if available
-            if (!task.description.empty()) {
-                taskText += " - " + QString::fromStdString(task.description);
-            }
-            
-            // Create list item (no need to store task ID for viewing only)
-            taskListWidget->addItem(taskText);
+        // Add difficulty indicator
+        switch(task.difficulty) {
+            case TaskDifficulty::EASY: taskText += "📚 "; break;
+            case TaskDifficulty::HARD: taskText += "💪 "; break;
+            default: taskText += "📝 "; break;
         }
-    } else {
+        
+        // Add task title
+        taskText += QString::fromStdString(task.title);
+        
+        // Add description if available
+        if (!task.description.empty()) {
+            taskText += " - " + QString::fromStdString(task.description);
+        }
+        
+        // Create list item (no need to store task ID for viewing only)
+        taskListWidget->addItem(taskText);
+        any = true;
+    });
+    if (!loaded) {
         taskListWidget->addItem("Error loading tasks");
+    } else if (!any) {
+        taskListWidget->addItem("No tasks found. Add some tasks to get started!");
     }
 }
 
@@ -225,73 +226,15 @@ void TaskListPage::onRefreshClicked()
 
 void TaskListPage::onPriorityFilterChanged(int index)
 {
-    // Get the selected priority value
-    QComboBox *priorityFilter = findChild<QComboBox*>("priorityFilter");
-    if (!priorityFilter) return;
-    
-    int priorityValue = priorityFilter->itemData(index).toInt();
-    
-    // Clear and reload tasks with filter
-    taskListWidget->clear();
-    
-    std::vector<Task> tasks;
-    if (storage->loadTasks(tasks)) {
-        if (tasks.empty()) {
-            taskListWidget->addItem("No tasks found. Add some tasks to get started!");
-            return;
-        }
-        
-        for (const auto& task : tasks) {
-            // Apply priority filter
-            if (priorityValue != -1 && static_cast<int>(task.priority) != priorityValue) {
-                continue;
-            }
-            
-            QString taskText;
-            
-            // Add priority indicator
-            switch(task.priority) {
-                case Priority::LOW: taskText += "🟢 "; break;
-                case Priority::HIGH: taskText += "🔴 "; break;
-                default: taskText += "🟡 "; break;
-            }
-            
-            // Add difficulty indicator
-            switch(task.difficulty) {
-                case TaskDifficulty::EASY: taskText += "📚 "; break;
-                case TaskDifficulty::HARD: taskText += "💪 "; break;
-                default: taskText += "📝 "; break;
-            }
-            
-            // Add task title
-            taskText += QString::fromStdString(task.title);
-            
-            // Add description if available
-            if (!task.description.empty()) {
-                taskText += " - " + QString::fromStdString(task.description);
-            }
-            
-            taskListWidget->addItem(taskText);
-        }
-        
-        // Show filter status
-        if (priorityValue != -1) {
-            QString filterText;
-            
-            switch(priorityValue) {
-                case static_cast<int>(Priority::LOW): filterText = "🟢 Low Priority"; break;
-                case static_cast<int>(Priority::MEDIUM): filterText = "🟡 Medium Priority"; break;
-                case static_cast<int>(Priority::HIGH): filterText = "🔴 High Priority"; break;
-            }
-            taskListWidget->addItem("--- Showing " + filterText + " tasks ---");
-        }
-    } else {
-        taskListWidget->addItem("Error loading tasks");
-    }
-} 
+    Q_UNUSED(index);
+    // The dropdown is one more query condition; see onSearchTextChanged
+    QLineEdit *searchInput = findChild<QLineEdit*>("searchBox");
+    onSearchTextChanged(searchInput ? searchInput->text() : QString());
+}
 
 void TaskListPage::onSearchTextChanged(const QString& searchText)
 {
+    MOODOO_TRACE_SCOPE("ui", "onSearchTextChanged");
     // Get current priority filter
     QComboBox *priorityFilter = findChild<QComboBox*>("priorityFilter");
     int priorityValue = -1;
@@ -302,28 +245,86 @@ void TaskListPage::onSearchTextChanged(const QString& searchText)
     // Clear and reload tasks with search and priority filter
     taskListWidget->clear();
     
-    std::vector<Task> tasks;
     if (storage->loadTasks(tasks)) {
         if (tasks.empty()) {
             taskListWidget->addItem("No tasks found. Add some tasks to get started!");
             return;
         }
         
+        std::unordered_map<int, size_t> positionById;
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            positionById[tasks[i].id] = i;
+        }
+        std::vector<const Task*> ordered;
+        std::vector<bool> listed(tasks.size(), false);
+        auto list = [&](int id) {
+            auto found = positionById.find(id);
+            if (found != positionById.end() && !listed[found->second]) {
+                listed[found->second] = true;
+                ordered.push_back(&tasks[found->second]);
+            }
+        };
+        
+        // The search box takes a query (priority:high created:>7d report); the
+        // priority dropdown adds one more condition
+        Query query;
+        std::string queryError;
+        bool parsed = queryEngine && Query::parse(searchText.toStdString(), Query::Target::TASKS, query, queryError);
+        if (parsed && query.empty()) {
+            // Nothing typed: every task in file order; the dropdown is applied below
+            MOODOO_TRACE_SCOPE("ui", "listAll");
+            for (size_t i = 0; i < tasks.size(); ++i) {
+                listed[i] = true;
+                ordered.push_back(&tasks[i]);
+            }
+        } else if (parsed) {
+            MOODOO_TRACE_SCOPE("ui", "runQuery");
+            if (priorityValue != -1) {
+                query.conditions.push_back({Query::PRIORITY, priorityValue, priorityValue});
+            }
+            std::vector<int> ids;
+            queryEngine->execute(query, ids);
+            for (int id : ids) list(id);
+            
+            // Text inside a word isn't in the search index; keep the old
+            // substring matches, under the same conditions, after the ranked ones
+            if (!query.text.empty()) {
+                QString text = QString::fromStdString(query.text);
+                query.text.clear();
+                queryEngine->execute(query, ids);
+                for (int id : ids) {
+                    auto found = positionById.find(id);
+                    if (found == positionById.end() || listed[found->second]) continue;
+                    const Task& task = tasks[found->second];
+                    if (QString::fromStdString(task.title).contains(text, Qt::CaseInsensitive) ||
+                        QString::fromStdString(task.description).contains(text, Qt::CaseInsensitive)) {
+                        list(id);
+                    }
+                }
+            }
+        } else {
+            // Not a valid query: plain substring search
+            MOODOO_TRACE_SCOPE("ui", "substringSearch");
+            for (const auto& task : tasks) {
+                if (searchText.isEmpty() ||
+                    QString::fromStdString(task.title).contains(searchText, Qt::CaseInsensitive) ||
+                    QString::fromStdString(task.description).contains(searchText, Qt::CaseInsensitive)) {
+                    list(task.id);
+                }
+            }
+        }
+        
+        MOODOO_TRACE_SCOPE("ui", "populateTaskList");
         int foundCount = 0;
-        for (const auto& task : tasks) {
+        for (const Task* match : ordered) {
+            const Task& task = *match;
             // Apply priority filter
             if (priorityValue != -1 && static_cast<int>(task.priority) != priorityValue) {
                 continue;
             }
             
-            // Apply search filter
             QString taskTitle = QString::fromStdString(task.title);
             QString taskDesc = QString::fromStdString(task.description);
-            if (!searchText.isEmpty() && 
-                !taskTitle.contains(searchText, Qt::CaseInsensitive) && 
-                !taskDesc.contains(searchText, Qt::CaseInsensitive)) {
-                continue;
-            }
             
             QString taskText;
             
@@ -355,7 +356,9 @@ void TaskListPage::onSearchTextChanged(const QString& searchText)
         
         // Show search and filter status
         QString statusText = "--- ";
-        if (!searchText.isEmpty()) {
+        if (!queryError.empty()) {
+            statusText += QString("Query: %1, matching plain text - ").arg(QString::fromStdString(queryError));
+        } else if (!searchText.isEmpty()) {
             statusText += QString("Search: '%1' - ").arg(searchText);
         }
         if (priorityValue != -1) {
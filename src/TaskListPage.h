@@ -10,13 +10,14 @@
 #include <QComboBox>
 #include <QLineEdit>
 #include "Storage.h"
+#include "QueryEngine.h"
 
 class TaskListPage : public QWidget
 {
     Q_OBJECT
 
 public:
-    TaskListPage(Storage* storage, QWidget *parent = nullptr);
+    TaskListPage(Storage* storage, const QueryEngine* queryEngine, QWidget *parent = nullptr);
     ~TaskListPage();
 
 public slots:
@@ -38,6 +39,8 @@ private:
     
     // Storage connection
     Storage *storage;
+    const QueryEngine *queryEngine;     // Kept current by MainWindow; may be null
+    std::vector<Task> tasks;            // Reloaded in place, so its records are reused
 };
 
 #endif // TASKLISTPAGE_H 
\ No newline at end of file
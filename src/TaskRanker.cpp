@@ -0,0 +1,177 @@
+#include "TaskRanker.h"
+#include <algorithm>
+
+namespace {
+
+const double kSecondsPerDay = 24 * 60 * 60;
+
+} // namespace
+
+TaskRanker::TaskRanker()
+    : currentMood(MoodLevel::NEUTRAL), currentMoodTime(0),
+      offsets{0, 0, 0, 0}, totals{0, 0, 0, 0}, completions{0, 0, 0, 0} {
+    refreshOffsets();
+}
+
+int TaskRanker::bucketOf(TaskDifficulty difficulty) {
+    int bucket = static_cast<int>(difficulty);
+    return (bucket >= 1 && bucket <= 3) ? bucket : static_cast<int>(TaskDifficulty::MEDIUM);
+}
+
+int TaskRanker::levelOf(Priority priority) {
+    // Clamped the way CompletionModel scores it, so shape weights line up
+    return std::min(3, std::max(1, static_cast<int>(priority)));
+}
+
+double TaskRanker::staticKeyFor(const Task& task) {
+    // Older tasks get a larger key; adding kAgeWeight * now / day gives the real age bonus
+    return static_cast<double>(task.priority) - kAgeWeight * (static_cast<double>(task.created) / kSecondsPerDay);
+}
+
+double TaskRanker::moodFit(MoodLevel mood, TaskDifficulty difficulty) {
+    // Rows: low, neutral, high mood. Columns: easy, medium, hard.
+    static const double fit[3][3] = {
+        {3.0, 1.0, 0.0},
+        {2.0, 3.0, 1.0},
+        {1.0, 2.0, 3.0}
+    };
+    int row = 1;
+    if (mood == MoodLevel::VERY_LOW || mood == MoodLevel::LOW) row = 0;
+    else if (mood == MoodLevel::GOOD || mood == MoodLevel::EXCELLENT) row = 2;
+    return fit[row][bucketOf(difficulty) - 1];
+}
+
+double TaskRanker::completionLikelihood(TaskDifficulty difficulty) const {
+    int bucket = bucketOf(difficulty);
+    // Laplace smoothing keeps a new user's first task from deciding everything
+    return (completions[bucket] + 1.0) / (totals[bucket] + 2.0);
+}
+
+void TaskRanker::refreshOffsets() {
+    for (int bucket = 1; bucket <= 3; ++bucket) {
+        TaskDifficulty difficulty = static_cast<TaskDifficulty>(bucket);
+        offsets[bucket] = moodFit(currentMood, difficulty) + kLikelihoodWeight * completionLikelihood(difficulty);
+    }
+}
+
+void TaskRanker::setMood(MoodLevel mood) {
+    currentMood = mood;
+    refreshOffsets();
+}
+
+void TaskRanker::moodSaved(const MoodEntry& entry) {
+    // Entries logged for an earlier time don't change how the user feels now
+    if (entry.timestamp >= currentMoodTime) {
+        currentMoodTime = entry.timestamp;
+        setMood(entry.mood);
+    }
+}
+
+void TaskRanker::forget(int taskId) {
+    auto rankedIt = pending.find(taskId);
+    if (rankedIt != pending.end()) {
+        const RankedTask& ranked = rankedIt->second;
+        buckets[bucketOf(ranked.difficulty)][levelOf(ranked.priority)].erase(Slot{ranked.staticKey, ranked.id, nullptr});
+        pending.erase(rankedIt);
+    }
+
+    auto historyIt = history.find(taskId);
+    if (historyIt != history.end()) {
+        totals[historyIt->second.first]--;
+        completions[historyIt->second.first] -= historyIt->second.second ? 1 : 0;
+        history.erase(historyIt);
+    }
+}
+
+void TaskRanker::upsert(const Task& task) {
+    forget(task.id);
+
+    int bucket = bucketOf(task.difficulty);
+    totals[bucket]++;
+    completions[bucket] += task.completed ? 1 : 0;
+    history[task.id] = std::make_pair(static_cast<uint8_t>(bucket), task.completed);
+
+    if (!task.completed) {
+        RankedTask& ranked = pending[task.id];
+        ranked.id = task.id;
+        ranked.title = task.title;
+        ranked.priority = task.priority;
+        ranked.difficulty = static_cast<TaskDifficulty>(bucket);
+        ranked.created = task.created;
+        ranked.staticKey = staticKeyFor(task);
+        buckets[bucket][levelOf(task.priority)].insert(Slot{ranked.staticKey, ranked.id, &ranked});
+    }
+    refreshOffsets();
+}
+
+void TaskRanker::remove(int taskId) {
+    forget(taskId);
+    refreshOffsets();
+}
+
+void TaskRanker::reset(const std::vector<Task>& tasks) {
+    pending.clear();
+    history.clear();
+    for (int bucket = 0; bucket < 4; ++bucket) {
+        for (auto& shape : buckets[bucket]) {
+            shape.clear();
+        }
+        totals[bucket] = 0;
+        completions[bucket] = 0;
+    }
+    pending.reserve(tasks.size());
+    history.reserve(tasks.size());
+    for (const auto& task : tasks) {
+        upsert(task);
+    }
+}
+
+double TaskRanker::score(const RankedTask& task, time_t now) const {
+    return offsets[bucketOf(task.difficulty)] + task.staticKey +
+           kAgeWeight * (static_cast<double>(now) / kSecondsPerDay);
+}
+
+std::vector<const RankedTask*> TaskRanker::top(size_t k) const {
+    static const double even[3][3] = {};
+    return top(k, even);
+}
+
+std::vector<const RankedTask*> TaskRanker::top(size_t k, const double (&shapeWeight)[3][3]) const {
+    std::vector<const RankedTask*> best;
+    best.reserve(std::min(k, pending.size()));
+
+    // Nine-way merge of the shape heads; within a shape the set order is the ranking
+    std::set<Slot>::const_iterator heads[4][4];
+    for (int bucket = 1; bucket <= 3; ++bucket) {
+        for (int level = 1; level <= 3; ++level) {
+            heads[bucket][level] = buckets[bucket][level].begin();
+        }
+    }
+    while (best.size() < k) {
+        int pickBucket = 0;
+        int pickLevel = 0;
+        double pickWeight = 0.0;
+        double pickScore = 0.0;
+        for (int bucket = 1; bucket <= 3; ++bucket) {
+            for (int level = 1; level <= 3; ++level) {
+                auto head = heads[bucket][level];
+                if (head == buckets[bucket][level].end()) continue;
+                double weight = shapeWeight[level - 1][bucket - 1];
+                double candidate = offsets[bucket] + head->key;
+                if (pickBucket == 0 || weight > pickWeight ||
+                    (weight == pickWeight &&
+                     (candidate > pickScore ||
+                      (candidate == pickScore && head->id < heads[pickBucket][pickLevel]->id)))) {
+                    pickBucket = bucket;
+                    pickLevel = level;
+                    pickWeight = weight;
+                    pickScore = candidate;
+                }
+            }
+        }
+        if (pickBucket == 0) break;
+        best.push_back(heads[pickBucket][pickLevel]->task);
+        ++heads[pickBucket][pickLevel];
+    }
+    return best;
+}
@@ -0,0 +1,92 @@
+#ifndef TASK_RANKER_H
+#define TASK_RANKER_H
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Storage.h"
+
+// A pending task as the ranker sees it
+struct RankedTask {
+    int id;
+    std::string title;
+    Priority priority;
+    TaskDifficulty difficulty;
+    time_t created;
+    double staticKey;   // Priority plus age; see TaskRanker
+};
+
+// Keeps pending tasks ordered by how well they suit the current mood.
+//
+// score = moodFit(mood, difficulty) + likelihood(difficulty)   (per-difficulty offset)
+//       + priority + kAgeWeight * age in days                  (per-task static key)
+//
+// Every task ages at the same rate, so the age term never reorders tasks and
+// each task's key is fixed when it is inserted. Tasks live in one ordered set
+// per shape (difficulty x priority); a mood change only moves the three
+// offsets, and top() merges the nine set heads. Updates are O(log n) and
+// reads copy nothing.
+class TaskRanker : public StorageListener {
+public:
+    static constexpr double kAgeWeight = 0.1;           // Ten days waiting is worth one priority level
+    static constexpr double kLikelihoodWeight = 2.0;
+
+    TaskRanker();
+
+    void setMood(MoodLevel mood);
+    MoodLevel mood() const { return currentMood; }
+
+    // Tasks
+    void reset(const std::vector<Task>& tasks);
+    void upsert(const Task& task);
+    void remove(int taskId);
+
+    // Best k pending tasks, best first. Pointers stay valid until the next change.
+    std::vector<const RankedTask*> top(size_t k) const;
+    // Same, but ordered by a weight per shape ([priority - 1][difficulty - 1])
+    // first and the ranking second. Costs O(k) whatever the number pending.
+    std::vector<const RankedTask*> top(size_t k, const double (&shapeWeight)[3][3]) const;
+    double score(const RankedTask& task, time_t now) const;
+    size_t pendingCount() const { return pending.size(); }
+    // Smoothed share of tasks at this difficulty that got completed
+    double completionLikelihood(TaskDifficulty difficulty) const;
+
+    // StorageListener
+    void tasksLoaded(const std::vector<Task>& tasks) override { reset(tasks); }
+    void taskSaved(const Task& task) override { upsert(task); }
+    void taskRemoved(int taskId) override { remove(taskId); }
+    void moodSaved(const MoodEntry& entry) override;
+
+private:
+    struct Slot {
+        double key;
+        int id;
+        const RankedTask* task;
+        bool operator<(const Slot& other) const {
+            // Best first; ties go to the older id
+            return key != other.key ? key > other.key : id < other.id;
+        }
+    };
+
+    MoodLevel currentMood;
+    time_t currentMoodTime;
+    std::unordered_map<int, RankedTask> pending;
+    std::set<Slot> buckets[4][4];       // Indexed by TaskDifficulty, then Priority (1..3)
+    double offsets[4];
+
+    // Completion history per difficulty, and what each known task contributed
+    uint32_t totals[4];
+    uint32_t completions[4];
+    std::unordered_map<int, std::pair<uint8_t, bool>> history;   // id -> (difficulty, completed)
+
+    static int bucketOf(TaskDifficulty difficulty);
+    static int levelOf(Priority priority);
+    static double staticKeyFor(const Task& task);
+    static double moodFit(MoodLevel mood, TaskDifficulty difficulty);
+    void forget(int taskId);
+    void refreshOffsets();
+};
+
+#endif // TASK_RANKER_H
@@ -0,0 +1,61 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t threadCount) : stopping(false) {
+    threadCount = std::max<size_t>(1, threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    available.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool(std::thread::hardware_concurrency());
+    return pool;
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            available.wait(lock, [this]() { return stopping || !jobs.empty(); });
+            if (stopping && jobs.empty()) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop();
+        }
+        job();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& job) {
+    if (count == 1) {
+        job(0); // Not worth a hop through the queue
+        return;
+    }
+
+    std::vector<std::future<void>> pending;
+    pending.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        pending.push_back(submit([&job, i]() { job(i); }));
+    }
+    // get() rethrows the first failure, but only after every job has finished
+    for (auto& result : pending) {
+        result.wait();
+    }
+    for (auto& result : pending) {
+        result.get();
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed-size worker pool shared by the loaders
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> jobs;
+    std::mutex mutex;
+    std::condition_variable available;
+    bool stopping;
+
+    void workerLoop();
+
+public:
+    explicit ThreadPool(size_t threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Process-wide pool sized to the hardware
+    static ThreadPool& shared();
+
+    size_t size() const { return workers.size(); }
+
+    template <typename F>
+    std::future<decltype(std::declval<F>()())> submit(F&& job) {
+        using Result = decltype(std::declval<F>()());
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(job));
+        std::future<Result> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.emplace([task]() { (*task)(); });
+        }
+        available.notify_one();
+        return result;
+    }
+
+    // Runs job(0) .. job(count - 1) on the pool and waits for all of them.
+    // Must not be called from inside a pool job.
+    void parallelFor(size_t count, const std::function<void(size_t)>& job);
+};
+
+#endif // THREAD_POOL_H
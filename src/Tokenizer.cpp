@@ -0,0 +1,292 @@
+#include "Tokenizer.h"
+#include "MoodKernels.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define MOODOO_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const char32_t kInvalid = 0xFFFFFFFF;
+
+// Decodes one code point at text[i]. Malformed or truncated sequences decode
+// as kInvalid with length 1 so the caller always makes progress.
+char32_t decode(const unsigned char* text, size_t size, size_t i, size_t& length) {
+    unsigned char lead = text[i];
+    length = 1;
+    if (lead < 0x80) return lead;
+
+    size_t expected;
+    char32_t codePoint;
+    if ((lead & 0xE0) == 0xC0) { expected = 2; codePoint = lead & 0x1F; }
+    else if ((lead & 0xF0) == 0xE0) { expected = 3; codePoint = lead & 0x0F; }
+    else if ((lead & 0xF8) == 0xF0) { expected = 4; codePoint = lead & 0x07; }
+    else return kInvalid;
+
+    if (i + expected > size) return kInvalid;
+    for (size_t k = 1; k < expected; ++k) {
+        if ((text[i + k] & 0xC0) != 0x80) return kInvalid;
+        codePoint = (codePoint << 6) | (text[i + k] & 0x3F);
+    }
+    // Overlong forms and surrogates are malformed
+    static const char32_t minimum[5] = {0, 0, 0x80, 0x800, 0x10000};
+    if (codePoint < minimum[expected] || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+        return kInvalid;
+    }
+    length = expected;
+    return codePoint;
+}
+
+struct AsciiClasses {
+    bool word[128];
+
+    AsciiClasses() : word() {
+        for (int c = 'a'; c <= 'z'; ++c) word[c] = true;
+        for (int c = 'A'; c <= 'Z'; ++c) word[c] = true;
+        for (int c = '0'; c <= '9'; ++c) word[c] = true;
+    }
+};
+
+const AsciiClasses kAscii;
+
+bool isAsciiWord(unsigned char c) {
+    return kAscii.word[c & 0x7F];
+}
+
+// Letters, digits and combining marks in the scripts our users write. A range
+// check rather than the full Unicode tables; punctuation and symbols inside
+// these blocks are rare in journal text.
+bool isWordCodePoint(char32_t c) {
+    if (c < 0x80) return isAsciiWord(static_cast<unsigned char>(c));
+    if (c == 0xAA || c == 0xB5 || c == 0xBA) return true;
+    if (c >= 0xC0 && c <= 0x2AF) return c != 0xD7 && c != 0xF7;      // Latin-1 letters, Latin Extended, IPA
+    if (c >= 0x300 && c <= 0x36F) return true;                        // Combining accents
+    if (c >= 0x370 && c <= 0x3FF) return c != 0x37E && c != 0x387;    // Greek
+    if (c >= 0x400 && c <= 0x58F) return true;                        // Cyrillic, Armenian
+    if (c >= 0x5D0 && c <= 0x5EA) return true;                        // Hebrew letters
+    if (c >= 0x620 && c <= 0x669) return true;                        // Arabic letters and digits
+    if (c >= 0x900 && c <= 0xE7F) return true;                        // Indic scripts, Thai
+    if (c >= 0x1E00 && c <= 0x1FFF) return true;                      // Latin Extended Additional, Greek Extended
+    if (c >= 0x3040 && c <= 0x30FF) return c != 0x30FB;              // Kana
+    if (c >= 0x3400 && c <= 0x9FFF) return true;                      // CJK ideographs
+    if (c >= 0xAC00 && c <= 0xD7AF) return true;                      // Hangul
+    return false;
+}
+
+bool isApostrophe(char32_t c) {
+    return c == '\'' || c == 0x2019;
+}
+
+// Folds ASCII bytes until the first non-ASCII byte; returns how many it folded
+size_t foldAsciiScalar(const unsigned char* in, unsigned char* out, size_t count) {
+    size_t i = 0;
+    for (; i < count && in[i] < 0x80; ++i) {
+        unsigned char c = in[i];
+        out[i] = (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c + 32) : c;
+    }
+    return i;
+}
+
+#ifdef MOODOO_X86_KERNELS
+
+__attribute__((target("sse4.2")))
+size_t foldAsciiSse(const unsigned char* in, unsigned char* out, size_t count) {
+    const __m128i beforeA = _mm_set1_epi8('A' - 1);
+    const __m128i afterZ = _mm_set1_epi8('Z' + 1);
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        if (_mm_movemask_epi8(block) != 0) break;   // Multibyte sequence in this block
+        // Signed compares are fine: every byte here is below 0x80
+        __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(block, beforeA), _mm_cmpgt_epi8(afterZ, block));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                         _mm_or_si128(block, _mm_and_si128(upper, caseBit)));
+    }
+    return i + foldAsciiScalar(in + i, out + i, count - i);
+}
+
+__attribute__((target("avx2")))
+size_t foldAsciiAvx2(const unsigned char* in, unsigned char* out, size_t count) {
+    const __m256i beforeA = _mm256_set1_epi8('A' - 1);
+    const __m256i afterZ = _mm256_set1_epi8('Z' + 1);
+    const __m256i caseBit = _mm256_set1_epi8(0x20);
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        if (_mm256_movemask_epi8(block) != 0) break;
+        __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(block, beforeA), _mm256_cmpgt_epi8(afterZ, block));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            _mm256_or_si256(block, _mm256_and_si256(upper, caseBit)));
+    }
+    return i + foldAsciiScalar(in + i, out + i, count - i);
+}
+
+#endif
+
+size_t foldAscii(const unsigned char* in, unsigned char* out, size_t count) {
+#ifdef MOODOO_X86_KERNELS
+    switch (MoodKernels::activeIsa()) {
+        case MoodKernels::Isa::AVX2: return foldAsciiAvx2(in, out, count);
+        case MoodKernels::Isa::SSE42: return foldAsciiSse(in, out, count);
+        case MoodKernels::Isa::SCALAR: break;
+    }
+#endif
+    return foldAsciiScalar(in, out, count);
+}
+
+} // namespace
+
+char32_t Tokenizer::foldCodePoint(char32_t c) {
+    if (c < 0x80) return (c >= 'A' && c <= 'Z') ? c + 32 : c;
+    // Latin-1: À..Þ except ×
+    if (c >= 0xC0 && c <= 0xDE) return c == 0xD7 ? c : c + 0x20;
+    // Latin Extended-A alternates upper/lower; İ (U+0130) would change length
+    if ((c >= 0x100 && c <= 0x12F) || (c >= 0x132 && c <= 0x137) || (c >= 0x14A && c <= 0x177)) {
+        return c | 1;
+    }
+    if ((c >= 0x139 && c <= 0x148) || (c >= 0x179 && c <= 0x17E)) {
+        return (c & 1) ? c + 1 : c;
+    }
+    if (c == 0x178) return 0xFF;
+    // Greek
+    if (c >= 0x391 && c <= 0x3AB) return c == 0x3A2 ? c : c + 0x20;
+    if (c == 0x386) return 0x3AC;
+    if (c >= 0x388 && c <= 0x38A) return c + 0x25;
+    if (c == 0x38C) return 0x3CC;
+    if (c == 0x38E || c == 0x38F) return c + 0x3F;
+    // Cyrillic
+    if (c >= 0x400 && c <= 0x40F) return c + 0x50;
+    if (c >= 0x410 && c <= 0x42F) return c + 0x20;
+    return c;
+}
+
+void Tokenizer::foldCase(std::string_view text, std::string& out) {
+    out.resize(text.size());
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(text.data());
+    unsigned char* folded = reinterpret_cast<unsigned char*>(&out[0]);
+    const size_t size = text.size();
+
+    size_t i = 0;
+    while (i < size) {
+        i += foldAscii(in + i, folded + i, size - i);
+        if (i >= size) break;
+
+        size_t length;
+        char32_t codePoint = decode(in, size, i, length);
+        char32_t lower = codePoint == kInvalid ? kInvalid : foldCodePoint(codePoint);
+        if (length == 2 && lower != codePoint && lower >= 0x80 && lower < 0x800) {
+            folded[i] = static_cast<unsigned char>(0xC0 | (lower >> 6));
+            folded[i + 1] = static_cast<unsigned char>(0x80 | (lower & 0x3F));
+        } else {
+            for (size_t k = 0; k < length; ++k) folded[i + k] = in[i + k];
+        }
+        i += length;
+    }
+}
+
+size_t Tokenizer::codePoints(std::string_view text, char32_t* out, size_t capacity) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(text.data());
+    size_t count = 0;
+    size_t length;
+    for (size_t i = 0; i < text.size() && count < capacity; i += length) {
+        char32_t codePoint = decode(bytes, text.size(), i, length);
+        out[count++] = codePoint == kInvalid ? 0xFFFD : codePoint;
+    }
+    return count;
+}
+
+std::string Tokenizer::foldCase(std::string_view text) {
+    std::string folded;
+    foldCase(text, folded);
+    return folded;
+}
+
+bool Tokenizer::nextToken(std::string_view text, size_t from, Span& token) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(text.data());
+    const size_t size = text.size();
+    size_t length;
+
+    size_t i = from;
+    while (i < size) {
+        if (bytes[i] < 0x80) {
+            if (isAsciiWord(bytes[i])) break;
+            ++i;
+            continue;
+        }
+        if (isWordCodePoint(decode(bytes, size, i, length))) break;
+        i += length;
+    }
+    if (i >= size) return false;
+
+    size_t start = i;
+    while (i < size) {
+        if (bytes[i] < 0x80 && isAsciiWord(bytes[i])) {
+            ++i;
+            continue;
+        }
+        char32_t codePoint = decode(bytes, size, i, length);
+        if (isWordCodePoint(codePoint)) {
+            i += length;
+            continue;
+        }
+        // Keep "don't" together: an apostrophe followed by another word character
+        if (isApostrophe(codePoint) && i + length < size) {
+            size_t nextLength;
+            if (isWordCodePoint(decode(bytes, size, i + length, nextLength))) {
+                i += length + nextLength;
+                continue;
+            }
+        }
+        break;
+    }
+    token.offset = static_cast<uint32_t>(start);
+    token.length = static_cast<uint32_t>(i - start);
+    return true;
+}
+
+void Tokenizer::tokenize(std::string_view text, std::vector<Span>& out) {
+    forEachToken(text, [&out](const Span& token) { out.push_back(token); });
+}
+
+bool Tokenizer::matchesPhrase(std::string_view folded, const std::vector<Span>& tokens, size_t at,
+                              std::string_view phrase, bool prefixLast) {
+    size_t word = 0;
+    while (!phrase.empty()) {
+        size_t space = phrase.find(' ');
+        std::string_view part = phrase.substr(0, space);
+        phrase = space == std::string_view::npos ? std::string_view() : phrase.substr(space + 1);
+        if (part.empty()) continue;
+        if (at + word >= tokens.size()) return false;
+
+        std::string_view token = tokens[at + word].in(folded);
+        bool last = phrase.empty();
+        if (last && prefixLast) {
+            if (token.compare(0, part.size(), part) != 0) return false;
+        } else if (token != part) {
+            return false;
+        }
+        ++word;
+    }
+    return word > 0;
+}
+
+bool Tokenizer::containsPhrase(std::string_view folded, const std::vector<Span>& tokens,
+                               std::string_view phrase, bool prefixLast) {
+    if (phrase.empty()) return false;
+    // Most keywords are a single word: compare spans directly
+    if (phrase.find(' ') == std::string_view::npos) {
+        for (const Span& span : tokens) {
+            if (span.length < phrase.size() || (!prefixLast && span.length != phrase.size())) continue;
+            if (folded[span.offset] == phrase[0] && folded.compare(span.offset, phrase.size(), phrase) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+    for (size_t at = 0; at < tokens.size(); ++at) {
+        if (matchesPhrase(folded, tokens, at, phrase, prefixLast)) return true;
+    }
+    return false;
+}
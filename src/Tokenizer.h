@@ -0,0 +1,62 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// UTF-8 aware case folding and word splitting shared by MoodAnalyzer and the
+// search index.
+//
+// Folding maps upper to lower case for ASCII (SIMD, 16 or 32 bytes at a time),
+// Latin-1, Latin Extended-A, Greek and Cyrillic. Every mapping it applies keeps
+// the byte length, so a span found in folded text also indexes the original.
+// Anything else, including emoji and malformed bytes, is copied unchanged.
+//
+// A token is a run of letters and digits in any script; an apostrophe between
+// letters stays inside the token ("don't"). Punctuation, symbols, emoji and
+// whitespace separate tokens.
+class Tokenizer {
+public:
+    struct Span {
+        uint32_t offset;
+        uint32_t length;
+
+        std::string_view in(std::string_view text) const { return text.substr(offset, length); }
+    };
+
+    // Resizes out to text.size() and writes the folded text into it
+    static void foldCase(std::string_view text, std::string& out);
+    static std::string foldCase(std::string_view text);
+    static char32_t foldCodePoint(char32_t codePoint);
+    // Decodes up to capacity code points; malformed bytes decode as U+FFFD
+    static size_t codePoints(std::string_view text, char32_t* out, size_t capacity);
+
+    // Finds the first token at or after `from`; false when there is none
+    static bool nextToken(std::string_view text, size_t from, Span& token);
+    // Appends the spans of every token in text
+    static void tokenize(std::string_view text, std::vector<Span>& out);
+
+    template <typename Visitor>
+    static void forEachToken(std::string_view text, Visitor visit) {
+        Span token;
+        size_t position = 0;
+        while (nextToken(text, position, token)) {
+            visit(token);
+            position = token.offset + token.length;
+        }
+    }
+
+    // True when the tokens starting at tokens[at] spell the folded, space
+    // separated phrase. The last word may be a prefix of its token when
+    // prefixLast is set ("stress" matches "stressed").
+    static bool matchesPhrase(std::string_view folded, const std::vector<Span>& tokens, size_t at,
+                              std::string_view phrase, bool prefixLast);
+    // matchesPhrase at any position
+    static bool containsPhrase(std::string_view folded, const std::vector<Span>& tokens,
+                               std::string_view phrase, bool prefixLast);
+};
+
+#endif // TOKENIZER_H
@@ -0,0 +1,154 @@
+#include "Trace.h"
+
+#ifdef MOODOO_ENABLE_TRACING
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct Event {
+    const char* category;
+    const char* name;
+    int64_t start;
+    int64_t duration;
+};
+
+// The owning thread locks its own buffer for each span, which is uncontended
+// except while a dump copies it out
+struct ThreadBuffer {
+    std::mutex mutex;
+    std::vector<Event> events;
+    size_t next = 0;
+    bool wrapped = false;
+    int tid;
+    bool inUse = true;
+
+    explicit ThreadBuffer(int tid) : events(Trace::kEventsPerThread), tid(tid) {}
+};
+
+// Buffers of finished threads are handed to new ones (keeping their tid), so
+// thread churn can't grow memory without bound
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+    static Registry& instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    ThreadBuffer* acquire() {
+        std::lock_guard<std::mutex> guard(mutex);
+        for (auto& buffer : buffers) {
+            if (!buffer->inUse) {
+                buffer->inUse = true;
+                return buffer.get();
+            }
+        }
+        buffers.push_back(std::make_unique<ThreadBuffer>(static_cast<int>(buffers.size()) + 1));
+        return buffers.back().get();
+    }
+
+    void release(ThreadBuffer* buffer) {
+        std::lock_guard<std::mutex> guard(mutex);
+        buffer->inUse = false;
+    }
+};
+
+struct ThreadSlot {
+    ThreadBuffer* buffer;
+    ThreadSlot() : buffer(Registry::instance().acquire()) {}
+    ~ThreadSlot() { Registry::instance().release(buffer); }
+};
+
+ThreadBuffer& localBuffer() {
+    thread_local ThreadSlot slot;
+    return *slot.buffer;
+}
+
+void writeString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') out << '\\';
+        out << *c;
+    }
+    out << '"';
+}
+
+} // namespace
+
+int64_t Trace::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - Registry::instance().epoch).count();
+}
+
+void Trace::record(const char* category, const char* name, int64_t start, int64_t end) {
+    ThreadBuffer& buffer = localBuffer();
+    std::lock_guard<std::mutex> guard(buffer.mutex);
+    buffer.events[buffer.next] = Event{category, name, start, end - start};
+    if (++buffer.next == buffer.events.size()) {
+        buffer.next = 0;
+        buffer.wrapped = true;
+    }
+}
+
+void Trace::writeChromeJson(std::ostream& out) {
+    Registry& registry = Registry::instance();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    char number[64];
+    for (const auto& buffer : registry.buffers) {
+        std::vector<Event> events;
+        {
+            std::lock_guard<std::mutex> bufferGuard(buffer->mutex);
+            // Oldest first: the ring's tail, then its head
+            if (buffer->wrapped) {
+                events.assign(buffer->events.begin() + static_cast<long>(buffer->next), buffer->events.end());
+            }
+            events.insert(events.end(), buffer->events.begin(), buffer->events.begin() + static_cast<long>(buffer->next));
+        }
+
+        // Numbered in order of each thread's first span
+        out << (first ? "\n" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->tid
+            << ",\"args\":{\"name\":\"thread " << buffer->tid << "\"}}";
+        first = false;
+
+        for (const auto& event : events) {
+            // Chrome trace times are microseconds
+            std::snprintf(number, sizeof(number), "%.3f,\"dur\":%.3f", event.start / 1000.0, event.duration / 1000.0);
+            out << ",\n{\"ph\":\"X\",\"cat\":";
+            writeString(out, event.category);
+            out << ",\"name\":";
+            writeString(out, event.name);
+            out << ",\"pid\":1,\"tid\":" << buffer->tid << ",\"ts\":" << number << "}";
+        }
+    }
+    out << "\n]}\n";
+}
+
+bool Trace::save(const std::string& path) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not write trace to " << path << std::endl;
+        return false;
+    }
+    writeChromeJson(file);
+    return static_cast<bool>(file);
+}
+
+bool Trace::dumpIfConfigured() {
+    const char* path = std::getenv("MOODOO_TRACE_FILE");
+    if (!path || !*path) return true;
+    return save(path);
+}
+
+#endif // MOODOO_ENABLE_TRACING
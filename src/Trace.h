@@ -0,0 +1,72 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+#include <string>
+
+// Scoped trace spans for finding where an interaction's time goes, saved as
+// Chrome trace JSON (load it in Perfetto or chrome://tracing).
+//
+//   MOODOO_TRACE_SCOPE("ui", "refreshTaskList");
+//
+// Spans are recorded only in builds with MOODOO_ENABLE_TRACING (qmake
+// CONFIG+=tracing); otherwise the macro expands to nothing and Trace's
+// functions are empty inlines. Each thread writes into its own ring buffer
+// of the last kEventsPerThread spans, so a long session keeps only its tail.
+// Every Storage and MoodAnalyzer call timed by MetricsTimer is traced too.
+
+#ifdef MOODOO_ENABLE_TRACING
+
+#include <iostream>
+
+class Trace {
+public:
+    static constexpr bool kEnabled = true;
+    static const size_t kEventsPerThread = 16384;
+
+    // Nanoseconds since the first traced span
+    static int64_t now();
+    // category and name must be string literals (or otherwise outlive the trace)
+    static void record(const char* category, const char* name, int64_t start, int64_t end);
+
+    static void writeChromeJson(std::ostream& out);
+    static bool save(const std::string& path);
+    // Saves to $MOODOO_TRACE_FILE, if set
+    static bool dumpIfConfigured();
+};
+
+class TraceSpan {
+private:
+    const char* category;
+    const char* name;
+    int64_t start;
+
+public:
+    TraceSpan(const char* category, const char* name) : category(category), name(name), start(Trace::now()) {}
+    ~TraceSpan() { Trace::record(category, name, start, Trace::now()); }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
+
+#define MOODOO_TRACE_CONCAT_(a, b) a##b
+#define MOODOO_TRACE_CONCAT(a, b) MOODOO_TRACE_CONCAT_(a, b)
+#define MOODOO_TRACE_SCOPE(category, name) TraceSpan MOODOO_TRACE_CONCAT(traceSpan, __LINE__)(category, name)
+
+#else
+
+class Trace {
+public:
+    static constexpr bool kEnabled = false;
+
+    static int64_t now() { return 0; }
+    static void record(const char*, const char*, int64_t, int64_t) {}
+    static bool save(const std::string&) { return false; }
+    static bool dumpIfConfigured() { return true; }
+};
+
+#define MOODOO_TRACE_SCOPE(category, name) ((void)0)
+
+#endif // MOODOO_ENABLE_TRACING
+
+#endif // TRACE_H
@@ -0,0 +1,451 @@
+#include "WarmSnapshot.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <unordered_map>
+#include "Metrics.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct WarmSnapshot::Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t kind;
+    SourceStamp source;
+    SourceStamp index;
+    uint64_t recordCount;
+    uint64_t keywordCount;
+    uint64_t keywordRefCount;
+    uint64_t stringBytes;
+    int64_t nextId;
+    uint64_t checksum;          // Of everything after the header
+};
+
+namespace {
+
+const char kMagic[8] = {'M', 'O', 'O', 'D', 'S', 'N', 'A', 'P'};
+// Bump when any of the structs below change
+const uint32_t kVersion = 2;
+
+struct TaskRecord {
+    int64_t created;
+    int64_t completedTime;
+    uint64_t titleOffset;
+    uint64_t descriptionOffset;
+    uint32_t titleBytes;
+    uint32_t descriptionBytes;
+    int32_t id;
+    uint8_t priority;
+    uint8_t difficulty;
+    uint8_t completed;
+    uint8_t unused;
+};
+
+struct MoodRecord {
+    int64_t timestamp;
+    double sentimentScore;
+    uint64_t contentOffset;
+    uint64_t firstKeyword;      // Into the keyword refs
+    uint32_t contentBytes;
+    uint32_t keywordCount;
+    int32_t id;
+    uint8_t mood;
+    uint8_t unused[3];
+};
+
+struct StringRef {
+    uint64_t offset;
+    uint64_t bytes;
+};
+
+static_assert(sizeof(TaskRecord) == 48 && sizeof(MoodRecord) == 48 && sizeof(StringRef) == 16,
+              "Snapshot records must keep their on-disk size");
+
+uint64_t align8(uint64_t value) {
+    return (value + 7) & ~uint64_t(7);
+}
+
+// Byte offsets of each section, given the header's counts
+struct Layout {
+    uint64_t records;
+    uint64_t keywords;
+    uint64_t keywordRefs;
+    uint64_t strings;
+    uint64_t end;
+
+    Layout(uint64_t recordSize, uint64_t recordCount, uint64_t keywordCount, uint64_t keywordRefCount,
+           uint64_t stringBytes, uint64_t headerSize) {
+        records = headerSize;
+        keywords = records + recordSize * recordCount;
+        keywordRefs = keywords + sizeof(StringRef) * keywordCount;
+        strings = keywordRefs + align8(sizeof(uint32_t) * keywordRefCount);
+        end = strings + stringBytes;
+    }
+};
+
+uint64_t appendString(std::string& strings, const std::string& text) {
+    uint64_t offset = strings.size();
+    strings += text;
+    return offset;
+}
+
+template <typename T>
+void appendRaw(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+bool writeFile(const std::string& path, const std::string& contents) {
+    std::string tempFile = path + ".tmp";
+    std::ofstream file(tempFile, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open warm-start snapshot for writing" << std::endl;
+        return false;
+    }
+    file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    file.close();
+    if (!file) {
+        return false;
+    }
+    Metrics::add(Metrics::BYTES_WRITTEN, contents.size());
+    Metrics::add(Metrics::SNAPSHOTS_WRITTEN, 1);
+
+    std::error_code ec;
+    std::filesystem::rename(tempFile, path, ec);
+    return !ec;
+}
+
+} // namespace
+
+WarmSnapshot::WarmSnapshot() : base(nullptr), size(0) {
+}
+
+WarmSnapshot::~WarmSnapshot() {
+    close();
+}
+
+void WarmSnapshot::close() {
+#ifndef _WIN32
+    if (base && buffer.empty()) {
+        munmap(const_cast<char*>(base), size);
+    }
+#endif
+    base = nullptr;
+    size = 0;
+    buffer.clear();
+}
+
+const WarmSnapshot::Header& WarmSnapshot::header() const {
+    return *reinterpret_cast<const Header*>(base);
+}
+
+bool WarmSnapshot::open(const std::string& path, Kind kind) {
+    close();
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    base = static_cast<const char*>(mapped);
+    size = static_cast<size_t>(info.st_size);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    buffer.assign((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (buffer.size() < sizeof(Header)) {
+        buffer.clear();
+        return false;
+    }
+    base = buffer.data();
+    size = buffer.size();
+#endif
+
+    const Header& head = header();
+    bool valid = std::memcmp(head.magic, kMagic, sizeof(kMagic)) == 0 && head.version == kVersion &&
+                 head.kind == static_cast<uint32_t>(kind);
+    // Counts are bounded by the file size before they're multiplied
+    if (valid) {
+        valid = head.recordCount <= size && head.keywordCount <= size && head.keywordRefCount <= size &&
+                head.stringBytes <= size;
+    }
+    if (valid) {
+        uint64_t recordSize = kind == Kind::TASKS ? sizeof(TaskRecord) : sizeof(MoodRecord);
+        Layout layout(recordSize, head.recordCount, head.keywordCount, head.keywordRefCount, head.stringBytes,
+                      sizeof(Header));
+        valid = layout.end == size && hash(base + sizeof(Header), size - sizeof(Header)) == head.checksum;
+    }
+    if (!valid) {
+        std::cerr << "Warning: Ignoring damaged or outdated snapshot " << path << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+const SourceStamp& WarmSnapshot::source() const {
+    return header().source;
+}
+
+const SourceStamp& WarmSnapshot::index() const {
+    return header().index;
+}
+
+int WarmSnapshot::nextId() const {
+    return static_cast<int>(header().nextId);
+}
+
+size_t WarmSnapshot::recordCount() const {
+    return base ? static_cast<size_t>(header().recordCount) : 0;
+}
+
+size_t WarmSnapshot::readTasks(std::vector<Task>& tasks, size_t used) const {
+    const Header& head = header();
+    Layout layout(sizeof(TaskRecord), head.recordCount, head.keywordCount, head.keywordRefCount,
+                  head.stringBytes, sizeof(Header));
+    const TaskRecord* records = reinterpret_cast<const TaskRecord*>(base + layout.records);
+    const char* strings = base + layout.strings;
+
+    Storage::reserveFor(tasks, used + head.recordCount);
+    for (uint64_t i = 0; i < head.recordCount; ++i) {
+        const TaskRecord& record = records[i];
+        Task& task = Storage::recycle(tasks, used++);
+        task.id = record.id;
+        task.title.assign(strings + record.titleOffset, record.titleBytes);
+        task.description.assign(strings + record.descriptionOffset, record.descriptionBytes);
+        task.priority = static_cast<Priority>(record.priority);
+        task.difficulty = static_cast<TaskDifficulty>(record.difficulty);
+        task.completed = record.completed != 0;
+        task.created = static_cast<time_t>(record.created);
+        task.completed_time = static_cast<time_t>(record.completedTime);
+    }
+    Metrics::add(Metrics::SNAPSHOT_RECORDS, head.recordCount);
+    return used;
+}
+
+size_t WarmSnapshot::readMoods(time_t since, std::vector<MoodEntry>& entries, size_t used) const {
+    const Header& head = header();
+    Layout layout(sizeof(MoodRecord), head.recordCount, head.keywordCount, head.keywordRefCount,
+                  head.stringBytes, sizeof(Header));
+    const MoodRecord* records = reinterpret_cast<const MoodRecord*>(base + layout.records);
+    const StringRef* keywordTable = reinterpret_cast<const StringRef*>(base + layout.keywords);
+    const uint32_t* keywordRefs = reinterpret_cast<const uint32_t*>(base + layout.keywordRefs);
+    const char* strings = base + layout.strings;
+
+    std::vector<Keyword> keywords;
+    keywords.reserve(head.keywordCount);
+    for (uint64_t k = 0; k < head.keywordCount; ++k) {
+        keywords.emplace_back(std::string_view(strings + keywordTable[k].offset, keywordTable[k].bytes));
+    }
+
+    // Records are in load order, which isn't strictly time order, so every one is checked
+    size_t before = used;
+    Storage::reserveFor(entries, used + head.recordCount);
+    for (uint64_t i = 0; i < head.recordCount; ++i) {
+        const MoodRecord& record = records[i];
+        if (static_cast<time_t>(record.timestamp) < since) continue;
+        MoodEntry& entry = Storage::recycle(entries, used++);
+        entry.id = record.id;
+        entry.content.assign(strings + record.contentOffset, record.contentBytes);
+        entry.mood = static_cast<MoodLevel>(record.mood);
+        entry.timestamp = static_cast<time_t>(record.timestamp);
+        entry.sentimentScore = record.sentimentScore;
+        entry.keywords.clear();
+        entry.extractedKeywords.clear();
+        entry.keywords.reserve(record.keywordCount);
+        for (uint32_t k = 0; k < record.keywordCount; ++k) {
+            entry.keywords.push_back(keywords[keywordRefs[record.firstKeyword + k]]);
+        }
+    }
+    Metrics::add(Metrics::SNAPSHOT_RECORDS, used - before);
+    return used;
+}
+
+bool WarmSnapshot::writeTasks(const std::string& path, const SourceStamp& source, int nextId,
+                              const std::vector<Task>& tasks) {
+    std::string strings;
+    std::string records;
+    records.reserve(tasks.size() * sizeof(TaskRecord));
+    for (const auto& task : tasks) {
+        TaskRecord record{};
+        record.created = static_cast<int64_t>(task.created);
+        record.completedTime = static_cast<int64_t>(task.completed_time);
+        record.titleOffset = appendString(strings, task.title);
+        record.titleBytes = static_cast<uint32_t>(task.title.size());
+        record.descriptionOffset = appendString(strings, task.description);
+        record.descriptionBytes = static_cast<uint32_t>(task.description.size());
+        record.id = task.id;
+        record.priority = static_cast<uint8_t>(task.priority);
+        record.difficulty = static_cast<uint8_t>(task.difficulty);
+        record.completed = task.completed ? 1 : 0;
+        appendRaw(records, record);
+    }
+
+    Header head{};
+    std::memcpy(head.magic, kMagic, sizeof(kMagic));
+    head.version = kVersion;
+    head.kind = static_cast<uint32_t>(Kind::TASKS);
+    head.source = source;
+    head.recordCount = tasks.size();
+    head.stringBytes = strings.size();
+    head.nextId = nextId;
+
+    std::string out;
+    out.reserve(sizeof(Header) + records.size() + strings.size());
+    appendRaw(out, head);
+    out += records;
+    out += strings;
+    Header* written = reinterpret_cast<Header*>(&out[0]);
+    written->checksum = hash(out.data() + sizeof(Header), out.size() - sizeof(Header));
+    return writeFile(path, out);
+}
+
+bool WarmSnapshot::writeMoods(const std::string& path, const SourceStamp& source, const SourceStamp& index,
+                              int nextId, const std::vector<MoodEntry>& entries) {
+    std::string strings;
+    std::string records;
+    std::string keywordTable;
+    std::vector<uint32_t> keywordRefs;
+    std::unordered_map<uint32_t, uint32_t> keywordSlots;   // Symbol id to table index
+    records.reserve(entries.size() * sizeof(MoodRecord));
+
+    for (const auto& entry : entries) {
+        MoodRecord record{};
+        record.timestamp = static_cast<int64_t>(entry.timestamp);
+        record.sentimentScore = entry.sentimentScore;
+        record.contentOffset = appendString(strings, entry.content);
+        record.contentBytes = static_cast<uint32_t>(entry.content.size());
+        record.firstKeyword = keywordRefs.size();
+        record.keywordCount = static_cast<uint32_t>(entry.keywords.size());
+        record.id = entry.id;
+        record.mood = static_cast<uint8_t>(entry.mood);
+        for (const auto& keyword : entry.keywords) {
+            auto slot = keywordSlots.emplace(keyword.id(), static_cast<uint32_t>(keywordSlots.size()));
+            if (slot.second) {
+                StringRef ref{appendString(strings, keyword.str()), keyword.str().size()};
+                appendRaw(keywordTable, ref);
+            }
+            keywordRefs.push_back(slot.first->second);
+        }
+        appendRaw(records, record);
+    }
+
+    Header head{};
+    std::memcpy(head.magic, kMagic, sizeof(kMagic));
+    head.version = kVersion;
+    head.kind = static_cast<uint32_t>(Kind::MOODS);
+    head.source = source;
+    head.index = index;
+    head.recordCount = entries.size();
+    head.keywordCount = keywordSlots.size();
+    head.keywordRefCount = keywordRefs.size();
+    head.stringBytes = strings.size();
+    head.nextId = nextId;
+
+    size_t refBytes = keywordRefs.size() * sizeof(uint32_t);
+    std::string out;
+    out.reserve(sizeof(Header) + records.size() + keywordTable.size() + align8(refBytes) + strings.size());
+    appendRaw(out, head);
+    out += records;
+    out += keywordTable;
+    out.append(reinterpret_cast<const char*>(keywordRefs.data()), refBytes);
+    out.append(align8(refBytes) - refBytes, '\0');
+    out += strings;
+    Header* written = reinterpret_cast<Header*>(&out[0]);
+    written->checksum = hash(out.data() + sizeof(Header), out.size() - sizeof(Header));
+    return writeFile(path, out);
+}
+
+bool WarmSnapshot::stamp(const std::string& text, uint64_t offset, int64_t mtime, int64_t checkedAt,
+                         const SourceStamp& covered, SourceStamp& stamp) {
+    if (!text.empty() && text.back() != '\n') {
+        return false;
+    }
+    uint64_t bytes = offset + text.size();
+    size_t window = static_cast<size_t>(std::min<uint64_t>(kStampWindow, bytes));
+    if (text.size() < window) {
+        return false;
+    }
+    // The range hash picks up at the last whole word covered already
+    uint64_t from = offset == 0 ? 0 : covered.bytes & ~uint64_t(7);
+    uint64_t to = bytes & ~uint64_t(7);
+    if (from < offset || to < from) {
+        return false;
+    }
+    stamp.rangeHash = hashWords(offset == 0 ? kRangeSeed : covered.rangeHash, text.data() + (from - offset),
+                                static_cast<size_t>(to - from));
+    stamp.bytes = bytes;
+    stamp.mtime = mtime;
+    stamp.checkedAt = checkedAt;
+    stamp.headHash = offset == 0 ? hash(text.data(), window) : covered.headHash;
+    stamp.tailHash = hash(text.data() + text.size() - window, window);
+    return true;
+}
+
+int64_t WarmSnapshot::modifiedTime(const std::string& path) {
+    std::error_code ec;
+    auto time = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return -1;
+    }
+    return static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+int64_t WarmSnapshot::changedTime(const std::string& path) {
+#ifndef _WIN32
+    struct stat info;
+    if (::stat(path.c_str(), &info) != 0) {
+        return -1;
+    }
+    return static_cast<int64_t>(info.st_ctime);
+#else
+    // st_ctime is the creation time here, so every check falls back to hashing
+    std::error_code ec;
+    return std::filesystem::exists(path, ec) ? INT64_MAX : -1;
+#endif
+}
+
+uint64_t WarmSnapshot::hashWords(uint64_t state, const char* data, size_t size) {
+    // Same mixing as hash(), minus the length seed and the byte tail, so a range can be hashed in pieces
+    for (size_t i = 0; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        state = (state ^ word) * 0x9E3779B97F4A7C15ULL;
+        state ^= state >> 29;
+    }
+    return state;
+}
+
+uint64_t WarmSnapshot::hash(const char* data, size_t size) {
+    // A word at a time (multiply, then fold the high bits down) to keep up with the disk
+    uint64_t hash = 14695981039346656037ULL ^ size;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+        hash ^= hash >> 29;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ULL;
+    }
+    return hash;
+}
@@ -0,0 +1,97 @@
+#ifndef WARM_SNAPSHOT_H
+#define WARM_SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Storage.h"
+
+// Which bytes of a text file a snapshot was built from. The head and tail
+// hashes cover the first and last kStampWindow bytes, so text appended since
+// is detected without reading what the snapshot already holds. rangeHash
+// covers everything, for when size and mtime can't be trusted (see
+// Storage::readSince()).
+struct SourceStamp {
+    uint64_t bytes;
+    int64_t mtime;          // Filesystem clock ticks; only compared for equality
+    int64_t checkedAt;      // Wall-clock seconds just before the bytes were read
+    uint64_t headHash;
+    uint64_t tailHash;
+    uint64_t rangeHash;     // hashWords() over the first bytes & ~7 bytes; the tail window has the rest
+
+    SourceStamp() : bytes(0), mtime(0), checkedAt(0), headHash(0), tailHash(0), rangeHash(0) {}
+
+    // Same bytes; when they were checked doesn't count
+    friend bool operator==(const SourceStamp& a, const SourceStamp& b) {
+        return a.bytes == b.bytes && a.mtime == b.mtime && a.headHash == b.headHash && a.tailHash == b.tailHash &&
+               a.rangeHash == b.rangeHash;
+    }
+    friend bool operator!=(const SourceStamp& a, const SourceStamp& b) { return !(a == b); }
+};
+
+// Binary image of the records from a full load, written next to the text
+// files so the next start maps it instead of parsing. Layout, host byte order:
+//   Header | Record[recordCount] | StringRef[keywordCount] | uint32_t[keywordRefCount] | string bytes
+// Records hold offsets into the string bytes; mood keywords are indexes into
+// the keyword table, so each distinct keyword is interned once per load.
+// A checksum over everything after the header is verified on open.
+class WarmSnapshot {
+public:
+    enum class Kind : uint32_t {
+        TASKS = 1,
+        MOODS = 2
+    };
+
+    static constexpr size_t kStampWindow = 4096;
+
+    WarmSnapshot();
+    ~WarmSnapshot();
+    WarmSnapshot(const WarmSnapshot&) = delete;
+    WarmSnapshot& operator=(const WarmSnapshot&) = delete;
+
+    // False when the file is missing, of another kind or version, or damaged
+    bool open(const std::string& path, Kind kind);
+
+    const SourceStamp& source() const;      // The text file the records came from
+    const SourceStamp& index() const;       // Moods: the cold segment index at the time
+    int nextId() const;
+    size_t recordCount() const;
+
+    // Both fill from slot used on and return the new used count (see Storage::recycle)
+    size_t readTasks(std::vector<Task>& tasks, size_t used) const;
+    size_t readMoods(time_t since, std::vector<MoodEntry>& entries, size_t used) const;
+
+    // Written aside and renamed into place
+    static bool writeTasks(const std::string& path, const SourceStamp& source, int nextId,
+                           const std::vector<Task>& tasks);
+    static bool writeMoods(const std::string& path, const SourceStamp& source, const SourceStamp& index,
+                           int nextId, const std::vector<MoodEntry>& entries);
+
+    // Stamp for a file whose bytes from offset on are in text. When offset > 0
+    // the file is covered plus appended text: covered's head hash is reused and
+    // its range hash carried on, so text must start at or before covered.bytes & ~7.
+    // False when text ends mid-line, i.e. a write may be in progress.
+    static bool stamp(const std::string& text, uint64_t offset, int64_t mtime, int64_t checkedAt,
+                      const SourceStamp& covered, SourceStamp& stamp);
+    static int64_t modifiedTime(const std::string& path);      // -1 when missing
+    // Wall-clock seconds of the last change to the file's contents or metadata
+    // (ctime), which tools that restore mtimes can't set back. -1 when missing;
+    // where there's no ctime, never older than anything.
+    static int64_t changedTime(const std::string& path);
+    static uint64_t hash(const char* data, size_t size);
+    // Streaming form of hash() for the range hash: size must be a multiple of 8
+    static uint64_t hashWords(uint64_t state, const char* data, size_t size);
+    static const uint64_t kRangeSeed = 14695981039346656037ULL;
+
+private:
+    struct Header;
+
+    const char* base;
+    size_t size;
+    std::string buffer;         // Holds the file where it can't be mapped
+
+    void close();
+    const Header& header() const;
+};
+
+#endif // WARM_SNAPSHOT_H
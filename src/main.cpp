@@ -2,8 +2,21 @@
 #include <vector>
 #include <string>
 #include <limits>
+#include <unordered_map>
 #include "Storage.h"
 #include "MoodAnalyzer.h"
+#include "MoodKernels.h"
+#include "CorrelationEngine.h"
+#include "MoodTrendDetector.h"
+#include "TaskRanker.h"
+#include "CompletionModel.h"
+#include "LocalTime.h"
+#include "SearchIndex.h"
+#include "QueryEngine.h"
+#include "Commands.h"
+#include "DaemonClient.h"
+#include "Metrics.h"
+#include "Trace.h"
 using namespace std;
 
 void clearScreen() {
@@ -23,8 +36,9 @@ void showMenu() {
     cout << "9. Daily summary" << endl;
     cout << "10. Weekly patterns" << endl;
     cout << "11. Gentle reminders" << endl;
-    cout << "12. Exit" << endl;
-    cout << "Choose an option (1-12): ";
+    cout << "12. Search tasks and journal" << endl;
+    cout << "13. Exit" << endl;
+    cout << "Choose an option (1-13): ";
 }
 
 void addTask(Storage& storage) {
@@ -62,14 +76,14 @@ void addTask(Storage& storage) {
         default: task.difficulty = TaskDifficulty::MEDIUM; break;
     }
     
-    if (storage.saveTask(task)) {
+    if (storage.saveTask(std::move(task))) {
         cout << "✓ Task saved successfully!" << endl;
     } else {
         cout << "✗ Error saving task" << endl;
     }
 }
 
-void addMoodEntry(Storage& storage) {
+void addMoodEntry(Storage& storage, MoodTrendDetector& trends, const CompletionModel& model, const TaskRanker& ranker) {
     clearScreen();
     cout << "=== Add Mood Entry ===" << endl;
     
@@ -112,15 +126,25 @@ void addMoodEntry(Storage& storage) {
         // Show detailed insights
         cout << analyzer.generateDetailedInsights(entry);
         
-        // Show task suggestion based on mood
-        vector<Task> tasks;
-        storage.loadTasks(tasks);
-        int completedTasks = 0;
-        for (const auto& task : tasks) {
-            if (task.completed) completedTasks++;
+        // Flag sustained drops or shifts as soon as this entry completes them
+        unsigned alerts = trends.update(entry);
+        if (alerts != MoodTrendDetector::NONE) {
+            cout << "\n" << MoodTrendDetector::describe(alerts);
         }
         
-        cout << analyzer.generateTaskSuggestion(entry.mood, completedTasks, tasks.size()) << endl;
+        // Show task suggestion: learned once there is enough history, rule-based until then
+        if (model.trained()) {
+            cout << analyzer.generateTaskSuggestion(model, ranker) << endl;
+        } else {
+            int completedTasks = 0;
+            size_t totalTasks = 0;
+            storage.forEachTask([&](const Task& task) {
+                if (task.completed) completedTasks++;
+                totalTasks++;
+            });
+            
+            cout << analyzer.generateTaskSuggestion(entry.mood, completedTasks, totalTasks) << endl;
+        }
         
     } else {
         cout << "✗ Error saving mood entry" << endl;
@@ -191,48 +215,46 @@ void markTaskComplete(Storage& storage) {
     }
 }
 
-void viewTasks(Storage& storage) {
+void viewTasks(Storage& storage, const TaskRanker& ranker) {
     clearScreen();
     cout << "=== Your Tasks ===" << endl;
     
-    vector<Task> tasks;
-    if (storage.loadTasks(tasks)) {
-        if (tasks.empty()) {
+    // Printed as they're read; no copy of the task file is built
+    int completedCount = 0;
+    size_t taskCount = 0;
+    auto printTask = [&](const Task& task) {
+        string priorityStr;
+        switch(task.priority) {
+            case Priority::LOW: priorityStr = "Low"; break;
+            case Priority::HIGH: priorityStr = "High"; break;
+            default: priorityStr = "Medium"; break;
+        }
+        
+        string difficultyStr;
+        switch(task.difficulty) {
+            case TaskDifficulty::EASY: difficultyStr = "Easy"; break;
+            case TaskDifficulty::HARD: difficultyStr = "Hard"; break;
+            default: difficultyStr = "Medium"; break;
+        }
+        
+        string status = task.completed ? "✓ Done" : "○ Pending";
+        if (task.completed) completedCount++;
+        taskCount++;
+        
+        cout << "[" << task.id << "] " << status << " | " << priorityStr << " | " << difficultyStr << " | " << task.title << endl;
+        cout << "    " << task.description << endl << endl;
+    };
+    
+    if (storage.forEachTask(printTask)) {
+        if (taskCount == 0) {
             cout << "No tasks found. Add some tasks to get started!" << endl;
         } else {
-            int completedCount = 0;
-            for (const auto& task : tasks) {
-                string priorityStr;
-                switch(task.priority) {
-                    case Priority::LOW: priorityStr = "Low"; break;
-                    case Priority::HIGH: priorityStr = "High"; break;
-                    default: priorityStr = "Medium"; break;
-                }
-                
-                string difficultyStr;
-                switch(task.difficulty) {
-                    case TaskDifficulty::EASY: difficultyStr = "Easy"; break;
-                    case TaskDifficulty::HARD: difficultyStr = "Hard"; break;
-                    default: difficultyStr = "Medium"; break;
-                }
-                
-                string status = task.completed ? "✓ Done" : "○ Pending";
-                if (task.completed) completedCount++;
-                
-                cout << "[" << task.id << "] " << status << " | " << priorityStr << " | " << difficultyStr << " | " << task.title << endl;
-                cout << "    " << task.description << endl << endl;
-            }
-            
             // Show completion summary
-            cout << "--- Progress: " << completedCount << "/" << tasks.size() << " tasks completed ---" << endl;
+            cout << "--- Progress: " << completedCount << "/" << taskCount << " tasks completed ---" << endl;
             
-            // Show mood-based recommendations if we have recent mood data
-            vector<MoodEntry> recentMoods;
-            if (storage.loadMoodEntries(recentMoods) && !recentMoods.empty()) {
-                MoodAnalyzer analyzer;
-                MoodEntry latestMood = recentMoods.back(); // Get most recent mood
-                cout << analyzer.generateMoodBasedTaskRecommendations(latestMood.mood, tasks) << endl;
-            }
+            // Show mood-based recommendations from the maintained ranking
+            MoodAnalyzer analyzer;
+            cout << analyzer.generateMoodBasedTaskRecommendations(ranker) << endl;
         }
     } else {
         cout << "Error loading tasks" << endl;
@@ -387,25 +409,8 @@ void deleteTask(Storage& storage) {
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
     
     if (confirm == 'y' || confirm == 'Y') {
-        // Remove the task from the vector
-        tasks.erase(tasks.begin() + taskChoice - 1);
-        
-        // Rewrite the entire file without the deleted task
-        ofstream file(storage.getTasksFile(), ios::trunc);
-        if (file.is_open()) {
-            for (const auto& task : tasks) {
-                file << task.id << "|"
-                     << task.title << "|"
-                     << task.description << "|"
-                     << (task.priority == Priority::LOW ? "1" : 
-                         task.priority == Priority::HIGH ? "3" : "2") << "|"
-                     << (task.difficulty == TaskDifficulty::EASY ? "1" : 
-                         task.difficulty == TaskDifficulty::HARD ? "3" : "2") << "|"
-                     << (task.completed ? "1" : "0") << "|"
-                     << task.created << "|"
-                     << task.completed_time << endl;
-            }
-            file.close();
+        // Through Storage, so the ranker and indexes hear about it too
+        if (storage.deleteTask(selectedTask.id)) {
             cout << "✓ Task deleted successfully!" << endl;
         } else {
             cout << "✗ Error deleting task" << endl;
@@ -419,24 +424,26 @@ void viewMoodHistory(Storage& storage) {
     clearScreen();
     cout << "=== Mood History ===" << endl;
     
-    vector<MoodEntry> entries;
-    if (storage.loadMoodEntries(entries)) {
-        if (entries.empty()) {
+    // Streamed a segment at a time, so long histories don't have to fit in memory at once
+    size_t entryCount = 0;
+    auto printEntry = [&](const MoodEntry& entry) {
+        string moodStr;
+        switch(entry.mood) {
+            case MoodLevel::VERY_LOW: moodStr = "😞 Very Low"; break;
+            case MoodLevel::LOW: moodStr = "😔 Low"; break;
+            case MoodLevel::NEUTRAL: moodStr = "😐 Neutral"; break;
+            case MoodLevel::GOOD: moodStr = "😊 Good"; break;
+            case MoodLevel::EXCELLENT: moodStr = "😄 Excellent"; break;
+        }
+        
+        cout << "[" << entry.id << "] " << moodStr << endl;
+        cout << "    " << entry.content << endl << endl;
+        entryCount++;
+    };
+    
+    if (storage.scanMoods(numeric_limits<time_t>::min(), numeric_limits<time_t>::max(), printEntry)) {
+        if (entryCount == 0) {
             cout << "No mood entries found. Add some entries to track your feelings!" << endl;
-        } else {
-            for (const auto& entry : entries) {
-                string moodStr;
-                switch(entry.mood) {
-                    case MoodLevel::VERY_LOW: moodStr = "😞 Very Low"; break;
-                    case MoodLevel::LOW: moodStr = "😔 Low"; break;
-                    case MoodLevel::NEUTRAL: moodStr = "😐 Neutral"; break;
-                    case MoodLevel::GOOD: moodStr = "😊 Good"; break;
-                    case MoodLevel::EXCELLENT: moodStr = "😄 Excellent"; break;
-                }
-                
-                cout << "[" << entry.id << "] " << moodStr << endl;
-                cout << "    " << entry.content << endl << endl;
-            }
         }
     } else {
         cout << "Error loading mood entries" << endl;
@@ -455,19 +462,15 @@ void getMoodInsights(Storage& storage) {
             MoodAnalyzer analyzer;
             cout << analyzer.analyzeMoodTrend(entries) << endl;
             
-            // Show some basic statistics
-            int totalEntries = entries.size();
-            int lowMoodCount = 0, highMoodCount = 0, neutralCount = 0;
-            
-            for (const auto& entry : entries) {
-                if (entry.mood == MoodLevel::VERY_LOW || entry.mood == MoodLevel::LOW) {
-                    lowMoodCount++;
-                } else if (entry.mood == MoodLevel::GOOD || entry.mood == MoodLevel::EXCELLENT) {
-                    highMoodCount++;
-                } else {
-                    neutralCount++;
-                }
-            }
+            // Show some basic statistics (histogram of the mood column, not the entries)
+            const MoodColumns& columns = storage.moodColumns();
+            MoodKernels::Histogram levels = MoodKernels::histogram(columns.mood.data(), columns.size());
+            int totalEntries = columns.size();
+            int lowMoodCount = levels.counts[static_cast<int>(MoodLevel::VERY_LOW)] +
+                               levels.counts[static_cast<int>(MoodLevel::LOW)];
+            int highMoodCount = levels.counts[static_cast<int>(MoodLevel::GOOD)] +
+                                levels.counts[static_cast<int>(MoodLevel::EXCELLENT)];
+            int neutralCount = totalEntries - lowMoodCount - highMoodCount;
             
             cout << "\n📈 Your Mood Summary:" << endl;
             cout << "Total entries: " << totalEntries << endl;
@@ -486,33 +489,29 @@ void showDailySummary(Storage& storage) {
     
     // Get today's date
     time_t now = time(nullptr);
-    tm* today = localtime(&now);
-    int todayDay = today->tm_mday;
-    int todayMonth = today->tm_mon + 1;
-    int todayYear = today->tm_year + 1900;
+    tm today = LocalTime::local(now);
+    int todayDay = today.tm_mday;
+    int todayMonth = today.tm_mon + 1;
+    int todayYear = today.tm_year + 1900;
     
     cout << "📅 Date: " << todayMonth << "/" << todayDay << "/" << todayYear << endl << endl;
     
-    // Load today's mood entries
-    vector<MoodEntry> allMoods;
-    vector<MoodEntry> todayMoods;
-    if (storage.loadMoodEntries(allMoods)) {
-        for (const auto& mood : allMoods) {
-            tm* moodTime = localtime(&mood.timestamp);
-            if (moodTime->tm_mday == todayDay && 
-                moodTime->tm_mon == today->tm_mon && 
-                moodTime->tm_year == today->tm_year) {
-                todayMoods.push_back(mood);
-            }
+    // Only the first and last of today's moods are shown, so none are kept
+    size_t todayMoods = 0;
+    MoodLevel firstLevel = MoodLevel::NEUTRAL, lastLevel = MoodLevel::NEUTRAL;
+    storage.scanMoods(now - 24 * 60 * 60, numeric_limits<time_t>::max(), [&](const MoodEntry& mood) {
+        if (LocalTime::sameDay(LocalTime::local(mood.timestamp), today)) {
+            if (todayMoods++ == 0) firstLevel = mood.mood;
+            lastLevel = mood.mood;
         }
-    }
+    });
     
     // Show mood summary
-    if (todayMoods.empty()) {
+    if (todayMoods == 0) {
         cout << "💭 No mood entries today. How are you feeling?" << endl;
-    } else if (todayMoods.size() == 1) {
+    } else if (todayMoods == 1) {
         string moodStr;
-        switch(todayMoods[0].mood) {
+        switch(firstLevel) {
             case MoodLevel::VERY_LOW: moodStr = "😞 Very Low"; break;
             case MoodLevel::LOW: moodStr = "😔 Low"; break;
             case MoodLevel::NEUTRAL: moodStr = "😐 Neutral"; break;
@@ -523,14 +522,14 @@ void showDailySummary(Storage& storage) {
     } else {
         cout << "💭 Mood Trend: ";
         string firstMood, lastMood;
-        switch(todayMoods.front().mood) {
+        switch(firstLevel) {
             case MoodLevel::VERY_LOW: firstMood = "😞"; break;
             case MoodLevel::LOW: firstMood = "😔"; break;
             case MoodLevel::NEUTRAL: firstMood = "😐"; break;
             case MoodLevel::GOOD: firstMood = "😊"; break;
             case MoodLevel::EXCELLENT: firstMood = "😄"; break;
         }
-        switch(todayMoods.back().mood) {
+        switch(lastLevel) {
             case MoodLevel::VERY_LOW: lastMood = "😞"; break;
             case MoodLevel::LOW: lastMood = "😔"; break;
             case MoodLevel::NEUTRAL: lastMood = "😐"; break;
@@ -540,20 +539,14 @@ void showDailySummary(Storage& storage) {
         cout << firstMood << " → " << lastMood << endl;
     }
     
-    // Load today's tasks
-    vector<Task> allTasks;
+    // Count today's tasks
     int completedToday = 0, totalToday = 0;
-    if (storage.loadTasks(allTasks)) {
-        for (const auto& task : allTasks) {
-            tm* taskTime = localtime(&task.created);
-            if (taskTime->tm_mday == todayDay && 
-                taskTime->tm_mon == today->tm_mon && 
-                taskTime->tm_year == today->tm_year) {
-                totalToday++;
-                if (task.completed) completedToday++;
-            }
+    storage.forEachTask([&](const Task& task) {
+        if (LocalTime::sameDay(LocalTime::local(task.created), today)) {
+            totalToday++;
+            if (task.completed) completedToday++;
         }
-    }
+    });
     
     // Show task summary
     cout << "✅ Tasks: " << completedToday << "/" << totalToday << " completed";
@@ -579,57 +572,45 @@ void showDailySummary(Storage& storage) {
     cout << endl;
 }
 
-void showWeeklyPatterns(Storage& storage) {
+void showWeeklyPatterns(Storage& storage, CorrelationEngine& correlations) {
     clearScreen();
     cout << "=== Weekly Mood & Productivity Patterns ===" << endl;
     
-    vector<MoodEntry> moods;
-    vector<Task> tasks;
-    
-    if (storage.loadMoodEntries(moods) && storage.loadTasks(tasks)) {
-        MoodAnalyzer analyzer;
-        cout << analyzer.analyzeWeeklyPatterns(moods, tasks) << endl;
-    } else {
+    // The correlations below need full history anyway, so the week is read off the same columns
+    if (!storage.loadColumns()) {
         cout << "Error loading data for pattern analysis." << endl;
+        return;
     }
+    MoodAnalyzer analyzer;
+    cout << analyzer.analyzeWeeklyPatterns(storage.moodColumns(), storage.taskColumns()) << endl;
+    
+    // Longer-term links between mood and getting things done
+    correlations.sync(storage.moodColumns(), storage.taskColumns());
+    time_t now = time(nullptr);
+    cout << correlations.describe(now - 90 * 24 * 60 * 60, now + 1) << endl;
 }
 
-void showGentleReminders(Storage& storage) {
+void showGentleReminders(const TaskRanker& ranker, const CompletionModel& model) {
     clearScreen();
     cout << "=== Gentle Reminders 💙 ===" << endl;
     
-    vector<MoodEntry> moods;
-    vector<Task> tasks;
-    
-    if (!storage.loadMoodEntries(moods) || !storage.loadTasks(tasks)) {
-        cout << "Unable to load your data. Take a deep breath and try again." << endl;
-        return;
-    }
-    
-    // Get current mood (most recent)
-    MoodLevel currentMood = MoodLevel::NEUTRAL;
-    if (!moods.empty()) {
-        currentMood = moods.back().mood;
-    }
+    // The ranker already follows the latest mood and every pending task
+    MoodLevel currentMood = ranker.mood();
     
-    // Find pending tasks
-    vector<Task> pendingTasks;
-    for (const auto& task : tasks) {
-        if (!task.completed) {
-            pendingTasks.push_back(task);
-        }
-    }
-    
-    if (pendingTasks.empty()) {
+    if (ranker.pendingCount() == 0) {
         cout << "🎉 Amazing! You have no pending tasks!" << endl;
         cout << "Take a moment to celebrate your productivity." << endl;
         return;
     }
     
     // Show gentle, mood-aware reminders
-    cout << "You have " << pendingTasks.size() << " task(s) waiting for you." << endl;
+    cout << "You have " << ranker.pendingCount() << " task(s) waiting for you." << endl;
     cout << "Here are some gentle suggestions:\n" << endl;
     
+    // The learned model picks once it has seen enough completions; the ranking otherwise
+    vector<const RankedTask*> ranked = ranker.top(ranker.pendingCount());
+    const RankedTask* best = model.trained() ? model.likeliest(ranker, 1).front().first : ranked.front();
+    
     // Mood-based gentle approach
     switch (currentMood) {
         case MoodLevel::VERY_LOW:
@@ -637,58 +618,37 @@ void showGentleReminders(Storage& storage) {
             cout << "💙 I can see you're having a low-energy day." << endl;
             cout << "That's completely okay - we all have them!" << endl;
             cout << "Maybe just pick ONE tiny thing that feels manageable?\n" << endl;
-            
-            // Suggest easiest tasks first
-            for (const auto& task : pendingTasks) {
-                if (task.difficulty == TaskDifficulty::EASY) {
-                    cout << "💡 Gentle suggestion: '" << task.title << "'" << endl;
-                    cout << "   This is marked as easy - it might feel doable right now." << endl;
-                    break;
-                }
-            }
+            cout << "💡 Gentle suggestion: '" << best->title << "'" << endl;
+            cout << "   This one might feel doable right now." << endl;
             break;
             
         case MoodLevel::NEUTRAL:
             cout << "😐 You're in a balanced place today." << endl;
             cout << "This might be a good time to tackle something medium-sized.\n" << endl;
-            
-            // Suggest medium tasks
-            for (const auto& task : pendingTasks) {
-                if (task.difficulty == TaskDifficulty::MEDIUM) {
-                    cout << "💡 Suggestion: '" << task.title << "'" << endl;
-                    cout << "   This feels like the right energy level for you." << endl;
-                    break;
-                }
-            }
+            cout << "💡 Suggestion: '" << best->title << "'" << endl;
+            cout << "   This feels like the right energy level for you." << endl;
             break;
             
         case MoodLevel::GOOD:
         case MoodLevel::EXCELLENT:
             cout << "✨ You're feeling great today!" << endl;
             cout << "This is perfect energy for getting things done.\n" << endl;
-            
-            // Suggest harder tasks
-            for (const auto& task : pendingTasks) {
-                if (task.difficulty == TaskDifficulty::HARD) {
-                    cout << "💡 Great opportunity: '" << task.title << "'" << endl;
-                    cout << "   You have the energy for this challenging task!" << endl;
-                    break;
-                }
-            }
+            cout << "💡 Great opportunity: '" << best->title << "'" << endl;
+            cout << "   You have the energy for this one!" << endl;
             break;
     }
     
-    // Show all pending tasks gently
+    // Show all pending tasks gently, best fit first
     cout << "\n📋 Here are all your pending tasks:" << endl;
-    for (size_t i = 0; i < pendingTasks.size(); i++) {
+    for (size_t i = 0; i < ranked.size(); i++) {
         string difficultyStr;
-        switch(pendingTasks[i].difficulty) {
+        switch(ranked[i]->difficulty) {
             case TaskDifficulty::EASY: difficultyStr = "Easy"; break;
             case TaskDifficulty::HARD: difficultyStr = "Hard"; break;
             default: difficultyStr = "Medium"; break;
         }
         
-        cout << "   " << (i + 1) << ". " << pendingTasks[i].title << " (" << difficultyStr << ")" << endl;
+        cout << "   " << (i + 1) << ". " << ranked[i]->title << " (" << difficultyStr << ")" << endl;
     }
     
     // Gentle closing message
@@ -699,8 +659,155 @@ void showGentleReminders(Storage& storage) {
     cout << "   • Take breaks when you need them" << endl;
 }
 
-int main() {
+void runQuery(Storage& storage, const QueryEngine& queries) {
+    clearScreen();
+    cout << "=== Search ===" << endl;
+    cout << "Filters: priority:high difficulty:easy is:open created:>2026-09-01 completed:>=7d" << endl;
+    cout << "         mood:low..neutral sentiment:<0 date:today text:\"report\" (journal: mood, sentiment, date)" << endl;
+    cout << "Search (t)asks or (j)ournal? ";
+    string where;
+    getline(cin, where);
+    Query::Target target = (!where.empty() && (where[0] == 'j' || where[0] == 'J')) ? Query::Target::MOODS
+                                                                                     : Query::Target::TASKS;
+    cout << "Query: ";
+    string text;
+    getline(cin, text);
+    
+    Query query;
+    string error;
+    if (!Query::parse(text, target, query, error)) {
+        cout << "Invalid query: " << error << endl;
+        return;
+    }
+    
+    vector<int> ids;
+    vector<string> plan;
+    if (target == Query::Target::TASKS) {
+        vector<Task> tasks;
+        if (!storage.loadTasks(tasks) || !queries.execute(query, ids, &plan)) {
+            cout << "Error running query" << endl;
+            return;
+        }
+        unordered_map<int, const Task*> byId;
+        for (const auto& task : tasks) byId.emplace(task.id, &task);
+        for (int id : ids) {
+            auto found = byId.find(id);
+            if (found == byId.end()) continue;
+            const Task& task = *found->second;
+            string priorityStr;
+            switch(task.priority) {
+                case Priority::LOW: priorityStr = "Low"; break;
+                case Priority::HIGH: priorityStr = "High"; break;
+                default: priorityStr = "Medium"; break;
+            }
+            cout << "[" << task.id << "] " << (task.completed ? "✓ Done" : "○ Pending") << " | " << priorityStr
+                 << " | " << task.title << endl;
+        }
+    } else {
+        // The journal index is built from the first full load; later writes keep it current
+        vector<MoodEntry> entries;
+        if (!queries.covers(Query::Target::MOODS) && !storage.loadMoodEntries(entries)) {
+            cout << "Error loading mood entries" << endl;
+            return;
+        }
+        if (!queries.execute(query, ids, &plan)) {
+            cout << "Error running query" << endl;
+            return;
+        }
+        if (!ids.empty() && entries.empty()) {
+            // Only the cold segments reaching back to the oldest match are read
+            time_t since = std::numeric_limits<time_t>::max();
+            for (int id : ids) {
+                since = min(since, static_cast<time_t>(queries.valueOf(Query::Target::MOODS, id, Query::CREATED)));
+            }
+            if (!storage.loadRecentMoodEntries(since, entries)) {
+                cout << "Error loading mood entries" << endl;
+                return;
+            }
+        }
+        unordered_map<int, const MoodEntry*> byId;
+        for (const auto& entry : entries) byId.emplace(entry.id, &entry);
+        for (int id : ids) {
+            auto found = byId.find(id);
+            if (found == byId.end()) continue;
+            const MoodEntry& entry = *found->second;
+            char when[32];
+            std::tm local = LocalTime::local(entry.timestamp);
+            std::strftime(when, sizeof(when), "%Y-%m-%d %H:%M", &local);
+            cout << "[" << entry.id << "] " << when << " | mood " << static_cast<int>(entry.mood) << "/5 | "
+                 << entry.content << endl;
+        }
+    }
+    
+    cout << "\nFound " << ids.size() << (target == Query::Target::TASKS ? " tasks" : " entries") << endl;
+    cout << "Plan:" << endl;
+    for (const auto& step : plan) {
+        cout << "  " << step << endl;
+    }
+}
+
+// Scripted commands go to moodood when it is running, so the daemon stays the
+// only writer; otherwise they run here
+int runCommand(const vector<string>& args) {
+    std::ios::sync_with_stdio(false);
+    bool forwardable = args[0] != "help" && args[0] != "--help";
+    for (const auto& arg : args) {
+        if (arg.find_first_of("\r\n") != string::npos) forwardable = false;
+    }
+    DaemonClient client;
+    if (forwardable && client.connect(DaemonClient::defaultSocketPath())) {
+        vector<string> lines;
+        if (args[0] == "batch") {
+            string line;
+            while (getline(cin, line)) lines.push_back(line);
+        } else {
+            lines.push_back(DaemonClient::quote(args));
+        }
+        return client.forward(lines, cout);
+    }
+    
+    Storage storage;
+    Commands commands(storage);
+    int status = commands.run(args, cout);
+    Metrics::dumpIfConfigured();
+    Trace::dumpIfConfigured();
+    return status;
+}
+
+int main(int argc, char* argv[]) {
+    // With arguments: run one scripted command (or a batch) and exit, see Commands.h
+    if (argc > 1) {
+        return runCommand(vector<string>(argv + 1, argv + argc));
+    }
+    
+    // While moodood runs, Storage sends this menu's changes to it
     Storage storage;
+    CorrelationEngine correlations;
+    
+    // The ranker follows every task write and new mood from here on
+    TaskRanker ranker;
+    CompletionModel model;
+    SearchIndex searchIndex;
+    QueryEngine queries(&searchIndex);
+    storage.addListener(&ranker);
+    storage.addListener(&model);
+    storage.addListener(&searchIndex);
+    storage.addListener(&queries);
+    RecordSpan<Task> startupTasks;
+    storage.taskSpan(startupTasks);
+    
+    // The detector only needs recent history to settle; sealed segments stay on disk
+    MoodTrendDetector trends;
+    RecordSpan<MoodEntry> recentMoods;
+    if (storage.moodSpan(time(nullptr) - Storage::kHotJournalAge, recentMoods)) {
+        for (const auto& entry : recentMoods) {
+            trends.update(entry);
+            ranker.moodSaved(entry);
+            model.moodSaved(entry);
+        }
+    }
+    // Completions from before the hot journal have no mood context and are skipped
+    model.train(startupTasks, recentMoods);
     int choice;
     
     cout << "Welcome to MooDoo: Your Mood-Aware Planner!" << endl;
@@ -716,10 +823,10 @@ int main() {
                 addTask(storage);
                 break;
             case 2:
-                addMoodEntry(storage);
+                addMoodEntry(storage, trends, model, ranker);
                 break;
             case 3:
-                viewTasks(storage);
+                viewTasks(storage, ranker);
                 break;
             case 4:
                 markTaskComplete(storage);
@@ -740,12 +847,20 @@ int main() {
                 showDailySummary(storage);
                 break;
             case 10:
-                showWeeklyPatterns(storage);
+                showWeeklyPatterns(storage, correlations);
                 break;
             case 11:
-                showGentleReminders(storage);
+                showGentleReminders(ranker, model);
                 break;
             case 12:
+                runQuery(storage, queries);
+                break;
+            case 13:
+                // Move old journal history into compressed cold segments
+                storage.sealJournalSegments(time(nullptr) - Storage::kHotJournalAge);
+                storage.saveSnapshots();
+                Metrics::dumpIfConfigured();
+                Trace::dumpIfConfigured();
                 cout << "Thanks for using MooDoo! Take care of yourself! 💙" << endl;
                 return 0;
             default:
@@ -0,0 +1,44 @@
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include "Daemon.h"
+#include "DaemonClient.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include "Storage.h"
+
+// moodood [--socket PATH]: serves the data files under ./data, see Daemon.h
+int main(int argc, char* argv[]) {
+    std::string socketPath = DaemonClient::defaultSocketPath();
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else {
+            std::cerr << "Usage: moodood [--socket PATH]" << std::endl;
+            return 1;
+        }
+    }
+    
+    // Only one writer at a time; every other Storage sends its writes here
+    Storage storage;
+    if (!storage.lockWriter()) {
+        return 1;
+    }
+    int status;
+    {
+        Daemon daemon(storage, socketPath);
+        if (!daemon.start()) {
+            return 1;
+        }
+        std::cerr << "moodood listening on " << socketPath << std::endl;
+        status = daemon.run();
+        std::cerr << "moodood stopped after " << daemon.requestsServed() << " requests" << std::endl;
+    }
+    
+    // The socket is gone, so nothing else writes while old history is sealed
+    storage.sealJournalSegments(time(nullptr) - Storage::kHotJournalAge);
+    storage.saveSnapshots();
+    Metrics::dumpIfConfigured();
+    Trace::dumpIfConfigured();
+    return status;
+}